@@ -16,6 +16,7 @@
 
 extern "C" {
 #include "../src/vgmstream.h"
+#include "../src/plugins.h"
 }
 #include "plugin.h"
 #include "vfs.h"
@@ -88,21 +89,7 @@ const PluginPreferences VgmstreamPlugin::prefs = {
 
 // validate extension
 bool VgmstreamPlugin::is_our_file(const char *filename, VFSFile &file) {
-    const char * ext = strrchr(filename,'.');
-    if (ext==NULL)
-        ext = filename+strlen(filename); /* point to null, i.e. an empty string for the extension */
-    else
-        ext = ext+1; /* skip the dot */
-
-    size_t ext_list_len = 0;
-    const char ** ext_list = vgmstream_get_formats(&ext_list_len);
-
-    for (int i=0; i < ext_list_len; i++) {
-        if (!strcasecmp(ext, ext_list[i]))
-            return true;
-    }
-
-    return false;
+    return vgmstream_ctx_is_valid(filename, 0);
 }
 
 bool VgmstreamPlugin::init() {
@@ -16,6 +16,7 @@ typedef struct _VFSSTREAMFILE {
 } VFSSTREAMFILE;
 
 static STREAMFILE *open_vfs_by_VFSFILE(VFSFile *file, const char *path);
+static STREAMFILE *open_vfs_file(const char *path);
 
 static size_t read_vfs(VFSSTREAMFILE *streamfile, uint8_t *dest, off_t offset,
                        size_t length) {
@@ -53,13 +54,17 @@ static void get_name_vfs(VFSSTREAMFILE *streamfile, char *buffer,
   buffer[length - 1] = '\0';
 }
 
+static const char *get_name_ref_vfs(VFSSTREAMFILE *streamfile) {
+  return streamfile->name;
+}
+
 static STREAMFILE *open_vfs_impl(VFSSTREAMFILE *streamfile,
                                  const char *const filename,
                                  size_t buffersize) {
   if (!filename)
     return NULL;
 
-  return open_vfs(filename);
+  return open_vfs_file(filename); // read-ahead wrapper reopens and wraps it
 }
 
 STREAMFILE *open_vfs_by_VFSFILE(VFSFile *file, const char *path) {
@@ -74,6 +79,7 @@ STREAMFILE *open_vfs_by_VFSFILE(VFSFile *file, const char *path) {
   streamfile->sf.get_size = get_size_vfs;
   streamfile->sf.get_offset = get_offset_vfs;
   streamfile->sf.get_name = get_name_vfs;
+  streamfile->sf.get_name_ref = get_name_ref_vfs;
   streamfile->sf.open = open_vfs_impl;
   streamfile->sf.close = close_vfs;
 
@@ -95,7 +101,7 @@ STREAMFILE *open_vfs_by_VFSFILE(VFSFile *file, const char *path) {
   return &streamfile->sf;
 }
 
-STREAMFILE *open_vfs(const char *path) {
+static STREAMFILE *open_vfs_file(const char *path) {
   VFSFile *vfsFile = new VFSFile(path, "rb");
   if (!vfsFile || !*vfsFile) {
     delete vfsFile;
@@ -104,3 +110,18 @@ STREAMFILE *open_vfs(const char *path) {
 
   return open_vfs_by_VFSFILE(vfsFile, path);
 }
+
+STREAMFILE *open_vfs(const char *path) {
+  STREAMFILE *streamfile = open_vfs_file(path);
+  if (!streamfile)
+    return NULL;
+
+  // VFS reads may be slow (network, etc), so prefetch during playback
+  STREAMFILE *new_streamfile = open_readahead_streamfile(streamfile, 0);
+  if (!new_streamfile) {
+    close_streamfile(streamfile);
+    return NULL;
+  }
+
+  return new_streamfile;
+}
@@ -33,6 +33,7 @@
 #else
 # include <signal.h>
 # include <unistd.h>
+# include <pthread.h>
 #endif
 
 #include "../src/vgmstream.h"
@@ -56,6 +57,11 @@
 #define SIGHUP  0
 #endif
 
+/* Decode audio ahead of output in another thread (pthreads only, plain output otherwise) */
+#ifndef WIN32
+#define USE_DECODE_AHEAD
+#endif
+
 /* If two interrupts (i.e. Ctrl-C) are received
  * within a span of this many seconds, then exit
  */
@@ -67,6 +73,7 @@
 
 #undef  MIN
 #define MIN(X, Y) ((X) < (Y) ? (X) : (Y))
+#define MAX(X, Y) ((X) > (Y) ? (X) : (Y))
 
 /* Stream playback parameters
  */
@@ -88,6 +95,7 @@ static ao_sample_format current_sample_format;
 
 static sample *buffer = NULL;
 static int buffer_size_kb = 16;
+static int ring_size_kb = 512;
 
 static int repeat = 0;
 static int verbose = 0;
@@ -157,6 +165,7 @@ static void usage(const char *progname) {
         "    -o KEY:VAL  Pass option KEY with value VAL to the output driver\n"
         "                (see https://www.xiph.org/ao/doc/drivers.html)\n"
         "    -b N        Use an audio buffer of N kilobytes [%d]\n"
+        "    -R N        Decode up to N kilobytes ahead of output, 0 to disable [%d]\n"
         "    -@ LSTFILE  Read playlist from LSTFILE\n"
         "    -h          Print this help\n"
         "    -r          Repeat playback indefinitely\n"
@@ -173,6 +182,7 @@ static void usage(const char *progname) {
         "playlist referring to same. This program supports the \"EXT-X-VGMSTREAM\" tag\n"
         "in playlists, and files compressed with gzip/bzip2/xz.\n",
         buffer_size_kb,
+        ring_size_kb,
         default_par.stream_index,
         default_par.loop_count,
         default_par.fade_time,
@@ -180,6 +190,233 @@ static void usage(const char *progname) {
     );
 }
 
+#ifdef USE_DECODE_AHEAD
+/* Decode-ahead: ao_play runs in an output thread that takes decoded audio from a ring buffer,
+ * while the main thread decodes into it. Slow decoder steps (seeking at a loop point, key
+ * searches, opening the next file in a playlist) then don't stall the device as long as the
+ * ring has data, and tracks with the same format are queued back to back (gapless).
+ * Only one thread writes each side, so data is copied without the lock, which just guards
+ * positions and waits.
+ */
+struct ring {
+    uint8_t *data;
+    size_t alloc_size;
+    size_t size;            /* used part of data, whole frames so plays never split one */
+    size_t read_pos;
+    size_t used;            /* bytes queued, including those being played */
+    size_t frame_size;      /* bytes per sample frame of the current format */
+    size_t max_chunk_size;
+    size_t chunk_size;      /* max bytes per ao_play (whole frames) */
+    int playing;            /* output thread is in ao_play */
+    int discard;            /* drop queued data after the chunk being played */
+    int error;              /* ao_play failed, queued data was dropped */
+    int exit;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+static struct ring *ring = NULL;
+
+static void *ring_output_thread(void *arg) {
+    struct ring *r = arg;
+
+    pthread_mutex_lock(&r->mutex);
+    while (1) {
+        size_t chunk;
+        int ok;
+
+        while (!r->exit && r->used == 0)
+            pthread_cond_wait(&r->cond, &r->mutex);
+        if (r->exit)
+            break;
+
+        chunk = MIN(MIN(r->used, r->size - r->read_pos), r->chunk_size);
+        chunk -= chunk % r->frame_size;
+        r->playing = 1;
+        pthread_mutex_unlock(&r->mutex);
+
+        ok = ao_play(device, (char *)r->data + r->read_pos, chunk);
+
+        pthread_mutex_lock(&r->mutex);
+        r->playing = 0;
+        r->read_pos = (r->read_pos + chunk) % r->size;
+        r->used -= chunk;
+        if (!ok)
+            r->error = 1;
+        if (!ok || r->discard) {
+            r->read_pos = (r->read_pos + r->used) % r->size;
+            r->used = 0;
+            r->discard = 0;
+        }
+        pthread_cond_broadcast(&r->cond);
+    }
+    pthread_mutex_unlock(&r->mutex);
+
+    return NULL;
+}
+
+/* Sizes the ring in whole frames of a new format, must be empty (drained)
+ */
+static void ring_set_frame_size(struct ring *r, size_t frame_size) {
+    pthread_mutex_lock(&r->mutex);
+    r->frame_size = frame_size;
+    r->size = r->alloc_size - r->alloc_size % frame_size;
+    r->chunk_size = MAX(r->max_chunk_size - r->max_chunk_size % frame_size, frame_size);
+    r->read_pos = 0;
+    pthread_mutex_unlock(&r->mutex);
+}
+
+static int ring_start(size_t chunk_size, size_t frame_size) {
+    struct ring *r;
+    sigset_t signals, old_signals;
+    int ret;
+
+    r = calloc(1, sizeof(struct ring));
+    if (!r) return -1;
+
+    r->alloc_size = 1024 * ring_size_kb;
+    r->max_chunk_size = chunk_size;
+    r->data = malloc(r->alloc_size);
+    if (!r->data || r->alloc_size < frame_size) {
+        free(r->data);
+        free(r);
+        return -1;
+    }
+
+    pthread_mutex_init(&r->mutex, NULL);
+    pthread_cond_init(&r->cond, NULL);
+    ring_set_frame_size(r, frame_size);
+
+    /* interrupts must go to the main thread */
+    sigfillset(&signals);
+    pthread_sigmask(SIG_BLOCK, &signals, &old_signals);
+    ret = pthread_create(&r->thread, NULL, ring_output_thread, r);
+    pthread_sigmask(SIG_SETMASK, &old_signals, NULL);
+    if (ret) {
+        pthread_cond_destroy(&r->cond);
+        pthread_mutex_destroy(&r->mutex);
+        free(r->data);
+        free(r);
+        return -1;
+    }
+
+    ring = r;
+    return 0;
+}
+
+/* Queues data to play, waiting for space. Returns 0 if playback failed since the last call.
+ */
+static int ring_write(const void *data, size_t size) {
+    const uint8_t *src = data;
+    int ok = 1;
+
+    size -= size % ring->frame_size; /* callers pass whole frames */
+
+    pthread_mutex_lock(&ring->mutex);
+    while (size > 0 && !ring->error) {
+        size_t write_pos, chunk;
+
+        while (ring->used == ring->size && !ring->error)
+            pthread_cond_wait(&ring->cond, &ring->mutex);
+        if (ring->error)
+            break;
+
+        write_pos = (ring->read_pos + ring->used) % ring->size;
+        chunk = MIN(MIN(size, ring->size - ring->used), ring->size - write_pos);
+        chunk -= chunk % ring->frame_size;
+        pthread_mutex_unlock(&ring->mutex);
+
+        memcpy(ring->data + write_pos, src, chunk);
+        src += chunk;
+        size -= chunk;
+
+        pthread_mutex_lock(&ring->mutex);
+        ring->used += chunk;
+        pthread_cond_broadcast(&ring->cond);
+    }
+    if (ring->error) {
+        ring->error = 0;
+        ok = 0;
+    }
+    pthread_mutex_unlock(&ring->mutex);
+
+    return ok;
+}
+
+/* Waits until queued data is played (so the device can be changed)
+ */
+static void ring_drain(void) {
+    pthread_mutex_lock(&ring->mutex);
+    while (ring->used > 0)
+        pthread_cond_wait(&ring->cond, &ring->mutex);
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+/* Drops queued data, except what is being played now
+ */
+static void ring_discard(void) {
+    pthread_mutex_lock(&ring->mutex);
+    if (ring->playing) {
+        ring->discard = 1;
+        while (ring->used > 0)
+            pthread_cond_wait(&ring->cond, &ring->mutex);
+    }
+    else {
+        ring->read_pos = (ring->read_pos + ring->used) % ring->size;
+        ring->used = 0;
+    }
+    pthread_mutex_unlock(&ring->mutex);
+}
+
+static size_t ring_get_used(void) {
+    size_t used;
+
+    pthread_mutex_lock(&ring->mutex);
+    used = ring->used;
+    pthread_mutex_unlock(&ring->mutex);
+
+    return used;
+}
+
+static void ring_stop(void) {
+    pthread_mutex_lock(&ring->mutex);
+    ring->exit = 1;
+    pthread_cond_broadcast(&ring->cond);
+    pthread_mutex_unlock(&ring->mutex);
+
+    pthread_join(ring->thread, NULL);
+    pthread_cond_destroy(&ring->cond);
+    pthread_mutex_destroy(&ring->mutex);
+    free(ring->data);
+    free(ring);
+    ring = NULL;
+}
+#endif
+
+/* Plays decoded data, or queues it if decoding ahead
+ */
+static int play_buffer(sample *buf, size_t size) {
+#ifdef USE_DECODE_AHEAD
+    if (ring)
+        return ring_write(buf, size);
+#endif
+    return ao_play(device, (char *)buf, size);
+}
+
+/* Decoded samples minus those still queued (approximate, as the queue may have the previous stream)
+ */
+static int64_t get_played_samples(int64_t decoded_samples, int channels) {
+#ifdef USE_DECODE_AHEAD
+    if (ring) {
+        decoded_samples -= (int64_t)(ring_get_used() / (channels * sizeof(sample)));
+        if (decoded_samples < 0)
+            decoded_samples = 0;
+    }
+#endif
+    return decoded_samples;
+}
+
 /* Opens the audio device with the appropriate parameters
  */
 static int set_sample_format(VGMSTREAM *vgms) {
@@ -212,6 +449,12 @@ static int set_sample_format(VGMSTREAM *vgms) {
             return -1;
         }
 
+#ifdef USE_DECODE_AHEAD
+        if (ring) {
+            ring_drain();
+            ring_set_frame_size(ring, format.channels * sizeof(sample));
+        }
+#endif
         if (device)
             ao_close(device);
 
@@ -231,9 +474,11 @@ static int set_sample_format(VGMSTREAM *vgms) {
     return 0;
 }
 
-static int play_vgmstream(const char *filename, struct params *par) {
+
+/* Plays a stream from an already opened STREAMFILE, which is closed here
+ */
+static int play_streamfile(STREAMFILE *sf, const char *filename, struct params *par) {
     int ret = 0;
-    STREAMFILE *sf;
     VGMSTREAM *vgms;
     FILE *save_fps[4];
     int loop_count;
@@ -246,12 +491,6 @@ static int play_vgmstream(const char *filename, struct params *par) {
     int64_t s;
     int i;
 
-    sf = open_stdio_streamfile(filename);
-    if (!sf) {
-        fprintf(stderr, "%s: cannot open file\n", filename);
-        return -1;
-    }
-
     sf->stream_index = par->stream_index;
     vgms = init_vgmstream_from_STREAMFILE(sf);
     close_streamfile(sf);
@@ -329,6 +568,11 @@ static int play_vgmstream(const char *filename, struct params *par) {
         if (!buffer) goto fail;
     }
 
+#ifdef USE_DECODE_AHEAD
+    if (!ring && ring_size_kb > 0 && ring_start(buffer_size, vgms->channels * sizeof(sample)))
+        fputs("Couldn't start decode-ahead, decoding as played\n", stderr);
+#endif
+
     buffer_samples = buffer_size / (vgms->channels * sizeof(sample));
 
     fade_time_samples = (int64_t)(par->fade_time * vgms->sample_rate);
@@ -359,8 +603,9 @@ static int play_vgmstream(const char *filename, struct params *par) {
         }
 
         if (verbose && !out_filename) {
-            double played = (double)s / vgms->sample_rate;
-            double remain = (double)(total_samples - s) / vgms->sample_rate;
+            int64_t played_samples = get_played_samples(s, vgms->channels);
+            double played = (double)played_samples / vgms->sample_rate;
+            double remain = (double)(total_samples - played_samples) / vgms->sample_rate;
 
             int time_played_min = (int)played / 60;
             double time_played_sec = played - 60 * time_played_min;
@@ -377,10 +622,11 @@ static int play_vgmstream(const char *filename, struct params *par) {
             fflush(stdout);
         }
 
-        if (!ao_play(device, (char *)buffer, buffer_used_samples * vgms->channels * sizeof(sample))) {
+        if (!play_buffer(buffer, buffer_used_samples * vgms->channels * sizeof(sample))) {
             fputs("\nAudio playback error\n", stderr);
             ao_close(device);
             device = NULL;
+            memset(&current_sample_format, 0, sizeof(current_sample_format)); /* reopen */
             ret = -1;
             break;
         }
@@ -400,6 +646,10 @@ static int play_vgmstream(const char *filename, struct params *par) {
             time_total_min, time_total_sec, out_filename);
 
     if (interrupted) {
+#ifdef USE_DECODE_AHEAD
+        if (ring)
+            ring_discard();
+#endif
         fputs("Playback terminated.\n\n", stdout);
         ret = record_interrupt();
         if (ret) fputs("Exiting...\n", stdout);
@@ -415,9 +665,20 @@ static int play_vgmstream(const char *filename, struct params *par) {
     return ret;
 }
 
-static int play_playlist(const char *filename, struct params *default_par) {
+static int play_vgmstream(const char *filename, struct params *par) {
+    STREAMFILE *sf;
+
+    sf = open_stdio_streamfile(filename);
+    if (!sf) {
+        fprintf(stderr, "%s: cannot open file\n", filename);
+        return -1;
+    }
+
+    return play_streamfile(sf, filename, par);
+}
+
+static int play_playlist_file(FILE *f, struct params *default_par) {
     int ret = 0;
-    FILE *f;
     char *line = NULL;
     size_t line_mem = 0;
     ssize_t line_len = 0;
@@ -425,12 +686,6 @@ static int play_playlist(const char *filename, struct params *default_par) {
 
     memcpy(&par, default_par, sizeof(par));
 
-    f = fopen(filename, "r");
-    if (!f) {
-        fprintf(stderr, "%s: cannot open playlist file\n", filename);
-        return -1;
-    }
-
     while ((line_len = getline(&line, &line_mem, f)) >= 0) {
 
         /* Remove any leading whitespace
@@ -486,89 +741,165 @@ static int play_playlist(const char *filename, struct params *default_par) {
     }
 
     free(line);
-    fclose(f);
 
     return ret;
 }
 
-static int play_compressed_file(const char *filename, struct params *par, const char *expand_cmd) {
+static int play_playlist(const char *filename, struct params *default_par) {
     int ret;
-    char temp_dir[128] = "/tmp/vgmXXXXXX";
-    const char *base_name;
-    char *last_slash, *last_dot;
-    char *cmd = NULL, *temp_file = NULL;
-    FILE *in_fp, *out_fp;
+    FILE *f;
 
-    cmd = malloc(strlen(filename) + 1024);
-    temp_file = malloc(strlen(filename) + 256);
+    f = fopen(filename, "r");
+    if (!f) {
+        fprintf(stderr, "%s: cannot open playlist file\n", filename);
+        return -1;
+    }
 
-    if (!cmd || !temp_file)
-        return -2;
+    ret = play_playlist_file(f, default_par);
 
-    if (!mkdtemp(temp_dir)) {
-        fprintf(stderr, "%s: error creating temp dir for decompression\n", temp_dir);
-        goto fail;
+    fclose(f);
+
+    return ret;
+}
+
+/* gzip keeps the decompressed size (mod 4GB) at the end, so files can be
+ * given a size without decompressing them first (0 if unknown). That's
+ * only the last member's size though, so it's only used when there is a
+ * single member (no other gzip header in the data, false matches just
+ * lose the size) and when it isn't smaller than the compressed file
+ * (likely wrapped). Outputs of 4GB+ can still have a plausible one, and
+ * the pipe then ends the data at that size.
+ */
+static size_t get_expanded_size(const char *filename, const char *expand_cmd) {
+    FILE *fp;
+    unsigned char buf[0x10000];
+    size_t bytes, i, pos, keep = 0, size = 0;
+    long file_size;
+    int single_member = 1;
+
+    if (strncmp(expand_cmd, "gzip", 4) != 0)
+        return 0;
+
+    fp = fopen(filename, "rb");
+    if (!fp)
+        return 0;
+    if (fseek(fp, 0, SEEK_END) != 0 || (file_size = ftell(fp)) < 18 || fseek(fp, 0, SEEK_SET) != 0)
+        goto end;
+    if (fread(buf, 1, 2, fp) != 2 || buf[0] != 0x1f || buf[1] != 0x8b)
+        goto end;
+
+    /* look for other members' headers: magic, deflate, no reserved flags */
+    pos = 2;
+    while ((bytes = fread(buf + keep, 1, sizeof(buf) - keep, fp)) > 0) {
+        bytes += keep;
+        for (i = 0; i + 4 <= bytes; i++) {
+            if (buf[i] == 0x1f && buf[i+1] == 0x8b && buf[i+2] == 0x08 && (buf[i+3] & 0xE0) == 0 &&
+                    pos + i + 8 < (size_t)file_size) { /* not the trailer */
+                single_member = 0;
+                break;
+            }
+        }
+        if (!single_member)
+            break;
+        keep = bytes < 3 ? bytes : 3;
+        memmove(buf, buf + bytes - keep, keep);
+        pos += bytes - keep;
     }
+    if (!single_member)
+        goto end;
 
-    /* Get the base name of the file path
-     */
-    last_slash = strrchr(filename, '/');
-    if (last_slash)
-        base_name = last_slash + 1;
-    else
-        base_name = filename;
+    if (fseek(fp, -4, SEEK_END) == 0 && fread(buf, 1, 4, fp) == 4) {
+        size = buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((size_t)buf[3] << 24);
+        if (size < (size_t)file_size)
+            size = 0;
+    }
 
-    sprintf(temp_file, "%s/%s", temp_dir, base_name);
+    end:
+    fclose(fp);
+    return size;
+}
 
-    /* Chop off the compressed-file extension
-     */
-    last_dot = strrchr(temp_file, '.');
-    if (last_dot) *last_dot = '\0';
+/* Decompressed data is streamed from the expand command's output, so no
+ * temp files are needed. Most formats need the file size to open, so
+ * playback starts right away only if it's known (gzip), otherwise once
+ * the whole file is decompressed.
+ */
+static int play_compressed_file(const char *filename, struct params *par, const char *expand_cmd) {
+    int ret, status;
+    char *cmd = NULL, *base_name = NULL;
+    char *last_dot;
+    size_t len;
+    FILE *in_fp = NULL, *out_fp = NULL;
+    STREAMFILE *sf;
 
-    printf("Decompressing file: %s\n", filename);
+    cmd = malloc(strlen(expand_cmd) + 64);
+    base_name = strdup(filename);
 
-    in_fp  = fopen(filename, "rb");
-    out_fp = fopen(temp_file, "wb");
+    if (!cmd || !base_name) {
+        ret = -2;
+        goto fail;
+    }
 
-    if (in_fp && out_fp) {
-        setbuf(in_fp, NULL);
-        setbuf(out_fp, NULL);
+    /* Chop off the compressed-file extension; the remaining name
+     * is used to detect the format and find companion files
+     */
+    last_dot = strrchr(base_name, '.');
+    if (last_dot) *last_dot = '\0';
+    len = strlen(base_name);
 
-        /* Don't put filenames into the system() arg; that's insecure!
-         */
-        sprintf(cmd, "%s <&%d >&%d ", expand_cmd, fileno(in_fp), fileno(out_fp));
-        ret = system(cmd);
+    printf("Decompressing file: %s\n", filename);
 
-        if (WIFSIGNALED(ret) && (WTERMSIG(ret) == SIGINT || WTERMSIG(ret) == SIGQUIT))
-            interrupted = 1;
-    }
-    else
+    in_fp = fopen(filename, "rb");
+    if (!in_fp) {
+        fprintf(stderr, "%s: cannot open file\n", filename);
         ret = -1;
+        goto fail;
+    }
 
-    if (in_fp && fclose(in_fp))
-        ret = -1;
-    if (out_fp && fclose(out_fp))
+    /* Don't put filenames into the popen() arg; that's insecure!
+     */
+    sprintf(cmd, "%s <&%d", expand_cmd, fileno(in_fp));
+    out_fp = popen(cmd, "r");
+    if (!out_fp) {
+        fprintf(stderr, "%s: error decompressing file\n", filename);
         ret = -1;
+        goto fail;
+    }
 
-    if (ret) {
-        if (interrupted) {
+    if ((len >= 4 && !strcasecmp(base_name + len - 4, ".m3u")) ||
+        (len >= 5 && !strcasecmp(base_name + len - 5, ".m3u8"))) {
+        ret = play_playlist_file(out_fp, par);
+    }
+    else {
+        sf = open_pipe_streamfile(out_fp, base_name, get_expanded_size(filename, expand_cmd));
+        if (!sf) {
+            fprintf(stderr, "%s: cannot open file\n", filename);
+            ret = -1;
+        }
+        else {
+            ret = play_streamfile(sf, base_name, par);
+        }
+    }
+
+    /* may be closed before all data was read, ending the command with SIGPIPE */
+    status = pclose(out_fp);
+    if (!ret && status != 0 && !interrupted) {
+        if (WIFSIGNALED(status) && (WTERMSIG(status) == SIGINT || WTERMSIG(status) == SIGQUIT)) {
+            interrupted = 1;
             putchar('\r');
             ret = record_interrupt();
             if (ret) fputs("Exiting...\n", stdout);
         }
-        else
+        else if (!WIFSIGNALED(status) || WTERMSIG(status) != SIGPIPE) {
             fprintf(stderr, "%s: error decompressing file\n", filename);
+        }
     }
-    else
-        ret = play_file(temp_file, par);
-
-    remove(temp_file);
-    remove(temp_dir);
 
     fail:
 
+    if (in_fp) fclose(in_fp);
     free(cmd);
-    free(temp_file);
+    free(base_name);
 
     return ret;
 }
@@ -635,7 +966,7 @@ int main(int argc, char **argv) {
         memcpy(&par, &default_par, sizeof(par));
     }
 
-    while ((opt = getopt(argc, argv, "-D:F:L:M:S:b:d:f:o:@:hrv")) != -1) {
+    while ((opt = getopt(argc, argv, "-D:F:L:M:R:S:b:d:f:o:@:hrv")) != -1) {
         switch (opt) {
             case 1:
                 if (play_file(optarg, &par)) {
@@ -662,6 +993,12 @@ int main(int argc, char **argv) {
                 par.min_time = atof(optarg);
                 par.loop_count = -1;
                 break;
+            case 'R':
+#ifdef USE_DECODE_AHEAD
+                if (!ring)
+                    ring_size_kb = atoi(optarg);
+#endif
+                break;
             case 'S':
                 par.stream_index = atoi(optarg);
                 break;
@@ -704,6 +1041,15 @@ int main(int argc, char **argv) {
 
     done:
 
+#ifdef USE_DECODE_AHEAD
+    if (ring) {
+        if (interrupted)
+            ring_discard();
+        else
+            ring_drain();
+        ring_stop();
+    }
+#endif
     if (device)
         ao_close(device);
     if (buffer)
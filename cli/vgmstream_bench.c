@@ -0,0 +1,1204 @@
+#define POSIXLY_CORRECT
+#include <getopt.h>
+#include "../src/vgmstream.h"
+#include "../src/util.h"
+#include <errno.h>
+#ifdef WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#endif
+
+#ifndef VERSION
+#include "../version.h"
+#endif
+#ifndef VERSION
+#define VERSION "(unknown version)"
+#endif
+
+/* Decode benchmark: times opening, decoding, seeking and looping of a list of files
+ * (or a set of generated fixtures), to compare performance between builds. Can also decode
+ * the files from many threads at once and compare against a single-threaded decode, to check
+ * the library is safe to use concurrently (best built with -fsanitize=thread, see README). */
+
+#define BENCH_BUFFER_SAMPLES 0x1000
+#define BENCH_LOOP_WINDOW 0x400     /* samples decoded around the loop point */
+#define BENCH_MAX_LINE 0x1000
+#define BENCH_MAX_THREADS 64
+
+/* getopt globals (the horror...) */
+extern char * optarg;
+extern int optind, opterr, optopt;
+
+
+static void usage(const char * name) {
+    fprintf(stderr,"vgmstream benchmark " VERSION " " __DATE__ "\n"
+            "Usage: %s [options] [infile [infile...]]\n"
+            "Options:\n"
+            "    -m manifest: read files to test from manifest, one per line as: filename [subsong]\n"
+            "    -s N: select subsong N for files given in the command line\n"
+            "    -n N: repeat each test N times and keep the best time, default 3\n"
+            "    -j: print results as JSON lines (one object per file) for tracking\n"
+            "    -g dir: generate synthetic fixtures (with .txth if needed) and a manifest in dir, then exit\n"
+            "    -t N: stress test, decode all files from N threads at once (-n rounds) and compare\n"
+            "          with a single-threaded decode\n"
+            , name);
+}
+
+
+typedef struct {
+    const char * manifest;
+    const char * fixture_dir;
+    int stream_index;
+    int repeats;
+    int print_json;
+    int stress_threads;
+
+    /* stress test files (to decode from all threads) */
+    struct stress_entry * stress_entries;
+    int stress_count;
+} bench_config;
+
+typedef struct {
+    char filename[PATH_LIMIT];
+    int stream_index;
+
+    /* stream info */
+    int channels;
+    int sample_rate;
+    int32_t num_samples;
+    int loop_flag;
+    int32_t loop_start_sample;
+    int32_t loop_end_sample;
+    char coding[128];
+    char layout[128];
+    char meta[128];
+
+    /* results (best of N, seconds) */
+    double open_time;
+    double decode_time;
+    double seek_time[5];
+    double loop_time;
+    long peak_memory_kb;
+} bench_result;
+
+static const double seek_positions[5] = { 0.10, 0.25, 0.50, 0.75, 0.90 };
+
+
+/* ************************************************************ */
+
+/* process peak memory so far, as there is no easy way to get it per stream */
+static long get_peak_memory_kb(void) {
+#ifdef WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return usage.ru_maxrss;
+#endif
+}
+
+static VGMSTREAM * open_bench_vgmstream(const char * filename, int stream_index) {
+    STREAMFILE *streamFile;
+    VGMSTREAM *vgmstream;
+
+    streamFile = open_stdio_streamfile(filename);
+    if (!streamFile) return NULL;
+
+    streamFile->stream_index = stream_index;
+    vgmstream = init_vgmstream_from_STREAMFILE(streamFile);
+    close_streamfile(streamFile);
+
+    return vgmstream;
+}
+
+/* decodes and discards samples up to a position, like plugins do to seek */
+static void render_to(VGMSTREAM * vgmstream, sample * buffer, int32_t target_sample) {
+    int32_t i;
+
+    for (i = 0; i < target_sample; i += BENCH_BUFFER_SAMPLES) {
+        int32_t to_do = BENCH_BUFFER_SAMPLES;
+        if (to_do > target_sample - i)
+            to_do = target_sample - i;
+        render_vgmstream(buffer, to_do, vgmstream);
+    }
+}
+
+static int bench_file(bench_result * result, bench_config * cfg) {
+    VGMSTREAM *vgmstream = NULL;
+    sample *buffer = NULL;
+    uint64_t start;
+    int n, i;
+
+    /* open (probes all formats until one works) */
+    result->open_time = -1;
+    for (n = 0; n < cfg->repeats; n++) {
+        double time;
+
+        close_vgmstream(vgmstream);
+        start = get_time_ns();
+        vgmstream = open_bench_vgmstream(result->filename, result->stream_index);
+        time = (get_time_ns() - start) / 1000000000.0;
+        if (!vgmstream) {
+            fprintf(stderr,"failed opening %s\n", result->filename);
+            goto fail;
+        }
+
+        if (result->open_time < 0 || time < result->open_time)
+            result->open_time = time;
+    }
+
+    result->channels = vgmstream->channels;
+    result->sample_rate = vgmstream->sample_rate;
+    result->num_samples = vgmstream->num_samples;
+    result->loop_flag = vgmstream->loop_flag;
+    result->loop_start_sample = vgmstream->loop_start_sample;
+    result->loop_end_sample = vgmstream->loop_end_sample;
+    snprintf(result->coding,sizeof(result->coding),"%s", get_vgmstream_coding_description(vgmstream->coding_type));
+    snprintf(result->layout,sizeof(result->layout),"%s", get_vgmstream_layout_description(vgmstream->layout_type));
+    snprintf(result->meta,sizeof(result->meta),"%s", get_vgmstream_meta_description(vgmstream->meta_type));
+
+    buffer = malloc(BENCH_BUFFER_SAMPLES * sizeof(sample) * vgmstream->channels);
+    if (!buffer) goto fail;
+
+    /* full decode, without loops */
+    vgmstream_force_loop(vgmstream, 0, 0, 0);
+    result->decode_time = -1;
+    for (n = 0; n < cfg->repeats; n++) {
+        double time;
+
+        reset_vgmstream(vgmstream);
+        start = get_time_ns();
+        render_to(vgmstream, buffer, vgmstream->num_samples);
+        time = (get_time_ns() - start) / 1000000000.0;
+
+        if (result->decode_time < 0 || time < result->decode_time)
+            result->decode_time = time;
+    }
+
+    /* seek to positions (reset + decode up to position) */
+    for (i = 0; i < 5; i++) {
+        int32_t target_sample = (int32_t)(vgmstream->num_samples * seek_positions[i]);
+
+        result->seek_time[i] = -1;
+        for (n = 0; n < cfg->repeats; n++) {
+            double time;
+
+            start = get_time_ns();
+            reset_vgmstream(vgmstream);
+            render_to(vgmstream, buffer, target_sample);
+            time = (get_time_ns() - start) / 1000000000.0;
+
+            if (result->seek_time[i] < 0 || time < result->seek_time[i])
+                result->seek_time[i] = time;
+        }
+    }
+
+    /* loop transition: decode a small window around the loop end, with a fresh stream as loops were removed */
+    result->loop_time = -1;
+    if (result->loop_flag) {
+        int32_t window_start = result->loop_end_sample - BENCH_LOOP_WINDOW / 2;
+        if (window_start < 0)
+            window_start = 0;
+
+        close_vgmstream(vgmstream);
+        vgmstream = open_bench_vgmstream(result->filename, result->stream_index);
+        if (!vgmstream) goto fail;
+
+        for (n = 0; n < cfg->repeats; n++) {
+            double time;
+
+            reset_vgmstream(vgmstream);
+            render_to(vgmstream, buffer, window_start);
+
+            start = get_time_ns();
+            render_vgmstream(buffer, BENCH_LOOP_WINDOW, vgmstream);
+            time = (get_time_ns() - start) / 1000000000.0;
+
+            if (result->loop_time < 0 || time < result->loop_time)
+                result->loop_time = time;
+        }
+    }
+
+    result->peak_memory_kb = get_peak_memory_kb();
+
+    close_vgmstream(vgmstream);
+    free(buffer);
+    return 1;
+
+fail:
+    close_vgmstream(vgmstream);
+    free(buffer);
+    return 0;
+}
+
+
+/* ************************************************************ */
+
+static double get_samples_per_second(bench_result * result) {
+    if (result->decode_time <= 0)
+        return 0;
+    return result->num_samples / result->decode_time;
+}
+
+static void print_json_string(const char * str) {
+    putchar('"');
+    for ( ; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            putchar('\\');
+        if ((unsigned char)*str < 0x20)
+            printf("\\u%04x", (unsigned char)*str);
+        else
+            putchar(*str);
+    }
+    putchar('"');
+}
+
+static void print_result(bench_result * result, bench_config * cfg) {
+    double samples_per_second = get_samples_per_second(result);
+    int i;
+
+    if (cfg->print_json) {
+        printf("{\"file\":");
+        print_json_string(result->filename);
+        printf(",\"subsong\":%i,\"coding\":", result->stream_index);
+        print_json_string(result->coding);
+        printf(",\"layout\":");
+        print_json_string(result->layout);
+        printf(",\"meta\":");
+        print_json_string(result->meta);
+        printf(",\"channels\":%i,\"sample_rate\":%i,\"num_samples\":%i", result->channels, result->sample_rate, result->num_samples);
+        printf(",\"open_ms\":%.3f,\"decode_ms\":%.3f,\"samples_per_second\":%.0f,\"realtime_factor\":%.2f",
+                result->open_time * 1000.0, result->decode_time * 1000.0, samples_per_second,
+                result->sample_rate ? samples_per_second / result->sample_rate : 0.0);
+        printf(",\"seek_ms\":{");
+        for (i = 0; i < 5; i++) {
+            printf("%s\"%i%%\":%.3f", i ? "," : "", (int)(seek_positions[i] * 100), result->seek_time[i] * 1000.0);
+        }
+        printf("}");
+        if (result->loop_time >= 0)
+            printf(",\"loop_ms\":%.3f", result->loop_time * 1000.0);
+        else
+            printf(",\"loop_ms\":null");
+        printf(",\"peak_memory_kb\":%li}\n", result->peak_memory_kb);
+    }
+    else {
+        printf("%s", result->filename);
+        if (result->stream_index)
+            printf(" #%i", result->stream_index);
+        printf("\n");
+        printf("    format: %s / %s / %s\n", result->meta, result->coding, result->layout);
+        printf("    stream: %i ch, %i Hz, %i samples\n", result->channels, result->sample_rate, result->num_samples);
+        printf("    open:   %.3f ms\n", result->open_time * 1000.0);
+        printf("    decode: %.3f ms (%.0f samples/s, %.2fx realtime)\n",
+                result->decode_time * 1000.0, samples_per_second,
+                result->sample_rate ? samples_per_second / result->sample_rate : 0.0);
+        printf("    seek:  ");
+        for (i = 0; i < 5; i++) {
+            printf(" %i%%=%.3f ms", (int)(seek_positions[i] * 100), result->seek_time[i] * 1000.0);
+        }
+        printf("\n");
+        if (result->loop_time >= 0)
+            printf("    loop:   %.3f ms (%i samples around loop end)\n", result->loop_time * 1000.0, BENCH_LOOP_WINDOW);
+        if (result->peak_memory_kb)
+            printf("    memory: %li KB peak\n", result->peak_memory_kb);
+    }
+    fflush(stdout);
+}
+
+static int add_stress_entry(const char * filename, int stream_index, bench_config * cfg);
+
+static int bench_entry(const char * filename, int stream_index, bench_config * cfg) {
+    bench_result result;
+
+    if (cfg->stress_threads)
+        return add_stress_entry(filename, stream_index, cfg);
+
+    memset(&result, 0, sizeof(result));
+    snprintf(result.filename,sizeof(result.filename),"%s", filename);
+    result.stream_index = stream_index;
+
+    if (!bench_file(&result, cfg))
+        return 0;
+    print_result(&result, cfg);
+    return 1;
+}
+
+static int bench_manifest(const char * manifest, bench_config * cfg) {
+    FILE *file;
+    char line[BENCH_MAX_LINE];
+    int errors = 0;
+
+    file = fopen(manifest, "r");
+    if (!file) {
+        fprintf(stderr,"failed opening manifest %s\n", manifest);
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        char *end;
+        int stream_index = 0;
+        size_t len;
+
+        /* trim line end and skip comments/empty lines */
+        len = strlen(line);
+        while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r' || line[len-1] == ' ' || line[len-1] == '\t'))
+            line[--len] = '\0';
+        if (line[0] == '\0' || line[0] == '#')
+            continue;
+
+        /* optional subsong after the last space */
+        end = strrchr(line, ' ');
+        if (end && end[1] >= '0' && end[1] <= '9' && strspn(end + 1, "0123456789") == strlen(end + 1)) {
+            stream_index = atoi(end + 1);
+            *end = '\0';
+        }
+
+        if (!bench_entry(line, stream_index, cfg))
+            errors++;
+    }
+
+    fclose(file);
+    return errors == 0;
+}
+
+
+/* ************************************************************ */
+
+/* Stress test: every thread opens and fully decodes each file (starting at a different one, so
+ * different codecs run at once), resetting halfway to also exercise seeks, and compares a hash of
+ * the output with the one from a single-threaded decode. */
+
+typedef struct stress_entry {
+    char filename[PATH_LIMIT];
+    int stream_index;
+    uint32_t hash;          /* single-threaded output */
+    int32_t samples;
+} stress_entry;
+
+typedef struct {
+    bench_config * cfg;
+    int thread_index;
+    int decodes;
+    int errors;
+#ifdef WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+    int thread_started;
+} stress_worker;
+
+static int add_stress_entry(const char * filename, int stream_index, bench_config * cfg) {
+    stress_entry * entries;
+
+    entries = realloc(cfg->stress_entries, (cfg->stress_count + 1) * sizeof(stress_entry));
+    if (!entries) return 0;
+    cfg->stress_entries = entries;
+
+    memset(&entries[cfg->stress_count], 0, sizeof(stress_entry));
+    snprintf(entries[cfg->stress_count].filename,sizeof(entries[cfg->stress_count].filename),"%s", filename);
+    entries[cfg->stress_count].stream_index = stream_index;
+    cfg->stress_count++;
+    return 1;
+}
+
+/* FNV-1a of the whole output (without loops), reset and decoded again after the first half */
+static int stress_decode(const char * filename, int stream_index, uint32_t * hash, int32_t * samples) {
+    VGMSTREAM *vgmstream = NULL;
+    sample *buffer = NULL;
+    int32_t i, half;
+    size_t j;
+
+    vgmstream = open_bench_vgmstream(filename, stream_index);
+    if (!vgmstream) goto fail;
+
+    buffer = malloc(BENCH_BUFFER_SAMPLES * sizeof(sample) * vgmstream->channels);
+    if (!buffer) goto fail;
+
+    vgmstream_force_loop(vgmstream, 0, 0, 0);
+    half = vgmstream->num_samples / 2;
+    render_to(vgmstream, buffer, half);
+    reset_vgmstream(vgmstream);
+
+    *hash = 0x811C9DC5;
+    for (i = 0; i < vgmstream->num_samples; i += BENCH_BUFFER_SAMPLES) {
+        int32_t to_do = BENCH_BUFFER_SAMPLES;
+        if (to_do > vgmstream->num_samples - i)
+            to_do = vgmstream->num_samples - i;
+        render_vgmstream(buffer, to_do, vgmstream);
+
+        for (j = 0; j < to_do * vgmstream->channels; j++) {
+            *hash = (*hash ^ (uint16_t)buffer[j]) * 0x01000193;
+        }
+    }
+    *samples = vgmstream->num_samples;
+
+    close_vgmstream(vgmstream);
+    free(buffer);
+    return 1;
+
+fail:
+    close_vgmstream(vgmstream);
+    free(buffer);
+    return 0;
+}
+
+static void stress_work(stress_worker * worker) {
+    bench_config * cfg = worker->cfg;
+    int round, i;
+
+    for (round = 0; round < cfg->repeats; round++) {
+        for (i = 0; i < cfg->stress_count; i++) {
+            stress_entry * entry = &cfg->stress_entries[(worker->thread_index + i) % cfg->stress_count];
+            uint32_t hash;
+            int32_t samples;
+
+            worker->decodes++;
+            if (!stress_decode(entry->filename, entry->stream_index, &hash, &samples)) {
+                fprintf(stderr,"thread %i: failed decoding %s\n", worker->thread_index, entry->filename);
+                worker->errors++;
+            }
+            else if (hash != entry->hash || samples != entry->samples) {
+                fprintf(stderr,"thread %i: output of %s differs from single-threaded decode\n", worker->thread_index, entry->filename);
+                worker->errors++;
+            }
+        }
+    }
+}
+
+#ifdef WIN32
+static DWORD WINAPI stress_thread(LPVOID arg) {
+    stress_work(arg);
+    return 0;
+}
+#else
+static void *stress_thread(void *arg) {
+    stress_work(arg);
+    return NULL;
+}
+#endif
+
+static int run_stress(bench_config * cfg) {
+    stress_worker workers[BENCH_MAX_THREADS];
+    int decodes = 0, errors = 0;
+    uint64_t start;
+    int i;
+
+    if (cfg->stress_count == 0)
+        return 0;
+
+    /* reference output */
+    for (i = 0; i < cfg->stress_count; i++) {
+        stress_entry * entry = &cfg->stress_entries[i];
+        if (!stress_decode(entry->filename, entry->stream_index, &entry->hash, &entry->samples)) {
+            fprintf(stderr,"failed opening %s\n", entry->filename);
+            return 0;
+        }
+    }
+
+    start = get_time_ns();
+    memset(workers, 0, sizeof(workers));
+    for (i = 0; i < cfg->stress_threads; i++) {
+        workers[i].cfg = cfg;
+        workers[i].thread_index = i;
+#ifdef WIN32
+        workers[i].thread = CreateThread(NULL, 0, stress_thread, &workers[i], 0, NULL);
+        workers[i].thread_started = (workers[i].thread != NULL);
+#else
+        workers[i].thread_started = (pthread_create(&workers[i].thread, NULL, stress_thread, &workers[i]) == 0);
+#endif
+        if (!workers[i].thread_started) {
+            fprintf(stderr,"failed starting thread %i\n", i);
+            errors++;
+        }
+    }
+
+    for (i = 0; i < cfg->stress_threads; i++) {
+        if (!workers[i].thread_started)
+            continue;
+#ifdef WIN32
+        WaitForSingleObject(workers[i].thread, INFINITE);
+        CloseHandle(workers[i].thread);
+#else
+        pthread_join(workers[i].thread, NULL);
+#endif
+        decodes += workers[i].decodes;
+        errors += workers[i].errors;
+    }
+
+    if (cfg->print_json) {
+        printf("{\"stress_threads\":%i,\"files\":%i,\"decodes\":%i,\"errors\":%i,\"time_ms\":%.3f}\n",
+                cfg->stress_threads, cfg->stress_count, decodes, errors, (get_time_ns() - start) / 1000000.0);
+    }
+    else {
+        printf("stress: %i threads, %i files, %i decodes, %i errors (%.3f ms)\n",
+                cfg->stress_threads, cfg->stress_count, decodes, errors, (get_time_ns() - start) / 1000000.0);
+    }
+    return errors == 0;
+}
+
+/* ************************************************************ */
+
+/* Synthetic fixtures: random (but valid) encoded data plus a .txth to open it (if it's not a
+ * format with its own header), so main codecs can be measured anywhere. Sizes are around one
+ * minute of audio. */
+
+typedef enum { FIXTURE_PCM16, FIXTURE_PSX, FIXTURE_DSP, FIXTURE_IMA, FIXTURE_XBOX, FIXTURE_MSADPCM, FIXTURE_HCA,
+        FIXTURE_ACM, FIXTURE_OGL, FIXTURE_OGG } fixture_type;
+
+typedef struct {
+    const char * filename;
+    fixture_type type;
+    const char * txth;
+    size_t data_size;       /* max for fixtures that end after their last full block/packet */
+} bench_fixture;
+
+static const bench_fixture fixtures[] = {
+    { "pcm16.raw", FIXTURE_PCM16,
+        "codec = PCM16LE\nchannels = 2\ninterleave = 0x2\nsample_rate = 44100\nnum_samples = data_size\n"
+        "loop_start_sample = 44100\nloop_end_sample = 2000000\n",
+        0xA00000 },
+    { "psx.vag", FIXTURE_PSX,
+        "codec = PSX\nchannels = 2\ninterleave = 0x800\nsample_rate = 44100\nnum_samples = data_size\n"
+        "loop_start_sample = 44100\nloop_end_sample = 2000000\n",
+        0x300000 },
+    { "dsp.adp", FIXTURE_DSP,
+        "codec = NGC_DSP\nchannels = 2\ninterleave = 0x8\nsample_rate = 48000\nstart_offset = 0x60\n"
+        "coef_offset = 0x00\ncoef_spacing = 0x30\ncoef_endianness = BE\nnum_samples = data_size\n"
+        "loop_start_sample = 48000\nloop_end_sample = 2000000\n",
+        0x300000 },
+    { "ima.ima", FIXTURE_IMA,
+        "codec = IMA\nchannels = 1\nsample_rate = 44100\nnum_samples = data_size\n",
+        0x150000 },
+    { "xbox.xbx", FIXTURE_XBOX,
+        "codec = XBOX\nchannels = 2\nsample_rate = 44100\nnum_samples = data_size\n",
+        0x2A0000 },
+    { "msadpcm.msa", FIXTURE_MSADPCM,
+        "codec = MSADPCM\nchannels = 2\ninterleave = 0x800\nsample_rate = 44100\nnum_samples = data_size\n",
+        0x2A0000 },
+    { "hca.hca", FIXTURE_HCA,
+        NULL,
+        0x60 + 2600*0x200 },
+    { "acm.acm", FIXTURE_ACM,
+        NULL,
+        0x160000 },
+#ifdef VGM_USE_VORBIS
+    { "vorbis.ogl", FIXTURE_OGL, /* custom Vorbis (setup parsed by vgmstream) */
+        NULL,
+        0xD0000 },
+    { "vorbis.ogg", FIXTURE_OGG,
+        NULL,
+        0x100000 },
+#endif
+};
+
+/* fixed pseudo-random generator, so fixtures are the same everywhere */
+static uint32_t fixture_seed = 0x12345678;
+static uint8_t fixture_rand(void) {
+    fixture_seed = fixture_seed * 1103515245 + 12345;
+    return (fixture_seed >> 16) & 0xFF;
+}
+
+static void fixture_put_bits(uint8_t * buf, size_t * bitpos, uint32_t value, int bits) {
+    int i;
+    for (i = bits - 1; i >= 0; i--) {
+        if ((value >> i) & 1)
+            buf[*bitpos / 8] |= 0x80 >> (*bitpos % 8);
+        else
+            buf[*bitpos / 8] &= ~(0x80 >> (*bitpos % 8));
+        (*bitpos)++;
+    }
+}
+
+/* same but LSB-first, as ACM and Vorbis read bits */
+static void fixture_put_bits_lsb(uint8_t * buf, size_t * bitpos, uint32_t value, int bits) {
+    int i;
+    for (i = 0; i < bits; i++) {
+        if ((value >> i) & 1)
+            buf[*bitpos / 8] |= 0x01 << (*bitpos % 8);
+        else
+            buf[*bitpos / 8] &= ~(0x01 << (*bitpos % 8));
+        (*bitpos)++;
+    }
+}
+
+/* HCA's CRC-16 (poly 0x8005), stored BE at the end of header and frames */
+static void fixture_put_crc16(uint8_t * buf, size_t size) {
+    uint16_t crc = 0;
+    size_t i;
+    int j;
+
+    for (i = 0; i < size - 2; i++) {
+        crc ^= buf[i] << 8;
+        for (j = 0; j < 8; j++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x8005 : (crc << 1);
+        }
+    }
+    put_16bitBE(buf + size - 2, crc);
+}
+
+/* HCA v2.0 stereo, 0x200 frames of random scalefactors/spectra (v2.0 frames need an exact bitstream,
+ * so unlike other fixtures the whole frame is written) */
+static void make_fixture_hca(uint8_t * buf, size_t data_size) {
+    const int channels = 2, frame_size = 0x200, header_size = 0x60;
+    const int total_bands = 128, base_bands = 48, stereo_bands = 24, bands_per_hfr_group = 8;
+    const int hfr_groups = (total_bands - base_bands - stereo_bands + bands_per_hfr_group - 1) / bands_per_hfr_group;
+    int frames = (data_size - header_size) / frame_size;
+    size_t bitpos = 0;
+    int i, ch, frame;
+
+    memset(buf, 0, header_size);
+    fixture_put_bits(buf, &bitpos, 0x48434100, 32); /* "HCA\0" */
+    fixture_put_bits(buf, &bitpos, 0x0200, 16);
+    fixture_put_bits(buf, &bitpos, header_size, 16);
+    fixture_put_bits(buf, &bitpos, 0x666D7400, 32); /* "fmt\0" */
+    fixture_put_bits(buf, &bitpos, channels, 8);
+    fixture_put_bits(buf, &bitpos, 44100, 24);
+    fixture_put_bits(buf, &bitpos, frames, 32);
+    fixture_put_bits(buf, &bitpos, 0, 32); /* encoder delay/padding */
+    fixture_put_bits(buf, &bitpos, 0x636F6D70, 32); /* "comp" */
+    fixture_put_bits(buf, &bitpos, frame_size, 16);
+    fixture_put_bits(buf, &bitpos, 1, 8); /* min resolution */
+    fixture_put_bits(buf, &bitpos, 15, 8); /* max resolution */
+    fixture_put_bits(buf, &bitpos, 1, 8); /* track count */
+    fixture_put_bits(buf, &bitpos, 0, 8); /* channel config */
+    fixture_put_bits(buf, &bitpos, total_bands, 8);
+    fixture_put_bits(buf, &bitpos, base_bands, 8);
+    fixture_put_bits(buf, &bitpos, stereo_bands, 8);
+    fixture_put_bits(buf, &bitpos, bands_per_hfr_group, 8);
+    fixture_put_bits(buf, &bitpos, 0, 16); /* reserved */
+    fixture_put_bits(buf, &bitpos, 0x70616400, 32); /* "pad\0" */
+    fixture_put_crc16(buf, header_size);
+
+    for (frame = 0; frame < frames; frame++) {
+        uint8_t * frame_buf = buf + header_size + frame * frame_size;
+
+        bitpos = 0;
+        fixture_put_bits(frame_buf, &bitpos, 0xFFFF, 16); /* sync */
+        fixture_put_bits(frame_buf, &bitpos, 300, 9); /* acceptable noise level */
+        fixture_put_bits(frame_buf, &bitpos, fixture_rand() & 0x7F, 7); /* evaluation boundary */
+        for (ch = 0; ch < channels; ch++) {
+            int secondary = (ch == 1); /* stereo pair's secondary channel uses intensity */
+            int coded_count = secondary ? base_bands : base_bands + stereo_bands;
+
+            fixture_put_bits(frame_buf, &bitpos, 6, 3); /* scalefactors as plain 6-bit values */
+            for (i = 0; i < coded_count; i++) {
+                fixture_put_bits(frame_buf, &bitpos, 1 + fixture_rand() % 30, 6);
+            }
+            if (secondary) {
+                for (i = 0; i < 8; i++) {
+                    fixture_put_bits(frame_buf, &bitpos, fixture_rand() % 15, 4);
+                }
+            }
+            else {
+                for (i = 0; i < hfr_groups; i++) {
+                    fixture_put_bits(frame_buf, &bitpos, fixture_rand() % 64, 6);
+                }
+            }
+        }
+        /* rest are random spectra */
+        while (bitpos < (frame_size - 2) * 8) {
+            fixture_put_bits(frame_buf, &bitpos, fixture_rand(), 8);
+        }
+        fixture_put_crc16(frame_buf, frame_size);
+    }
+}
+
+/* ACM stereo, blocks of 32 rows x 32 columns using zero, linear (up to 8 bits) and packed fillers.
+ * Block amplitude tables are set to 128 values, the max those fillers index (the rest is garbage). */
+static size_t make_fixture_acm(uint8_t * buf, size_t data_size) {
+    static const int fillers[10] = { 0, 3, 4, 5, 6, 7, 8, 19, 22, 29 }; /* zero, linear, t15, t27, t37 */
+    const int level = 5, rows = 32, cols = 1 << level;
+    const size_t max_block_bits = 4 + 16 + cols * (5 + rows * 8);
+    size_t bitpos = 0x0e * 8, data_end;
+    uint32_t total_values;
+    int i, col, blocks = 0;
+
+    memset(buf, 0, data_size);
+    while ((bitpos + max_block_bits) / 8 + 1 < data_size) {
+        fixture_put_bits_lsb(buf, &bitpos, 7, 4); /* amplitude power */
+        fixture_put_bits_lsb(buf, &bitpos, 1 + fixture_rand() % 32, 16); /* amplitude step */
+        for (col = 0; col < cols; col++) {
+            int ind = fillers[fixture_rand() % 10];
+
+            fixture_put_bits_lsb(buf, &bitpos, ind, 5);
+            switch(ind) {
+                case 0:
+                    break;
+                case 19: /* 3 rows per 5 bits (3 values each) */
+                    for (i = 0; i < rows; i += 3)
+                        fixture_put_bits_lsb(buf, &bitpos, fixture_rand() % 27, 5);
+                    break;
+                case 22: /* 3 rows per 7 bits (5 values each) */
+                    for (i = 0; i < rows; i += 3)
+                        fixture_put_bits_lsb(buf, &bitpos, fixture_rand() % 125, 7);
+                    break;
+                case 29: /* 2 rows per 7 bits (11 values each) */
+                    for (i = 0; i < rows; i += 2)
+                        fixture_put_bits_lsb(buf, &bitpos, fixture_rand() % 121, 7);
+                    break;
+                default: /* 1 row per ind bits */
+                    for (i = 0; i < rows; i++)
+                        fixture_put_bits_lsb(buf, &bitpos, fixture_rand(), ind);
+                    break;
+            }
+        }
+        blocks++;
+    }
+
+    data_end = (bitpos + 7) / 8;
+    total_values = blocks * rows * cols; /* samples * channels */
+    bitpos = 0;
+    fixture_put_bits_lsb(buf, &bitpos, 0x032897, 24); /* id */
+    fixture_put_bits_lsb(buf, &bitpos, 1, 8); /* version */
+    fixture_put_bits_lsb(buf, &bitpos, total_values & 0xFFFF, 16);
+    fixture_put_bits_lsb(buf, &bitpos, total_values >> 16, 16);
+    fixture_put_bits_lsb(buf, &bitpos, 2, 16); /* channels */
+    fixture_put_bits_lsb(buf, &bitpos, 22050, 16);
+    fixture_put_bits_lsb(buf, &bitpos, level, 4);
+    fixture_put_bits_lsb(buf, &bitpos, rows, 12);
+
+    return data_end;
+}
+
+#ifdef VGM_USE_VORBIS
+#define FIXTURE_VORBIS_PACKET_MAX 0x30
+
+/* Vorbis stereo with a minimal setup made for this (short blocks only, floor1 with just the 2 end
+ * points, residue 1 of -1/+1 values), so audio is a random floor line per channel times random
+ * residue signs. Writes the header packet and returns its size. */
+static size_t fixture_vorbis_header(uint8_t * buf, int packet_type) {
+    size_t bitpos = 0;
+    int i;
+
+    memset(buf, 0, 0x100);
+    fixture_put_bits_lsb(buf, &bitpos, packet_type, 8);
+    for (i = 0; i < 6; i++)
+        fixture_put_bits_lsb(buf, &bitpos, "vorbis"[i], 8);
+
+    switch(packet_type) {
+        case 1: /* identification */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 32); /* version */
+            fixture_put_bits_lsb(buf, &bitpos, 2, 8); /* channels */
+            fixture_put_bits_lsb(buf, &bitpos, 44100, 32);
+            fixture_put_bits_lsb(buf, &bitpos, 0, 32); /* max bitrate */
+            fixture_put_bits_lsb(buf, &bitpos, 128000, 32); /* nominal bitrate */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 32); /* min bitrate */
+            fixture_put_bits_lsb(buf, &bitpos, 8, 4); /* short blocksize (256) */
+            fixture_put_bits_lsb(buf, &bitpos, 8, 4); /* long blocksize (256, unused) */
+            break;
+
+        case 3: /* comment */
+            fixture_put_bits_lsb(buf, &bitpos, 9, 32);
+            for (i = 0; i < 9; i++)
+                fixture_put_bits_lsb(buf, &bitpos, "vgmstream"[i], 8);
+            fixture_put_bits_lsb(buf, &bitpos, 0, 32); /* user comments */
+            break;
+
+        case 5: /* setup */
+            fixture_put_bits_lsb(buf, &bitpos, 2 - 1, 8); /* codebooks */
+            for (i = 0; i < 2; i++) { /* 1 dimension, 2 entries with 1-bit codewords */
+                fixture_put_bits_lsb(buf, &bitpos, 0x564342, 24); /* sync */
+                fixture_put_bits_lsb(buf, &bitpos, 1, 16); /* dimensions */
+                fixture_put_bits_lsb(buf, &bitpos, 2, 24); /* entries */
+                fixture_put_bits_lsb(buf, &bitpos, 0, 1); /* not ordered */
+                fixture_put_bits_lsb(buf, &bitpos, 0, 1); /* not sparse */
+                fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 5); /* codeword lengths */
+                fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 5);
+                if (i == 0) { /* residue classes */
+                    fixture_put_bits_lsb(buf, &bitpos, 0, 4); /* no lookup */
+                }
+                else { /* residue values */
+                    fixture_put_bits_lsb(buf, &bitpos, 1, 4); /* lookup type 1 */
+                    fixture_put_bits_lsb(buf, &bitpos, 0xE2800001, 32); /* min -1.0 */
+                    fixture_put_bits_lsb(buf, &bitpos, 0x62800001, 32); /* delta 1.0 */
+                    fixture_put_bits_lsb(buf, &bitpos, 2 - 1, 4); /* value bits */
+                    fixture_put_bits_lsb(buf, &bitpos, 0, 1); /* not sequence */
+                    fixture_put_bits_lsb(buf, &bitpos, 0, 2); /* -1.0 */
+                    fixture_put_bits_lsb(buf, &bitpos, 2, 2); /* +1.0 */
+                }
+            }
+
+            fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 6); /* time domain transforms (placeholders) */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 16);
+
+            fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 6); /* floors */
+            fixture_put_bits_lsb(buf, &bitpos, 1, 16); /* type */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 5); /* partitions */
+            fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 2); /* multiplier */
+            fixture_put_bits_lsb(buf, &bitpos, 7, 4); /* range bits (last point at blocksize/2) */
+
+            fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 6); /* residues */
+            fixture_put_bits_lsb(buf, &bitpos, 1, 16); /* type */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 24); /* begin */
+            fixture_put_bits_lsb(buf, &bitpos, 128, 24); /* end */
+            fixture_put_bits_lsb(buf, &bitpos, 32 - 1, 24); /* partition size */
+            fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 6); /* classifications */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 8); /* class book */
+            fixture_put_bits_lsb(buf, &bitpos, 1, 3); /* class 0 cascade: first pass only */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 1);
+            fixture_put_bits_lsb(buf, &bitpos, 1, 8); /* first pass book */
+
+            fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 6); /* mappings */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 16); /* type */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 1); /* single submap */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 1); /* no coupling */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 2); /* reserved */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 8); /* submap time (unused) */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 8); /* submap floor */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 8); /* submap residue */
+
+            fixture_put_bits_lsb(buf, &bitpos, 1 - 1, 6); /* modes */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 1); /* short block */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 16); /* window type */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 16); /* transform type */
+            fixture_put_bits_lsb(buf, &bitpos, 0, 8); /* mapping */
+            break;
+
+        default:
+            break;
+    }
+    fixture_put_bits_lsb(buf, &bitpos, 1, 1); /* framing */
+
+    return (bitpos + 7) / 8;
+}
+
+/* writes an audio packet (128 samples, or none for the first) and returns its size */
+static size_t fixture_vorbis_packet(uint8_t * buf) {
+    size_t bitpos = 0;
+    int i, j, ch;
+
+    memset(buf, 0, FIXTURE_VORBIS_PACKET_MAX);
+    fixture_put_bits_lsb(buf, &bitpos, 0, 1); /* audio (single mode takes no bits) */
+    for (ch = 0; ch < 2; ch++) {
+        fixture_put_bits_lsb(buf, &bitpos, 1, 1); /* floor used */
+        fixture_put_bits_lsb(buf, &bitpos, 100 + fixture_rand() % 100, 8); /* start/end levels (-85..-30dB) */
+        fixture_put_bits_lsb(buf, &bitpos, 100 + fixture_rand() % 100, 8);
+    }
+    for (i = 0; i < 128 / 32; i++) { /* per partition: class of each channel, then its values */
+        for (ch = 0; ch < 2; ch++)
+            fixture_put_bits_lsb(buf, &bitpos, 0, 1);
+        for (ch = 0; ch < 2; ch++) {
+            for (j = 0; j < 32; j += 8)
+                fixture_put_bits_lsb(buf, &bitpos, fixture_rand(), 8);
+        }
+    }
+
+    return (bitpos + 7) / 8;
+}
+
+/* OGL: 0x14 header, then header and audio packets, each with a 16b LE (size << 2) header */
+static size_t make_fixture_ogl(uint8_t * buf, size_t data_size) {
+    size_t offset = 0x14, size;
+    int packet_type, packets = 0;
+
+    memset(buf, 0, data_size);
+    for (packet_type = 1; packet_type <= 5; packet_type += 2) {
+        size = fixture_vorbis_header(buf + offset + 0x02, packet_type);
+        put_16bitLE(buf + offset, (size << 2) | (packet_type == 1));
+        offset += 0x02 + size;
+    }
+    while (offset + 0x02 + FIXTURE_VORBIS_PACKET_MAX <= data_size) {
+        size = fixture_vorbis_packet(buf + offset + 0x02);
+        put_16bitLE(buf + offset, size << 2);
+        offset += 0x02 + size;
+        packets++;
+    }
+
+    put_32bitLE(buf + 0x00, 0); /* no loop */
+    put_32bitLE(buf + 0x0c, (packets - 1) * 128);
+    put_32bitLE(buf + 0x10, offset);
+    return offset;
+}
+
+/* Ogg's CRC-32 (poly 0x04C11DB7), of the whole page with the CRC field set to 0 */
+static uint32_t fixture_crc32_ogg(const uint8_t * buf, size_t size) {
+    uint32_t crc = 0;
+    size_t i;
+    int j;
+
+    for (i = 0; i < size; i++) {
+        crc ^= (uint32_t)buf[i] << 24;
+        for (j = 0; j < 8; j++) {
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* Ogg: id page, comment + setup page, then audio pages of 64 packets */
+static size_t make_fixture_ogg(uint8_t * buf, size_t data_size) {
+    const int page_packets = 64;
+    const int pages = 2 + (data_size - 0x200) / (0x1b + page_packets * (1 + FIXTURE_VORBIS_PACKET_MAX));
+    size_t offset = 0, size;
+    int page, i, packets = 0;
+
+    memset(buf, 0, data_size);
+    for (page = 0; page < pages; page++) {
+        uint8_t * header = buf + offset;
+        int count = (page == 0) ? 1 : (page == 1) ? 2 : page_packets;
+
+        offset += 0x1b + count;
+        for (i = 0; i < count; i++) {
+            if (page == 0)
+                size = fixture_vorbis_header(buf + offset, 1);
+            else if (page == 1)
+                size = fixture_vorbis_header(buf + offset, i == 0 ? 3 : 5);
+            else {
+                size = fixture_vorbis_packet(buf + offset);
+                packets++;
+            }
+            header[0x1b + i] = size; /* single lacing value as all are smaller than 0xFF */
+            offset += size;
+        }
+
+        memcpy(header + 0x00, "OggS", 4);
+        header[0x04] = 0; /* version */
+        header[0x05] = (page == 0) ? 0x02 : (page + 1 == pages) ? 0x04 : 0x00; /* first/last page */
+        put_32bitLE(header + 0x06, packets ? (packets - 1) * 128 : 0); /* granule: samples at page end */
+        put_32bitLE(header + 0x0a, 0);
+        put_32bitLE(header + 0x0e, 0x76676D73); /* serial */
+        put_32bitLE(header + 0x12, page);
+        put_32bitLE(header + 0x16, 0);
+        header[0x1a] = count;
+        put_32bitLE(header + 0x16, fixture_crc32_ogg(header, buf + offset - header));
+    }
+
+    return offset;
+}
+#endif
+
+/* writes the fixture and returns its actual size (up to data_size) */
+static size_t make_fixture_data(uint8_t * buf, const bench_fixture * fixture) {
+    size_t i, j;
+
+    for (i = 0; i < fixture->data_size; i++)
+        buf[i] = fixture_rand();
+
+    switch(fixture->type) {
+        case FIXTURE_PSX: /* 0x10 frames: shift+filter (valid range), flags (none) */
+            for (i = 0; i < fixture->data_size; i += 0x10) {
+                buf[i+0x00] = ((fixture_rand() % 5) << 4) | (fixture_rand() % 13);
+                buf[i+0x01] = 0;
+            }
+            break;
+
+        case FIXTURE_DSP: /* header with coefs per channel, then 0x08 frames: coef index+scale */
+            memset(buf, 0, 0x60);
+            for (i = 0; i < 2; i++) {
+                for (j = 0; j < 16; j++) {
+                    int16_t coef = (j % 2) ? -(int16_t)(fixture_rand() * 8) : (int16_t)(fixture_rand() * 16);
+                    put_16bitBE(buf + i*0x30 + j*2, coef);
+                }
+            }
+            for (i = 0x60; i < fixture->data_size; i += 0x08) {
+                buf[i+0x00] = ((fixture_rand() % 8) << 4) | (fixture_rand() % 12);
+            }
+            break;
+
+        case FIXTURE_MSADPCM: /* stereo frames: coef index, scale, hist2, hist1 per channel */
+            for (i = 0; i < fixture->data_size; i++) {
+                /* only nibbles that lower/keep the scale, as random ones would make it overflow */
+                static const uint8_t nibbles[9] = { 0x0,0x1,0x2,0x3,0x4,0xC,0xD,0xE,0xF };
+                buf[i] = (nibbles[fixture_rand() % 9] << 4) | nibbles[fixture_rand() % 9];
+            }
+            for (i = 0; i < fixture->data_size; i += 0x800) {
+                buf[i+0x00] = fixture_rand() % 7;
+                buf[i+0x01] = fixture_rand() % 7;
+                put_16bitLE(buf + i+0x02, 16 + fixture_rand());
+                put_16bitLE(buf + i+0x04, 16 + fixture_rand());
+            }
+            break;
+
+        case FIXTURE_XBOX: /* stereo frames: hist+step index per channel */
+            for (i = 0; i < fixture->data_size; i += 0x24*2) {
+                buf[i+0x02] = fixture_rand() % 89;
+                buf[i+0x03] = 0;
+                buf[i+0x06] = fixture_rand() % 89;
+                buf[i+0x07] = 0;
+            }
+            break;
+
+        case FIXTURE_HCA:
+            make_fixture_hca(buf, fixture->data_size);
+            break;
+
+        case FIXTURE_ACM:
+            return make_fixture_acm(buf, fixture->data_size);
+
+#ifdef VGM_USE_VORBIS
+        case FIXTURE_OGL:
+            return make_fixture_ogl(buf, fixture->data_size);
+
+        case FIXTURE_OGG:
+            return make_fixture_ogg(buf, fixture->data_size);
+#endif
+
+        default:
+            break;
+    }
+
+    return fixture->data_size;
+}
+
+static int write_fixtures(const char * dir) {
+    char filename[PATH_LIMIT];
+    FILE *manifest = NULL, *file = NULL;
+    uint8_t *buf = NULL;
+    size_t size;
+    int i;
+
+    /* may not exist yet (existing dirs are fine) */
+#ifdef WIN32
+    if (_mkdir(dir) != 0 && errno != EEXIST) {
+#else
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+#endif
+        fprintf(stderr,"failed creating dir %s: %s\n", dir, strerror(errno));
+        return 0;
+    }
+
+    snprintf(filename,sizeof(filename),"%s/bench.txt", dir);
+    manifest = fopen(filename, "w");
+    if (!manifest) {
+        fprintf(stderr,"failed creating %s\n", filename);
+        goto fail;
+    }
+
+    for (i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++) {
+        const bench_fixture * fixture = &fixtures[i];
+
+        buf = malloc(fixture->data_size);
+        if (!buf) goto fail;
+        size = make_fixture_data(buf, fixture);
+
+        snprintf(filename,sizeof(filename),"%s/%s", dir, fixture->filename);
+        file = fopen(filename, "wb");
+        if (!file || fwrite(buf, 1, size, file) != size) {
+            fprintf(stderr,"failed writing %s\n", filename);
+            goto fail;
+        }
+        fclose(file);
+        file = NULL;
+        free(buf);
+        buf = NULL;
+
+        fprintf(manifest, "%s\n", filename);
+
+        if (!fixture->txth)
+            continue;
+
+        snprintf(filename,sizeof(filename),"%s/%s.txth", dir, fixture->filename);
+        file = fopen(filename, "w");
+        if (!file || fputs(fixture->txth, file) < 0) {
+            fprintf(stderr,"failed writing %s\n", filename);
+            goto fail;
+        }
+        fclose(file);
+        file = NULL;
+    }
+
+    fclose(manifest);
+    printf("wrote fixtures and %s/bench.txt\n", dir);
+    return 1;
+
+fail:
+    if (file) fclose(file);
+    if (manifest) fclose(manifest);
+    free(buf);
+    return 0;
+}
+
+
+/* ************************************************************ */
+
+static int parse_config(bench_config *cfg, int argc, char ** argv) {
+    int opt;
+
+    /* non-zero defaults */
+    cfg->repeats = 3;
+
+    /* don't let getopt print errors to stdout automatically */
+    opterr = 0;
+
+    while ((opt = getopt(argc, argv, "m:s:n:jg:t:")) != -1) {
+        switch (opt) {
+            case 'm':
+                cfg->manifest = optarg;
+                break;
+            case 's':
+                cfg->stream_index = atoi(optarg);
+                break;
+            case 'n':
+                cfg->repeats = atoi(optarg);
+                break;
+            case 'j':
+                cfg->print_json = 1;
+                break;
+            case 'g':
+                cfg->fixture_dir = optarg;
+                break;
+            case 't':
+                cfg->stress_threads = atoi(optarg);
+                break;
+            case '?':
+                fprintf(stderr, "Unknown option -%c found\n", optopt);
+                goto fail;
+            default:
+                usage(argv[0]);
+                goto fail;
+        }
+    }
+
+    if (cfg->repeats < 1)
+        cfg->repeats = 1;
+    if (cfg->stress_threads < 0)
+        cfg->stress_threads = 0;
+    if (cfg->stress_threads > BENCH_MAX_THREADS)
+        cfg->stress_threads = BENCH_MAX_THREADS;
+
+    if (!cfg->fixture_dir && !cfg->manifest && optind >= argc) {
+        usage(argv[0]);
+        goto fail;
+    }
+
+    return 1;
+fail:
+    return 0;
+}
+
+int main(int argc, char ** argv) {
+    bench_config cfg;
+    int ok = 1;
+
+    memset(&cfg, 0, sizeof(cfg));
+    if (!parse_config(&cfg, argc, argv))
+        return EXIT_FAILURE;
+
+    if (cfg.fixture_dir)
+        return write_fixtures(cfg.fixture_dir) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if (cfg.manifest) {
+        if (!bench_manifest(cfg.manifest, &cfg))
+            ok = 0;
+    }
+
+    for ( ; optind < argc; optind++) {
+        if (!bench_entry(argv[optind], cfg.stream_index, &cfg))
+            ok = 0;
+    }
+
+    if (cfg.stress_threads) {
+        if (!run_stress(&cfg))
+            ok = 0;
+        free(cfg.stress_entries);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
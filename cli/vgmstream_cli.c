@@ -1,13 +1,16 @@
 #define POSIXLY_CORRECT
 #include <getopt.h>
+#include <inttypes.h>
 #include "../src/vgmstream.h"
 #include "../src/plugins.h"
 #include "../src/util.h"
 #ifdef WIN32
 #include <io.h>
 #include <fcntl.h>
+#include <windows.h>
 #else
 #include <unistd.h>
+#include <pthread.h>
 #endif
 
 #ifndef STDOUT_FILENO
@@ -22,6 +25,7 @@
 #endif
 
 #define BUFFER_SAMPLES 0x8000
+#define OUTPUT_ALIGN 0x1000
 
 /* getopt globals (the horror...) */
 extern char * optarg;
@@ -33,6 +37,7 @@ static size_t make_wav_header(uint8_t * buf, size_t buf_size, int32_t sample_cou
 static void usage(const char * name) {
     fprintf(stderr,"vgmstream CLI decoder " VERSION " " __DATE__ "\n"
             "Usage: %s [-o outfile.wav] [options] infile\n"
+            "    (infile can be - to read from stdin, with -n to set its name)\n"
             "Options:\n"
             "    -o outfile.wav: name of output .wav file, default infile.wav\n"
             "    -l loop count: loop count, default 2.0\n"
@@ -46,6 +51,7 @@ static void usage(const char * name) {
             "    -m: print metadata only, don't decode\n"
             "    -L: append a smpl chunk and create a looping wav\n"
             "    -2 N: only output the Nth (first is 0) set of stereo channels\n"
+            "    -D N: downmix to N (1 or 2) channels\n"
             "    -p: output to stdout (for piping into another program)\n"
             "    -P: output to stdout even if stdout is a terminal\n"
             "    -c: loop forever (continuously) to stdout\n"
@@ -54,6 +60,11 @@ static void usage(const char * name) {
             "    -b: decode and print batch variable commands\n"
             "    -r: output a second file after resetting (for testing)\n"
             "    -t file: print if tags are found in file\n"
+            "    -n name: filename for stdin input, used to detect the format and find companion files\n"
+            "    -C: print I/O and decode counters to stderr when done\n"
+            "    -k dir: cache results of slow open-time scans in dir, to open the same files faster\n"
+            "    -M N: keep decoded loops up to N MB in memory, to repeat loops faster\n"
+            "    -j N: decode using N threads (for long files, only with simple codecs)\n"
             , name);
 }
 
@@ -62,6 +73,10 @@ typedef struct {
     char * infilename;
     char * outfilename;
     char * tag_filename;
+    char * stdin_filename;
+    char * scan_cache_dir;
+    int loop_cache_mb;
+    int parallel_threads;
     int ignore_loop;
     int force_loop;
     int really_force_loop;
@@ -73,8 +88,10 @@ typedef struct {
     int print_oggenc;
     int print_batchvar;
     int test_reset;
+    int print_counters;
     int write_lwav;
     int only_stereo;
+    int downmix_channels;
     int stream_index;
     double loop_count;
     double fade_time;
@@ -99,7 +116,7 @@ static int parse_config(cli_config *cfg, int argc, char ** argv) {
     opterr = 0;
 
     /* read config */
-    while ((opt = getopt(argc, argv, "o:l:f:d:ipPcmxeLEFrgb2:s:t:")) != -1) {
+    while ((opt = getopt(argc, argv, "o:l:f:d:ipPcmxeLEFrgb2:D:s:t:n:Ck:M:j:")) != -1) {
         switch (opt) {
             case 'o':
                 cfg->outfilename = optarg;
@@ -153,6 +170,9 @@ static int parse_config(cli_config *cfg, int argc, char ** argv) {
             case '2':
                 cfg->only_stereo = atoi(optarg);
                 break;
+            case 'D':
+                cfg->downmix_channels = atoi(optarg);
+                break;
             case 'F':
                 cfg->ignore_fade = 1;
                 break;
@@ -162,6 +182,21 @@ static int parse_config(cli_config *cfg, int argc, char ** argv) {
             case 't':
                 cfg->tag_filename= optarg;
                 break;
+            case 'n':
+                cfg->stdin_filename = optarg;
+                break;
+            case 'C':
+                cfg->print_counters = 1;
+                break;
+            case 'k':
+                cfg->scan_cache_dir = optarg;
+                break;
+            case 'M':
+                cfg->loop_cache_mb = atoi(optarg);
+                break;
+            case 'j':
+                cfg->parallel_threads = atoi(optarg);
+                break;
             case '?':
                 fprintf(stderr, "Unknown option -%c found\n", optopt);
                 goto fail;
@@ -209,6 +244,18 @@ static int validate_config(cli_config *cfg) {
         fprintf(stderr,"either -p or -o, make up your mind\n");
         goto fail;
     }
+    if (cfg->only_stereo != -1 && cfg->downmix_channels) {
+        fprintf(stderr,"-2 and -D are incompatible\n");
+        goto fail;
+    }
+    if (cfg->downmix_channels && cfg->downmix_channels != 1 && cfg->downmix_channels != 2) {
+        fprintf(stderr,"-D must be 1 or 2\n");
+        goto fail;
+    }
+    if (strcmp(cfg->infilename,"-") == 0 && !cfg->stdin_filename) {
+        fprintf(stderr,"reading from stdin needs -n to set a filename\n");
+        goto fail;
+    }
 
     return 1;
 fail:
@@ -258,7 +305,7 @@ static void print_info(VGMSTREAM * vgmstream, cli_config *cfg) {
     }
 }
 
-static void apply_config(VGMSTREAM * vgmstream, cli_config *cfg) {
+static int apply_config(VGMSTREAM * vgmstream, cli_config *cfg) {
 
     /* honor suggested config, if any (defined order matters)
      * note that ignore_fade and play_forever should take priority */
@@ -310,9 +357,31 @@ static void apply_config(VGMSTREAM * vgmstream, cli_config *cfg) {
         cfg->lwav_loop_end = vgmstream->loop_end_sample;
         vgmstream_force_loop(vgmstream, 0, 0,0);
     }
+
+    /* output channels, done by vgmstream's mixing */
+    if (cfg->only_stereo != -1) {
+        if (!vgmstream_mixing_select(vgmstream, cfg->only_stereo*2, 2)) {
+            fprintf(stderr,"can't output stereo channels %i (file has %i channels)\n", cfg->only_stereo, vgmstream->channels);
+            return 0;
+        }
+    }
+    if (cfg->downmix_channels) {
+        if (!vgmstream_mixing_downmix(vgmstream, cfg->downmix_channels)) {
+            fprintf(stderr,"can't downmix to %i channels\n", cfg->downmix_channels);
+            return 0;
+        }
+    }
+
+    /* not all streams can use it, but output is the same anyway */
+    if (cfg->loop_cache_mb > 0) {
+        vgmstream_set_loop_cache(vgmstream, (size_t)cfg->loop_cache_mb * 1024 * 1024);
+    }
+
+    return 1;
 }
 
 void apply_fade(sample * buf, VGMSTREAM * vgmstream, int to_get, int i, int len_samples, int fade_samples) {
+    int channels = get_vgmstream_output_channels(vgmstream);
     if (vgmstream->loop_flag && fade_samples > 0) {
         int samples_into_fade = i - (len_samples - fade_samples);
         if (samples_into_fade + to_get > 0) {
@@ -320,8 +389,8 @@ void apply_fade(sample * buf, VGMSTREAM * vgmstream, int to_get, int i, int len_
             for (j = 0; j < to_get; j++, samples_into_fade++) {
                 if (samples_into_fade > 0) {
                     double fadedness = (double)(fade_samples - samples_into_fade) / fade_samples;
-                    for (k = 0; k < vgmstream->channels; k++) {
-                        buf[j*vgmstream->channels+k] = (sample)buf[j*vgmstream->channels+k]*fadedness;
+                    for (k = 0; k < channels; k++) {
+                        buf[j*channels+k] = (sample)buf[j*channels+k]*fadedness;
                     }
                 }
             }
@@ -331,17 +400,193 @@ void apply_fade(sample * buf, VGMSTREAM * vgmstream, int to_get, int i, int len_
 
 /* ************************************************************ */
 
+/* Output writer: rendered samples are converted to the output format (PC endian) and written in a background thread, so the next buffer is decoded while the last one is written.
+ * Writes are whole (page-aligned) buffers. If the thread can't be started writes are done directly. */
+#ifdef WIN32
+typedef HANDLE writer_thread_t;
+#else
+typedef pthread_t writer_thread_t;
+#endif
+
+typedef struct {
+    FILE * outfile;
+    int channels;           /* rendered channels */
+
+    uint8_t * alloc;
+    uint8_t * bufs[2];      /* output buffers, one is filled while the other is written */
+    size_t buf_size;
+    int current;            /* buffer to fill next */
+
+    writer_thread_t thread;
+    vgm_mutex_t mutex;
+    vgm_cond_t cond;
+    int thread_started;
+    /* shared with the thread (mutex) */
+    int thread_exit;
+    uint8_t * job;          /* buffer being written, or NULL */
+    size_t job_size;
+} cli_writer;
+
+
+static void writer_work(cli_writer * writer) {
+    vgm_mutex_lock(&writer->mutex);
+    while (1) {
+        while (!writer->thread_exit && !writer->job)
+            vgm_cond_wait(&writer->cond, &writer->mutex);
+        if (!writer->job) /* exit once all is written */
+            break;
+
+        vgm_mutex_unlock(&writer->mutex);
+        fwrite(writer->job, sizeof(uint8_t), writer->job_size, writer->outfile);
+        vgm_mutex_lock(&writer->mutex);
+
+        writer->job = NULL;
+        vgm_cond_broadcast(&writer->cond);
+    }
+    vgm_mutex_unlock(&writer->mutex);
+}
+
+#ifdef WIN32
+static DWORD WINAPI writer_thread(LPVOID arg) {
+    writer_work(arg);
+    return 0;
+}
+#else
+static void *writer_thread(void *arg) {
+    writer_work(arg);
+    return NULL;
+}
+#endif
+
+static int writer_init(cli_writer * writer, int channels) {
+    memset(writer, 0, sizeof(cli_writer));
+    writer->channels = channels;
+
+    writer->buf_size = BUFFER_SAMPLES * channels * sizeof(sample);
+    writer->buf_size = (writer->buf_size + OUTPUT_ALIGN - 1) & ~(size_t)(OUTPUT_ALIGN - 1);
+    writer->alloc = malloc(writer->buf_size * 2 + OUTPUT_ALIGN);
+    if (!writer->alloc) return 0;
+    writer->bufs[0] = (uint8_t*)(((uintptr_t)writer->alloc + OUTPUT_ALIGN - 1) & ~(uintptr_t)(OUTPUT_ALIGN - 1));
+    writer->bufs[1] = writer->bufs[0] + writer->buf_size;
+
+    vgm_mutex_init(&writer->mutex);
+    vgm_cond_init(&writer->cond);
+#ifdef WIN32
+    writer->thread = CreateThread(NULL, 0, writer_thread, writer, 0, NULL);
+    writer->thread_started = (writer->thread != NULL);
+#else
+    writer->thread_started = (pthread_create(&writer->thread, NULL, writer_thread, writer) == 0);
+#endif
+    return 1;
+}
+
+/* waits until the pending write is done */
+static void writer_flush(cli_writer * writer) {
+    if (!writer->thread_started)
+        return;
+
+    vgm_mutex_lock(&writer->mutex);
+    while (writer->job)
+        vgm_cond_wait(&writer->cond, &writer->mutex);
+    vgm_mutex_unlock(&writer->mutex);
+}
+
+static void writer_close(cli_writer * writer) {
+    if (!writer->alloc)
+        return;
+
+    if (writer->thread_started) {
+        vgm_mutex_lock(&writer->mutex);
+        writer->thread_exit = 1;
+        vgm_cond_broadcast(&writer->cond);
+        vgm_mutex_unlock(&writer->mutex);
+#ifdef WIN32
+        WaitForSingleObject(writer->thread, INFINITE);
+        CloseHandle(writer->thread);
+#else
+        pthread_join(writer->thread, NULL);
+#endif
+    }
+    vgm_cond_destroy(&writer->cond);
+    vgm_mutex_destroy(&writer->mutex);
+
+    free(writer->alloc);
+    writer->alloc = NULL;
+}
+
+/* converts and queues to_get rendered samples (per channel) to be written to outfile */
+static void writer_write(cli_writer * writer, FILE * outfile, sample * buf, int to_get) {
+    uint8_t * out = writer->bufs[writer->current];
+    int count = to_get * writer->channels;
+    size_t out_size = count * sizeof(sample);
+    int j;
+
+    /* PC endian (simple loop so compilers can vectorize it) */
+    for (j = 0; j < count; j++) {
+        out[j*2 + 0] = (uint8_t)(buf[j] >> 0);
+        out[j*2 + 1] = (uint8_t)(buf[j] >> 8);
+    }
+
+    if (!writer->thread_started) {
+        fwrite(out, sizeof(uint8_t), out_size, outfile);
+        return;
+    }
+
+    /* the other buffer may still be written, wait until it's done to queue this one */
+    vgm_mutex_lock(&writer->mutex);
+    while (writer->job)
+        vgm_cond_wait(&writer->cond, &writer->mutex);
+    writer->outfile = outfile;
+    writer->job = out;
+    writer->job_size = out_size;
+    vgm_cond_broadcast(&writer->cond);
+    vgm_mutex_unlock(&writer->mutex);
+
+    writer->current ^= 1;
+}
+
+/* ************************************************************ */
+
+static void print_file_counters(VGMSTREAM_FILE_COUNTERS * file) {
+    fprintf(stderr, "- file '%s': opens=%"PRIu64" reads=%"PRIu64" read bytes=%"PRIu64" buffer misses=%"PRIu64" refills=%"PRIu64" io bytes=%"PRIu64"\n",
+            file->name, file->opens, file->read_calls, file->read_bytes,
+            file->buffer_misses, file->buffer_refills, file->io_bytes);
+}
+
+static void print_counters(VGMSTREAM_COUNTERS * counters) {
+    int i;
+
+    fprintf(stderr, "counters:\n");
+    for (i = 0; i < counters->files_count; i++) {
+        print_file_counters(&counters->files[i]);
+    }
+    if (counters->other_files.opens)
+        print_file_counters(&counters->other_files);
+
+    fprintf(stderr, "- decode: calls=%"PRIu64" samples=%"PRIu64" time=%.3f ms",
+            counters->decode_calls, counters->decode_samples, counters->decode_time / 1000000.0);
+    if (counters->decode_samples)
+        fprintf(stderr, " (%.1f ns/sample)", (double)counters->decode_time / counters->decode_samples);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "- samples discarded=%"PRIu64" loops=%"PRIu64" resets=%"PRIu64"\n",
+            counters->samples_discarded, counters->loops, counters->resets);
+}
+
 int main(int argc, char ** argv) {
     VGMSTREAM * vgmstream = NULL;
+    STREAMFILE * streamFile = NULL;
+    VGMSTREAM_PARALLEL * parallel = NULL;
     FILE * outfile = NULL;
     char outfilename_temp[PATH_LIMIT];
 
     sample * buf = NULL;
+    cli_writer writer = {0};
     int32_t len_samples;
     int32_t fade_samples;
-    int i, j;
+    int i;
 
     cli_config cfg = {0};
+    VGMSTREAM_COUNTERS * counters = NULL;
     int res;
 
 
@@ -354,24 +599,48 @@ int main(int argc, char ** argv) {
     if (cfg.play_sdtout) {
         _setmode(fileno(stdout),_O_BINARY);
     }
+    if (strcmp(cfg.infilename,"-") == 0) {
+        _setmode(fileno(stdin),_O_BINARY);
+    }
 #endif
 
     res = validate_config(&cfg);
     if (!res) goto fail;
 
+    if (cfg.print_counters) {
+        counters = calloc(1, sizeof(VGMSTREAM_COUNTERS));
+        if (!counters) goto fail;
+    }
+
+    if (cfg.scan_cache_dir)
+        vgmstream_set_scan_cache(cfg.scan_cache_dir);
+
 
     /* open streamfile and pass subsong */
     {
         //s = init_vgmstream(infilename);
-        STREAMFILE *streamFile = open_stdio_streamfile(cfg.infilename);
+
+        if (strcmp(cfg.infilename,"-") == 0) {
+            /* stdin data is kept by the STREAMFILE, so from here on it works like a file of that name */
+            cfg.infilename = cfg.stdin_filename;
+            streamFile = open_pipe_streamfile(stdin, cfg.infilename, 0);
+            cfg.parallel_threads = 0; /* not thread-safe */
+        }
+        else {
+            streamFile = open_stdio_streamfile(cfg.infilename);
+        }
         if (!streamFile) {
             fprintf(stderr,"file %s not found\n",cfg.infilename);
             goto fail;
         }
 
         streamFile->stream_index = cfg.stream_index;
+        streamFile->counters = counters;
         vgmstream = init_vgmstream_from_STREAMFILE(streamFile);
-        close_streamfile(streamFile);
+        if (cfg.parallel_threads <= 1 || cfg.play_forever) {
+            close_streamfile(streamFile); /* otherwise kept to open copies of the stream */
+            streamFile = NULL;
+        }
 
         if (!vgmstream) {
             fprintf(stderr,"failed opening %s\n",cfg.infilename);
@@ -381,7 +650,8 @@ int main(int argc, char ** argv) {
 
 
     /* modify the VGMSTREAM if needed */
-    apply_config(vgmstream, &cfg);
+    if (!apply_config(vgmstream, &cfg))
+        goto fail;
 
     if (cfg.play_forever && (!vgmstream->loop_flag || vgmstream->loop_target > 0)) {
         fprintf(stderr,"I could play a nonlooped track forever, but it wouldn't end well.");
@@ -438,7 +708,10 @@ int main(int argc, char ** argv) {
               fclose(outfile);
             }
         }
+        close_streamfile(streamFile);
         close_vgmstream(vgmstream);
+        if (counters) print_counters(counters);
+        free(counters);
         return EXIT_SUCCESS;
     }
 
@@ -452,9 +725,20 @@ int main(int argc, char ** argv) {
     }
 
 
+    /* decode in parallel (output is the same) */
+    if (streamFile) {
+        parallel = vgmstream_parallel_open(vgmstream, streamFile, cfg.parallel_threads, len_samples);
+        if (!parallel) {
+            fprintf(stderr,"can't decode this stream in parallel, decoding normally\n");
+        }
+        close_streamfile(streamFile);
+        streamFile = NULL;
+    }
+
+
     /* last init */
-    buf = malloc(BUFFER_SAMPLES*sizeof(sample)*vgmstream->channels);
-    if (!buf) {
+    buf = malloc(BUFFER_SAMPLES*sizeof(sample)*get_vgmstream_output_channels(vgmstream));
+    if (!buf || !writer_init(&writer, get_vgmstream_output_channels(vgmstream))) {
         fprintf(stderr,"failed allocating output buffer\n");
         goto fail;;
     }
@@ -462,7 +746,7 @@ int main(int argc, char ** argv) {
     /* slap on a .wav header */
     {
         uint8_t wav_buf[0x100];
-        int channels = (cfg.only_stereo != -1) ? 2 : vgmstream->channels;
+        int channels = get_vgmstream_output_channels(vgmstream);
         size_t bytes_done;
 
         bytes_done = make_wav_header(wav_buf,0x100,
@@ -479,14 +763,7 @@ int main(int argc, char ** argv) {
 
         render_vgmstream(buf,to_get,vgmstream);
 
-        swap_samples_le(buf,vgmstream->channels*to_get); /* write PC endian */
-        if (cfg.only_stereo != -1) {
-            for (j = 0; j < to_get; j++) {
-                fwrite(buf+j*vgmstream->channels+(cfg.only_stereo*2),sizeof(sample),2,outfile);
-            }
-        } else {
-            fwrite(buf,sizeof(sample)*vgmstream->channels,to_get,outfile);
-        }
+        writer_write(&writer, outfile, buf, to_get);
     }
 
 
@@ -496,22 +773,21 @@ int main(int argc, char ** argv) {
         if (i + BUFFER_SAMPLES > len_samples)
             to_get = len_samples - i;
 
-        render_vgmstream(buf,to_get,vgmstream);
+        if (parallel)
+            vgmstream_parallel_render(parallel,buf,to_get);
+        else
+            render_vgmstream(buf,to_get,vgmstream);
 
         apply_fade(buf, vgmstream, to_get, i, len_samples, fade_samples);
 
-        swap_samples_le(buf,vgmstream->channels*to_get); /* write PC endian */
-        if (cfg.only_stereo != -1) {
-            for (j = 0; j < to_get; j++) {
-                fwrite(buf+j*vgmstream->channels+(cfg.only_stereo*2),sizeof(sample),2,outfile);
-            }
-        } else {
-            fwrite(buf,sizeof(sample)*vgmstream->channels,to_get,outfile);
-        }
+        writer_write(&writer, outfile, buf, to_get);
     }
 
+    writer_flush(&writer);
     fclose(outfile);
     outfile = NULL;
+    vgmstream_parallel_close(parallel);
+    parallel = NULL;
 
 
     /* try again with (for testing reset_vgmstream, simulates a seek to 0) */
@@ -529,13 +805,14 @@ int main(int argc, char ** argv) {
         reset_vgmstream(vgmstream);
 
         /* vgmstream manipulations are undone by reset */
-        apply_config(vgmstream, &cfg);
+        if (!apply_config(vgmstream, &cfg))
+            goto fail;
 
 
         /* slap on a .wav header */
         {
             uint8_t wav_buf[0x100];
-            int channels = (cfg.only_stereo != -1) ? 2 : vgmstream->channels;
+            int channels = get_vgmstream_output_channels(vgmstream);
             size_t bytes_done;
 
             bytes_done = make_wav_header(wav_buf,0x100,
@@ -555,25 +832,26 @@ int main(int argc, char ** argv) {
 
             apply_fade(buf, vgmstream, to_get, i, len_samples, fade_samples);
 
-            swap_samples_le(buf,vgmstream->channels*to_get); /* write PC endian */
-            if (cfg.only_stereo != -1) {
-                for (j = 0; j < to_get; j++) {
-                    fwrite(buf+j*vgmstream->channels+(cfg.only_stereo*2),sizeof(sample),2,outfile);
-                }
-            } else {
-                fwrite(buf,sizeof(sample)*vgmstream->channels,to_get,outfile);
-            }
+            writer_write(&writer, outfile, buf, to_get);
         }
+        writer_flush(&writer);
         fclose(outfile);
         outfile = NULL;
     }
 
+    writer_close(&writer);
     close_vgmstream(vgmstream);
     free(buf);
 
+    if (counters) print_counters(counters);
+    free(counters);
+
     return EXIT_SUCCESS;
 
 fail:
+    vgmstream_parallel_close(parallel);
+    close_streamfile(streamFile);
+    writer_close(&writer);
     if (!cfg.play_sdtout)
     {
         if (outfile != NULL)
@@ -582,6 +860,8 @@ fail:
         }
     }
     close_vgmstream(vgmstream);
+    free(buf);
+    free(counters);
     return EXIT_FAILURE;
 }
 
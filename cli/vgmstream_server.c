@@ -0,0 +1,745 @@
+#define POSIXLY_CORRECT
+#include <getopt.h>
+#include "../src/vgmstream.h"
+#include "../src/util.h"
+#include <stdarg.h>
+#ifndef WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#endif
+
+#ifndef VERSION
+#include "../version.h"
+#endif
+#ifndef VERSION
+#define VERSION "(unknown version)"
+#endif
+
+/* Decode server: keeps opened streams around so clients that open the same files often (previews,
+ * range requests) don't pay parsing and codec setup each time. Listens on a local Unix socket and
+ * serves one text command per line, replying "OK ..." or "ERR message":
+ *   OPEN subsong filename  > OK channels sample_rate num_samples (subsong 0 = default)
+ *   INFO                   > OK, then key=value lines, then an empty line
+ *   SEEK sample            > OK sample
+ *   READ samples           > OK samples, then samples * channels of 16-bit LE PCM (fewer at the end)
+ *   QUIT
+ * Streams play once from start to end without loops, and are shared between connections through a
+ * cache of idle streams (by file and subsong), reusing the one closest before the wanted position.
+ *
+ * The main thread polls all connections and passes each received command to a pool of workers,
+ * so idle clients don't hold workers and commands from many clients are served in turns. */
+
+#define SERVER_BUFFER_SAMPLES 0x1000
+#define SERVER_MAX_LINE (PATH_LIMIT + 0x40)
+#define SERVER_MAX_QUEUE 64         /* pending connects */
+#define SERVER_SEND_TIMEOUT 30      /* seconds, so clients that stop reading can't hold a worker */
+
+/* getopt globals (the horror...) */
+extern char * optarg;
+extern int optind, opterr, optopt;
+
+
+static void usage(const char * name) {
+    fprintf(stderr,"vgmstream server " VERSION " " __DATE__ "\n"
+            "Usage: %s [options] socket\n"
+            "Options:\n"
+            "    -n N: max idle streams kept open, default 16\n"
+            "    -j N: commands served at once (decode threads), default 4\n"
+            , name);
+}
+
+#ifndef WIN32
+
+typedef struct {
+    int max_streams;
+    int threads;
+    const char * socket_path;
+} server_config;
+
+typedef struct {
+    char filename[PATH_LIMIT];
+    int stream_index;
+    VGMSTREAM * vgmstream;
+    int32_t position;       /* samples rendered since open or reset */
+    uint32_t last_use;      /* LRU */
+
+    /* info (removed from vgmstream) */
+    int loop_flag;
+    int32_t loop_start_sample;
+    int32_t loop_end_sample;
+} server_stream;
+
+typedef struct {
+    server_stream ** streams; /* idle streams (taken out while in use) */
+    int count;
+    int max;
+    uint32_t use_count;
+    pthread_mutex_t mutex;
+} server_cache;
+
+typedef struct server_connection {
+    int socket;
+    char line[SERVER_MAX_LINE]; /* current command */
+    char input[SERVER_MAX_LINE];
+    size_t input_size;
+    int busy;               /* command passed to a worker (not polled), only changed by the main thread */
+    int closing;            /* QUIT, disconnect or send error */
+    struct server_connection * next; /* in the job or done lists */
+
+    /* current stream */
+    int is_open;
+    char filename[PATH_LIMIT];
+    int stream_index;
+    int channels;
+    int32_t num_samples;
+    int32_t position;
+    sample * buffer;        /* SERVER_BUFFER_SAMPLES * channels */
+} server_connection;
+
+typedef struct {
+    server_cache * cache;
+
+    server_connection * jobs; /* connections with a command to run, in order */
+    server_connection * jobs_last;
+    server_connection * done; /* connections back from workers */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} server_state;
+
+static volatile sig_atomic_t server_exit = 0;
+static int wake_pipe[2] = { -1, -1 }; /* wakes up the main thread's poll */
+
+
+/* ************************************************************ */
+
+static void close_stream(server_stream * stream) {
+    if (!stream) return;
+    close_vgmstream(stream->vgmstream);
+    free(stream);
+}
+
+static server_stream * open_stream(const char * filename, int stream_index) {
+    STREAMFILE *streamFile = NULL;
+    server_stream * stream = NULL;
+
+    stream = calloc(1, sizeof(server_stream));
+    if (!stream) goto fail;
+    snprintf(stream->filename,sizeof(stream->filename),"%s", filename);
+    stream->stream_index = stream_index;
+
+    /* each open has its own STREAMFILE, so workers can open at once */
+    streamFile = open_stdio_streamfile(filename);
+    if (!streamFile) goto fail;
+    streamFile->stream_index = stream_index;
+    stream->vgmstream = init_vgmstream_from_STREAMFILE(streamFile);
+    close_streamfile(streamFile);
+    if (!stream->vgmstream) goto fail;
+
+    /* plays once, so positions map to file samples */
+    stream->loop_flag = stream->vgmstream->loop_flag;
+    stream->loop_start_sample = stream->vgmstream->loop_start_sample;
+    stream->loop_end_sample = stream->vgmstream->loop_end_sample;
+    vgmstream_force_loop(stream->vgmstream, 0, 0, 0);
+    return stream;
+
+fail:
+    close_stream(stream);
+    return NULL;
+}
+
+/* Takes the idle stream that needs the least decoding to reach position (one before it, or any to be
+ * reset), or opens a new one. */
+static server_stream * take_stream(server_cache * cache, const char * filename, int stream_index, int32_t position) {
+    server_stream * stream = NULL;
+    int i, index = -1;
+
+    pthread_mutex_lock(&cache->mutex);
+    for (i = 0; i < cache->count; i++) {
+        server_stream * current = cache->streams[i];
+        if (current->stream_index != stream_index || strcmp(current->filename, filename) != 0)
+            continue;
+
+        if (index < 0) {
+            index = i;
+            continue;
+        }
+        if (current->position <= position &&
+                (cache->streams[index]->position > position || current->position > cache->streams[index]->position))
+            index = i;
+    }
+    if (index >= 0) {
+        stream = cache->streams[index];
+        cache->count--;
+        cache->streams[index] = cache->streams[cache->count];
+    }
+    pthread_mutex_unlock(&cache->mutex);
+
+    if (stream)
+        return stream;
+    return open_stream(filename, stream_index);
+}
+
+/* Returns a stream to the cache, closing the least recently used one if full. */
+static void put_stream(server_cache * cache, server_stream * stream) {
+    server_stream * evicted = NULL;
+    int i, index = 0;
+
+    pthread_mutex_lock(&cache->mutex);
+    stream->last_use = ++cache->use_count;
+    if (cache->count < cache->max) {
+        cache->streams[cache->count] = stream;
+        cache->count++;
+    }
+    else {
+        for (i = 1; i < cache->count; i++) {
+            if (cache->streams[i]->last_use < cache->streams[index]->last_use)
+                index = i;
+        }
+        evicted = cache->streams[index];
+        cache->streams[index] = stream;
+    }
+    pthread_mutex_unlock(&cache->mutex);
+
+    close_stream(evicted);
+}
+
+
+/* ************************************************************ */
+
+static int send_data(server_connection * conn, const void * data, size_t size) {
+    const uint8_t * buf = data;
+
+    while (size > 0) {
+        ssize_t bytes = send(conn->socket, buf, size, 0);
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        if (bytes <= 0)
+            return 0;
+        buf += bytes;
+        size -= bytes;
+    }
+    return 1;
+}
+
+static int send_line(server_connection * conn, const char * fmt, ...) {
+    char line[SERVER_MAX_LINE];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(line, sizeof(line) - 1, fmt, args);
+    va_end(args);
+    if (len < 0 || len >= sizeof(line) - 1)
+        return 0;
+    line[len] = '\n';
+    return send_data(conn, line, len + 1);
+}
+
+/* reads what the client sent after poll, returns 0 on disconnect */
+static int read_input(server_connection * conn) {
+    ssize_t bytes;
+
+    if (conn->input_size >= sizeof(conn->input))
+        return 0;
+    bytes = recv(conn->socket, conn->input + conn->input_size, sizeof(conn->input) - conn->input_size, 0);
+    if (bytes < 0 && errno == EINTR)
+        return 1;
+    if (bytes <= 0)
+        return 0;
+    conn->input_size += bytes;
+    return 1;
+}
+
+
+static int command_open(server_connection * conn, server_cache * cache, const char * args) {
+    server_stream * stream;
+    int stream_index, sample_rate, args_used = 0;
+
+    if (sscanf(args, "%d %n", &stream_index, &args_used) != 1 || args[args_used] == '\0')
+        return send_line(conn, "ERR usage: OPEN subsong filename");
+
+    stream = take_stream(cache, args + args_used, stream_index, 0);
+    if (!stream)
+        return send_line(conn, "ERR can't open %s", args + args_used);
+
+    free(conn->buffer);
+    conn->buffer = malloc(SERVER_BUFFER_SAMPLES * stream->vgmstream->channels * sizeof(sample));
+    if (!conn->buffer) {
+        conn->is_open = 0;
+        put_stream(cache, stream);
+        return send_line(conn, "ERR out of memory");
+    }
+
+    conn->is_open = 1;
+    snprintf(conn->filename,sizeof(conn->filename),"%s", args + args_used);
+    conn->stream_index = stream_index;
+    conn->channels = stream->vgmstream->channels;
+    conn->num_samples = stream->vgmstream->num_samples;
+    conn->position = 0;
+    sample_rate = stream->vgmstream->sample_rate;
+    put_stream(cache, stream); /* may be closed by others from now on */
+
+    return send_line(conn, "OK %i %i %i", conn->channels, sample_rate, conn->num_samples);
+}
+
+static int command_info(server_connection * conn, server_cache * cache) {
+    server_stream * stream;
+    VGMSTREAM * vgmstream;
+    int ok;
+
+    if (!conn->is_open)
+        return send_line(conn, "ERR no stream open");
+    stream = take_stream(cache, conn->filename, conn->stream_index, conn->position);
+    if (!stream)
+        return send_line(conn, "ERR can't open %s", conn->filename);
+    if (stream->vgmstream->channels != conn->channels) {
+        put_stream(cache, stream);
+        return send_line(conn, "ERR %s changed, OPEN again", conn->filename);
+    }
+    vgmstream = stream->vgmstream;
+
+    ok = send_line(conn, "OK") &&
+        send_line(conn, "channels=%i", vgmstream->channels) &&
+        send_line(conn, "sample_rate=%i", vgmstream->sample_rate) &&
+        send_line(conn, "num_samples=%i", vgmstream->num_samples) &&
+        send_line(conn, "loop_flag=%i", stream->loop_flag) &&
+        send_line(conn, "loop_start=%i", stream->loop_start_sample) &&
+        send_line(conn, "loop_end=%i", stream->loop_end_sample) &&
+        send_line(conn, "stream_count=%i", vgmstream->num_streams) &&
+        send_line(conn, "stream_name=%s", vgmstream->stream_name) &&
+        send_line(conn, "coding=%s", get_vgmstream_coding_description(vgmstream->coding_type)) &&
+        send_line(conn, "layout=%s", get_vgmstream_layout_description(vgmstream->layout_type)) &&
+        send_line(conn, "meta=%s", get_vgmstream_meta_description(vgmstream->meta_type)) &&
+        send_line(conn, "");
+
+    put_stream(cache, stream);
+    return ok;
+}
+
+static int command_seek(server_connection * conn, const char * args) {
+    int32_t position;
+
+    if (!conn->is_open)
+        return send_line(conn, "ERR no stream open");
+    if (sscanf(args, "%d", &position) != 1 || position < 0)
+        return send_line(conn, "ERR usage: SEEK sample");
+
+    if (position > conn->num_samples)
+        position = conn->num_samples;
+    conn->position = position;
+    return send_line(conn, "OK %i", conn->position);
+}
+
+static int command_read(server_connection * conn, server_cache * cache, const char * args) {
+    server_stream * stream;
+    int32_t samples;
+    int ok;
+
+    if (!conn->is_open)
+        return send_line(conn, "ERR no stream open");
+    if (sscanf(args, "%d", &samples) != 1 || samples < 0)
+        return send_line(conn, "ERR usage: READ samples");
+
+    stream = take_stream(cache, conn->filename, conn->stream_index, conn->position);
+    if (!stream)
+        return send_line(conn, "ERR can't open %s", conn->filename);
+    /* reopened file may not fit conn->buffer anymore */
+    if (stream->vgmstream->channels != conn->channels) {
+        put_stream(cache, stream);
+        return send_line(conn, "ERR %s changed, OPEN again", conn->filename);
+    }
+
+    /* seek (decode and discard) from the stream's position, or from the start if past it */
+    if (stream->position > conn->position) {
+        reset_vgmstream(stream->vgmstream);
+        stream->position = 0;
+    }
+    while (stream->position < conn->position) {
+        int32_t to_do = SERVER_BUFFER_SAMPLES;
+        if (to_do > conn->position - stream->position)
+            to_do = conn->position - stream->position;
+        render_vgmstream(conn->buffer, to_do, stream->vgmstream);
+        stream->position += to_do;
+    }
+
+    if (samples > conn->num_samples - conn->position)
+        samples = conn->num_samples - conn->position;
+    ok = send_line(conn, "OK %i", samples);
+    while (ok && samples > 0) {
+        int32_t to_do = SERVER_BUFFER_SAMPLES;
+        if (to_do > samples)
+            to_do = samples;
+
+        render_vgmstream(conn->buffer, to_do, stream->vgmstream);
+        stream->position += to_do;
+        conn->position += to_do;
+        samples -= to_do;
+
+        swap_samples_le(conn->buffer, to_do * conn->channels);
+        ok = send_data(conn, conn->buffer, to_do * conn->channels * sizeof(sample));
+    }
+
+    /* a partial send leaves the stream somewhere else but it's still usable */
+    put_stream(cache, stream);
+    return ok;
+}
+
+/* runs conn->line, returns 0 if the connection must be closed */
+static int serve_command(server_connection * conn, server_cache * cache) {
+    char * args = strchr(conn->line, ' ');
+
+    if (args)
+        *args++ = '\0';
+    else
+        args = "";
+
+    if (strcmp(conn->line, "OPEN") == 0)
+        return command_open(conn, cache, args);
+    else if (strcmp(conn->line, "INFO") == 0)
+        return command_info(conn, cache);
+    else if (strcmp(conn->line, "SEEK") == 0)
+        return command_seek(conn, args);
+    else if (strcmp(conn->line, "READ") == 0)
+        return command_read(conn, cache, args);
+    else
+        return send_line(conn, "ERR unknown command");
+}
+
+static void wake_server(void) {
+    char c = 0;
+    ssize_t bytes = write(wake_pipe[1], &c, 1); /* a full pipe will wake it up anyway */
+    (void)bytes;
+}
+
+static void * worker_thread(void * arg) {
+    server_state * state = arg;
+
+    while (1) {
+        server_connection * conn;
+
+        pthread_mutex_lock(&state->mutex);
+        while (!state->jobs)
+            pthread_cond_wait(&state->cond, &state->mutex);
+        conn = state->jobs;
+        state->jobs = conn->next;
+        if (!state->jobs)
+            state->jobs_last = NULL;
+        pthread_mutex_unlock(&state->mutex);
+
+        conn->closing = !serve_command(conn, state->cache);
+
+        /* back to the main thread, to poll for the next command */
+        pthread_mutex_lock(&state->mutex);
+        conn->next = state->done;
+        state->done = conn;
+        pthread_mutex_unlock(&state->mutex);
+        wake_server();
+    }
+
+    return NULL;
+}
+
+/* Passes the next buffered command of an idle connection to the workers (if complete).
+ * Returns 0 if the connection must be closed (QUIT or overlong lines). */
+static int queue_command(server_state * state, server_connection * conn) {
+    char * end = memchr(conn->input, '\n', conn->input_size);
+    size_t line_size;
+
+    if (!end)
+        return conn->input_size < sizeof(conn->input); /* wait for the rest */
+
+    line_size = end - conn->input;
+    memcpy(conn->line, conn->input, line_size);
+    conn->line[line_size] = '\0';
+    if (line_size > 0 && conn->line[line_size - 1] == '\r')
+        conn->line[line_size - 1] = '\0';
+    conn->input_size -= line_size + 1;
+    memmove(conn->input, end + 1, conn->input_size);
+
+    if (strcmp(conn->line, "QUIT") == 0)
+        return 0;
+
+    conn->busy = 1;
+    conn->next = NULL;
+    pthread_mutex_lock(&state->mutex);
+    if (state->jobs_last)
+        state->jobs_last->next = conn;
+    else
+        state->jobs = conn;
+    state->jobs_last = conn;
+    pthread_cond_signal(&state->cond);
+    pthread_mutex_unlock(&state->mutex);
+    return 1;
+}
+
+static void close_connection(server_connection * conn) {
+    close(conn->socket);
+    free(conn->buffer);
+    free(conn);
+}
+
+
+/* ************************************************************ */
+
+static void signal_exit(int sig) {
+    int saved_errno = errno;
+    server_exit = 1;
+    wake_server();
+    errno = saved_errno;
+}
+
+static int parse_config(server_config *cfg, int argc, char ** argv) {
+    int opt;
+
+    /* non-zero defaults */
+    cfg->max_streams = 16;
+    cfg->threads = 4;
+
+    /* don't let getopt print errors to stdout automatically */
+    opterr = 0;
+
+    while ((opt = getopt(argc, argv, "n:j:")) != -1) {
+        switch (opt) {
+            case 'n':
+                cfg->max_streams = atoi(optarg);
+                break;
+            case 'j':
+                cfg->threads = atoi(optarg);
+                break;
+            case '?':
+                fprintf(stderr, "Unknown option -%c found\n", optopt);
+                goto fail;
+            default:
+                usage(argv[0]);
+                goto fail;
+        }
+    }
+
+    if (cfg->max_streams < 1)
+        cfg->max_streams = 1;
+    if (cfg->threads < 1)
+        cfg->threads = 1;
+
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+        goto fail;
+    }
+    cfg->socket_path = argv[optind];
+
+    return 1;
+fail:
+    return 0;
+}
+
+/* adds an accepted client, returns 0 if out of memory */
+static int add_connection(server_connection *** conns, int * conn_count, int * conn_max,
+        struct pollfd ** fds, server_connection *** fds_conns, int client_socket) {
+    server_connection * conn;
+    struct timeval timeout;
+
+    if (*conn_count == *conn_max) {
+        int max = *conn_max ? *conn_max * 2 : 16;
+        void * ptr;
+
+        ptr = realloc(*conns, max * sizeof(server_connection *));
+        if (!ptr) return 0;
+        *conns = ptr;
+        ptr = realloc(*fds, (2 + max) * sizeof(struct pollfd));
+        if (!ptr) return 0;
+        *fds = ptr;
+        ptr = realloc(*fds_conns, (2 + max) * sizeof(server_connection *));
+        if (!ptr) return 0;
+        *fds_conns = ptr;
+        *conn_max = max;
+    }
+
+    conn = calloc(1, sizeof(server_connection));
+    if (!conn) return 0;
+    conn->socket = client_socket;
+
+    /* replies are sent blocking from workers (some systems inherit the listen socket's O_NONBLOCK) */
+    fcntl(client_socket, F_SETFL, fcntl(client_socket, F_GETFL) & ~O_NONBLOCK);
+    timeout.tv_sec = SERVER_SEND_TIMEOUT;
+    timeout.tv_usec = 0;
+    setsockopt(client_socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    (*conns)[*conn_count] = conn;
+    (*conn_count)++;
+    return 1;
+}
+
+int main(int argc, char ** argv) {
+    server_config cfg;
+    server_cache cache;
+    server_state state;
+    struct sockaddr_un address;
+    struct sigaction action;
+    sigset_t signals, old_signals;
+    server_connection ** conns = NULL;  /* main thread only */
+    int conn_count = 0, conn_max = 0;
+    struct pollfd * fds = NULL;         /* wake pipe, listen socket, then idle connections */
+    server_connection ** fds_conns = NULL;
+    int listen_socket = -1;
+    int i, j;
+
+    memset(&cfg, 0, sizeof(cfg));
+    if (!parse_config(&cfg, argc, argv))
+        return EXIT_FAILURE;
+
+    memset(&cache, 0, sizeof(cache));
+    cache.max = cfg.max_streams;
+    cache.streams = calloc(cache.max, sizeof(server_stream *));
+    if (!cache.streams) goto fail;
+    pthread_mutex_init(&cache.mutex, NULL);
+
+    memset(&state, 0, sizeof(state));
+    state.cache = &cache;
+    pthread_mutex_init(&state.mutex, NULL);
+    pthread_cond_init(&state.cond, NULL);
+
+    fds = malloc(2 * sizeof(struct pollfd));
+    if (!fds) goto fail;
+
+    if (pipe(wake_pipe) != 0) goto fail;
+    fcntl(wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK);
+
+    /* closed clients shouldn't kill the server, and exit signals must wake up poll */
+    signal(SIGPIPE, SIG_IGN);
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signal_exit;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(cfg.socket_path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "socket path too long\n");
+        goto fail;
+    }
+    strcpy(address.sun_path, cfg.socket_path);
+
+    listen_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_socket < 0) goto fail;
+    unlink(cfg.socket_path); /* left by a previous run */
+    if (bind(listen_socket, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listen_socket, SERVER_MAX_QUEUE) != 0) {
+        fprintf(stderr, "failed listening on %s\n", cfg.socket_path);
+        goto fail;
+    }
+    fcntl(listen_socket, F_SETFL, O_NONBLOCK); /* client may be gone by the time it's accepted */
+
+    /* workers inherit blocked exit signals, so they go to the main thread */
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, &old_signals);
+    for (i = 0; i < cfg.threads; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, worker_thread, &state) != 0) {
+            pthread_sigmask(SIG_SETMASK, &old_signals, NULL);
+            fprintf(stderr, "failed creating threads\n");
+            goto fail;
+        }
+        pthread_detach(thread);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_signals, NULL);
+
+    fprintf(stderr, "listening on %s\n", cfg.socket_path);
+    while (!server_exit) {
+        int fds_count = 2;
+
+        /* busy connections are with a worker and return through the done list */
+        fds[0].fd = wake_pipe[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = listen_socket;
+        fds[1].events = POLLIN;
+        for (i = 0; i < conn_count; i++) {
+            if (conns[i]->busy)
+                continue;
+            fds[fds_count].fd = conns[i]->socket;
+            fds[fds_count].events = POLLIN;
+            fds_conns[fds_count] = conns[i];
+            fds_count++;
+        }
+
+        if (poll(fds, fds_count, -1) < 0)
+            continue; /* interrupted */
+
+        if (fds[0].revents & POLLIN) {
+            server_connection * conn;
+            char drain[0x40];
+
+            while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {
+                /* drain all wakes at once */
+            }
+
+            pthread_mutex_lock(&state.mutex);
+            conn = state.done;
+            state.done = NULL;
+            pthread_mutex_unlock(&state.mutex);
+
+            /* clients may have sent more commands already */
+            while (conn) {
+                server_connection * next = conn->next;
+                conn->busy = 0;
+                if (!conn->closing && !queue_command(&state, conn))
+                    conn->closing = 1;
+                conn = next;
+            }
+        }
+
+        for (i = 2; i < fds_count; i++) {
+            server_connection * conn = fds_conns[i];
+            if (!fds[i].revents)
+                continue;
+            /* once queued it belongs to a worker, so only set when closing */
+            if (!read_input(conn) || !queue_command(&state, conn))
+                conn->closing = 1;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int client_socket = accept(listen_socket, NULL, NULL);
+            if (client_socket >= 0 && !add_connection(&conns, &conn_count, &conn_max, &fds, &fds_conns, client_socket))
+                close(client_socket);
+        }
+
+        /* busy first, as workers may set closing */
+        for (i = 0, j = 0; i < conn_count; i++) {
+            if (!conns[i]->busy && conns[i]->closing) {
+                close_connection(conns[i]);
+                continue;
+            }
+            conns[j++] = conns[i];
+        }
+        conn_count = j;
+    }
+
+    /* streams and connections in progress are left to the OS */
+    close(listen_socket);
+    unlink(cfg.socket_path);
+    return EXIT_SUCCESS;
+
+fail:
+    if (listen_socket >= 0) {
+        close(listen_socket);
+        unlink(cfg.socket_path);
+    }
+    return EXIT_FAILURE;
+}
+
+#else
+
+int main(int argc, char ** argv) {
+    usage(argv[0]);
+    fprintf(stderr, "Unix sockets aren't supported in this build\n");
+    return EXIT_FAILURE;
+}
+
+#endif
@@ -59,7 +59,6 @@ typedef struct stChannel {
     float gain[HCA_SAMPLES_PER_SUBFRAME];                   /* gain to apply to quantized spectral data */
     float spectra[HCA_SAMPLES_PER_SUBFRAME];                /* resulting dequantized data */
     float temp[HCA_SAMPLES_PER_SUBFRAME];                   /* temp for DCT-IV */
-    float dct[HCA_SAMPLES_PER_SUBFRAME];                    /* result of DCT-IV */
     float imdct_previous[HCA_SAMPLES_PER_SUBFRAME];         /* IMDCT */
 
     /* frame state */
@@ -284,25 +283,27 @@ int clHCA_getInfo(clHCA *hca, clHCA_stInfo *info) {
 
 void clHCA_ReadSamples16(clHCA *hca, signed short *samples) {
     const float scale = 32768.0f;
-    float f;
-    signed int s;
-    unsigned int i, j, k;
-
-    for (i = 0; i < HCA_SUBFRAMES_PER_FRAME; i++) {
-        for (j = 0; j < HCA_SAMPLES_PER_SUBFRAME; j++) {
-            for (k = 0; k < hca->channels; k++) {
-                f = hca->channel[k].wave[i][j];
-                //f = f * hca->rva_volume; /* rare, won't apply for now */
-                if (f > 1.0f) {
-                    f = 1.0f;
-                } else if (f < -1.0f) {
-                    f = -1.0f;
-                }
-                s = (signed int) (f * scale);
-                if ((unsigned) (s + 0x8000) & 0xFFFF0000)
-                    s = (s >> 31) ^ 0x7FFF;
-                *samples++ = (signed short) s;
+    unsigned int i, k;
+    const unsigned int channels = hca->channels;
+
+    /* convert per channel (waves are contiguous) so compilers can vectorize the clamping */
+    for (k = 0; k < channels; k++) {
+        const float *wave = &hca->channel[k].wave[0][0];
+        signed short *out = &samples[k];
+
+        for (i = 0; i < HCA_SAMPLES_PER_FRAME; i++) {
+            float f = wave[i];
+            signed int s;
+            //f = f * hca->rva_volume; /* rare, won't apply for now */
+            if (f > 1.0f) {
+                f = 1.0f;
+            } else if (f < -1.0f) {
+                f = -1.0f;
             }
+            s = (signed int) (f * scale);
+            if ((unsigned) (s + 0x8000) & 0xFFFF0000)
+                s = (s >> 31) ^ 0x7FFF;
+            out[i * channels] = (signed short) s;
         }
     }
 }
@@ -1001,7 +1002,6 @@ void clHCA_DecodeReset(clHCA * hca) {
         //memset(ch->gain, 0, sizeof(ch->gain[0]) * HCA_SAMPLES_PER_SUBFRAME);
         //memset(ch->spectra, 0, sizeof(ch->spectra[0]) * HCA_SAMPLES_PER_SUBFRAME);
         //memset(ch->temp, 0, sizeof(ch->temp[0]) * HCA_SAMPLES_PER_SUBFRAME);
-        //memset(ch->dct, 0, sizeof(ch->dct[0]) * HCA_SAMPLES_PER_SUBFRAME);
         memset(ch->imdct_previous, 0, sizeof(ch->imdct_previous[0]) * HCA_SAMPLES_PER_SUBFRAME);
         //memset(ch->wave, 0, sizeof(ch->wave[0][0]) * HCA_SUBFRAMES_PER_FRAME * HCA_SUBFRAMES_PER_FRAME);
     }
@@ -1550,124 +1550,113 @@ static const unsigned int decode5_imdct_window_int[128] = {
 };
 static const float *decode5_imdct_window = (const float *)decode5_imdct_window_int;
 
-static void decoder5_run_imdct(stChannel *ch, int subframe) {
-    static const unsigned int size = HCA_SAMPLES_PER_SUBFRAME;
-    static const unsigned int half = HCA_SAMPLES_PER_SUBFRAME / 2;
-    static const unsigned int mdct_bits = HCA_MDCT_BITS;
+static const unsigned char decode5_bitrev_table[HCA_SAMPLES_PER_SUBFRAME / 2] = {
+    0,32,16,48,8,40,24,56,4,36,20,52,12,44,28,60,
+    2,34,18,50,10,42,26,58,6,38,22,54,14,46,30,62,
+    1,33,17,49,9,41,25,57,5,37,21,53,13,45,29,61,
+    3,35,19,51,11,43,27,59,7,39,23,55,15,47,31,63,
+};
 
+static void decoder5_dct4_sumdiff(float *data, unsigned int stride) {
+    unsigned int j, k;
 
-    /* apply DCT-IV to dequantized spectra */
-    {
-        unsigned int i, j, k;
-        unsigned int count1a, count2a, count1b, count2b;
-        const float *temp1a, *temp1b;
-        float *temp2a, *temp2b;
+    for (j = 0; j < HCA_SAMPLES_PER_SUBFRAME; j += stride * 2) {
+        float *s1 = &data[j];
+        float *s2 = &data[j + stride];
 
-        /* this is all too crafty for me to simplify, see VGAudio (Mdct.Dct4) */
+        for (k = 0; k < stride; k++) {
+            float a = s1[k];
+            float b = s2[k];
+            s1[k] = b + a;
+            s2[k] = a - b;
+        }
+    }
+}
 
-        temp1a = ch->spectra;
-        temp2a = ch->temp;
-        count1a = 1;
-        count2a = half;
-        for (i = 0; i < mdct_bits; i++) {
-            float *swap;
-            float *d1 = &temp2a[0];
-            float *d2 = &temp2a[count2a];
-
-            for (j = 0; j < count1a; j++) {
-                for (k = 0; k < count2a; k++) {
-                    float a = *(temp1a++);
-                    float b = *(temp1a++);
-                    *(d1++) = b + a;
-                    *(d2++) = a - b;
-                }
-                d1 += count2a;
-                d2 += count2a;
-            }
-            swap = (float*) temp1a - HCA_SAMPLES_PER_SUBFRAME; /* move spectra/temp to beginning */
-            temp1a = temp2a;
-            temp2a = swap;
+static void decoder5_dct4_rotate_first(const float *src, float *dst) {
+    const float *sin_table = (const float *) decode5_sin_tables_int[0];
+    const float *cos_table = (const float *) decode5_cos_tables_int[0];
+    unsigned int j;
 
-            count1a = count1a << 1;
-            count2a = count2a >> 1;
+    for (j = 0; j < HCA_SAMPLES_PER_SUBFRAME / 2; j++) {
+        float a = src[decode5_bitrev_table[j]];
+        float b = src[decode5_bitrev_table[j] + HCA_SAMPLES_PER_SUBFRAME / 2];
+        dst[j * 2 + 0] = a * sin_table[j] - b * cos_table[j];
+        dst[j * 2 + 1] = a * cos_table[j] + b * sin_table[j];
+    }
+}
+
+static void decoder5_dct4_rotate(const float *src, float *dst, unsigned int stride, unsigned int pass) {
+    const float *sin_table = (const float *) decode5_sin_tables_int[pass];
+    const float *cos_table = (const float *) decode5_cos_tables_int[pass];
+    unsigned int j, k;
+
+    for (j = 0; j < HCA_SAMPLES_PER_SUBFRAME; j += stride * 2) {
+        const float *s1 = &src[j];
+        const float *s2 = &src[j + stride];
+        const float *sin = &sin_table[j / 2];
+        const float *cos = &cos_table[j / 2];
+        float *d1 = &dst[j];
+        float *d2 = &dst[j + stride];
+
+        for (k = 0; k < stride; k++) {
+            float a = s1[k];
+            float b = s2[k];
+            d1[k] = a * sin[k] - b * cos[k];
+            d2[stride - 1 - k] = a * cos[k] + b * sin[k];
         }
+    }
+}
 
-        temp1b = ch->temp;
-        temp2b = ch->spectra;
-        count1b = half;
-        count2b = 1;
-        for (i = 0; i < mdct_bits; i++) {
-            const float *sin_table = (const float *) decode5_sin_tables_int[i];
-            const float *cos_table = (const float *) decode5_cos_tables_int[i];
-            float *swap;
-            float *d1 = temp2b;
-            float *d2 = &temp2b[count2b * 2 - 1];
-            const float *s1 = &temp1b[0];
-            const float *s2 = &temp1b[count2b];
-
-            for (j = 0; j < count1b; j++) {
-                for (k = 0; k < count2b; k++) {
-                    float a = *(s1++);
-                    float b = *(s2++);
-                    float sin = *(sin_table++);
-                    float cos = *(cos_table++);
-                    *(d1++) = a * sin - b * cos;
-                    *(d2--) = a * cos + b * sin;
-                }
-                s1 += count2b;
-                s2 += count2b;
-                d1 += count2b;
-                d2 += count2b * 3;
-            }
-            swap = (float*) temp1b;
-            temp1b = temp2b;
-            temp2b = swap;
+static void decoder5_run_imdct(stChannel *ch, int subframe) {
+    static const unsigned int size = HCA_SAMPLES_PER_SUBFRAME;
+    static const unsigned int half = HCA_SAMPLES_PER_SUBFRAME / 2;
 
-            count1b = count1b >> 1;
-            count2b = count2b << 1;
-        }
 
-        /* copy dct */
-        /* (with the above optimization spectra is already modified, so this is redundant) */
-        for (i = 0; i < size; i++) {
-            ch->dct[i] = ch->spectra[i];
-        }
+    const float *dct;
+
+    /* apply DCT-IV to dequantized spectra */
+    {
+        /* this is all too crafty for me to simplify, see VGAudio (Mdct.Dct4) */
+
+        /* First part does log2(size) passes of sum/diff between pairs. Done in place each pass
+         * combines values "stride" apart, with the same operations (results are identical) but
+         * leaving output in bit-reversed order. Passes are unrolled with constant strides so
+         * compilers can vectorize each one as needed. */
+        decoder5_dct4_sumdiff(ch->spectra, 1);
+        decoder5_dct4_sumdiff(ch->spectra, 2);
+        decoder5_dct4_sumdiff(ch->spectra, 4);
+        decoder5_dct4_sumdiff(ch->spectra, 8);
+        decoder5_dct4_sumdiff(ch->spectra, 16);
+        decoder5_dct4_sumdiff(ch->spectra, 32);
+        decoder5_dct4_sumdiff(ch->spectra, 64);
+
+        /* Second part does log2(size) passes of rotations between halves of increasing blocks,
+         * first one also undoing the bit-reversed order (pairs 2n/2n+1 are in rev(n)/rev(n)+half) */
+        decoder5_dct4_rotate_first(ch->spectra, ch->temp);
+        decoder5_dct4_rotate(ch->temp, ch->spectra, 2, 1);
+        decoder5_dct4_rotate(ch->spectra, ch->temp, 4, 2);
+        decoder5_dct4_rotate(ch->temp, ch->spectra, 8, 3);
+        decoder5_dct4_rotate(ch->spectra, ch->temp, 16, 4);
+        decoder5_dct4_rotate(ch->temp, ch->spectra, 32, 5);
+        decoder5_dct4_rotate(ch->spectra, ch->temp, 64, 6);
+
+        dct = ch->temp;
     }
 
     /* update output/imdct */
     {
         unsigned int i;
-
-        for (i = 0; i < half; i++) {
-            ch->wave[subframe][i] = decode5_imdct_window[i] * ch->dct[i + half] + ch->imdct_previous[i];
-            ch->wave[subframe][i + half] = decode5_imdct_window[i + half] * ch->dct[size - 1 - i] - ch->imdct_previous[i + half];
-            ch->imdct_previous[i] = decode5_imdct_window[size - 1 - i] * ch->dct[half - i - 1];
-            ch->imdct_previous[i + half] = decode5_imdct_window[half - i - 1] * ch->dct[i];
-        }
-#if 0
-        /* over-optimized IMDCT (for reference), barely noticeable even when decoding hundred of files */
-        const float *imdct_window = decode5_imdct_window;
-        const float *dct;
-        float *imdct_previous;
         float *wave = ch->wave[subframe];
+        float *imdct_previous = ch->imdct_previous;
 
-        dct = &ch->dct[half];
-        imdct_previous = ch->imdct_previous;
         for (i = 0; i < half; i++) {
-            *(wave++) = *(dct++) * *(imdct_window++) + *(imdct_previous++);
+            wave[i] = decode5_imdct_window[i] * dct[half + i] + imdct_previous[i];
+            wave[half + i] = decode5_imdct_window[half + i] * dct[size - 1 - i] - imdct_previous[half + i];
         }
         for (i = 0; i < half; i++) {
-            *(wave++) = *(imdct_window++) * *(--dct) - *(imdct_previous++);
+            imdct_previous[i] = decode5_imdct_window[size - 1 - i] * dct[half - 1 - i];
+            imdct_previous[half + i] = decode5_imdct_window[half - 1 - i] * dct[i];
         }
-        /* implicit: imdct_window pointer is now at end */
-        dct = &ch->dct[half - 1];
-        imdct_previous = ch->imdct_previous;
-        for (i = 0; i < half; i++) {
-            *(imdct_previous++) = *(--imdct_window) * *(dct--);
-        }
-        for (i = 0; i < half; i++) {
-            *(imdct_previous++) = *(--imdct_window) * *(++dct) ;
-        }
-#endif
     }
 }
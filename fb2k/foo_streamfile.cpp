@@ -123,6 +123,9 @@ static void get_name_foo(FOO_STREAMFILE *streamfile,char *buffer,size_t length)
       strcpy(buffer, streamfile->name);
    }
 }
+static const char * get_name_ref_foo(FOO_STREAMFILE *streamfile) {
+    return streamfile->name;
+}
 static void close_foo(FOO_STREAMFILE * streamfile) {
     streamfile->m_file.release();
     free(streamfile->name);
@@ -168,6 +171,7 @@ static STREAMFILE * open_foo_streamfile_buffer_by_file(service_ptr_t<file> m_fil
     streamfile->sf.get_size = (size_t (__cdecl *)(_STREAMFILE *)) get_size_foo;
     streamfile->sf.get_offset = (off_t (__cdecl *)(_STREAMFILE *)) get_offset_foo;
     streamfile->sf.get_name = (void (__cdecl *)(_STREAMFILE *,char *,size_t)) get_name_foo;
+    streamfile->sf.get_name_ref = (const char * (__cdecl *)(_STREAMFILE *)) get_name_ref_foo;
     streamfile->sf.open = (_STREAMFILE *(__cdecl *)(_STREAMFILE *,const char *const ,size_t)) open_foo;
     streamfile->sf.close = (void (__cdecl *)(_STREAMFILE *)) close_foo;
 
@@ -209,5 +213,17 @@ static STREAMFILE * open_foo_streamfile_buffer(const char * const filename, size
 }
 
 STREAMFILE * open_foo_streamfile(const char * const filename, abort_callback * p_abort, t_filestats * stats) {
-    return open_foo_streamfile_buffer(filename,STREAMFILE_DEFAULT_BUFFER_SIZE, p_abort, stats);
+    STREAMFILE *streamFile, *newStreamFile;
+
+    streamFile = open_foo_streamfile_buffer(filename,STREAMFILE_DEFAULT_BUFFER_SIZE, p_abort, stats);
+    if (!streamFile) return NULL;
+
+    /* foobar's IO may be slow (network shares, archives), so prefetch during playback */
+    newStreamFile = open_readahead_streamfile(streamFile, 0);
+    if (!newStreamFile) {
+        close_streamfile(streamFile);
+        return NULL;
+    }
+
+    return newStreamFile;
 }
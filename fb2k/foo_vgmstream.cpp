@@ -23,6 +23,10 @@ extern "C" {
 #include "../version.h"
 #endif
 
+/* parsed tagfile, reused between files in the same folder (get_info may be called from many threads) */
+static VGMSTREAM_TAGS_DB* g_tags_db = NULL;
+static critical_section g_tags_db_lock;
+
 #ifndef VERSION
 #define PLUGIN_VERSION  __DATE__
 #else
@@ -151,9 +155,8 @@ void input_vgmstream::get_info(t_uint32 p_subsong, file_info & p_info, abort_cal
     if (get_description_tag(temp,description,"stream name: ")) p_info.meta_set("stream_name",temp);
 
     /* get external file tags */
-    //todo optimize and don't parse tags again for this session (not sure how), seems foobar
-    // calls get_info on every play even if the file hasn't changes, and won't refresh "meta"
-    // unless forced or closing playlist+exe
+    // foobar calls get_info on every play even if the file hasn't changes, and won't refresh "meta"
+    // unless forced or closing playlist+exe, so the parsed tagfile is kept until it changes
     if (!tagfile_disable) {
         //todo use foobar's fancy-but-arcane string functions
         char tagfile_path[PATH_LIMIT];
@@ -168,12 +171,19 @@ void input_vgmstream::get_info(t_uint32 p_subsong, file_info & p_info, abort_cal
             strcpy(tagfile_path,tagfile_name);
         }
 
-        STREAMFILE *tagFile = open_foo_streamfile(tagfile_path, &p_abort, &stats);
+        t_filestats tag_stats;
+        STREAMFILE *tagFile = open_foo_streamfile(tagfile_path, &p_abort, &tag_stats);
         if (tagFile != NULL) {
-            VGMSTREAM_TAGS tag;
-            vgmstream_tags_reset(&tag, filename);
-            while (vgmstream_tags_next_tag(&tag, tagFile)) {
-                p_info.meta_set(tag.key,tag.val);
+            insync(g_tags_db_lock);
+            if (!g_tags_db)
+                g_tags_db = vgmstream_tags_db_init();
+
+            if (g_tags_db && vgmstream_tags_db_load(g_tags_db, tagFile, tag_stats.m_timestamp)) {
+                VGMSTREAM_TAGS tag;
+                vgmstream_tags_reset(&tag, filename);
+                while (vgmstream_tags_db_next_tag(g_tags_db, &tag)) {
+                    p_info.meta_set(tag.key,tag.val);
+                }
             }
 
             close_streamfile(tagFile);
@@ -369,23 +379,8 @@ void input_vgmstream::retag_commit(abort_callback & p_abort) { /*throw exception
 
 bool input_vgmstream::g_is_our_content_type(const char * p_content_type) {return false;}
 bool input_vgmstream::g_is_our_path(const char * p_path,const char * p_extension) {
-    const char ** ext_list;
-    size_t ext_list_len;
-    int i;
-
-    ext_list = vgmstream_get_formats(&ext_list_len);
-
-    for (i=0; i < ext_list_len; i++) {
-        if (!stricmp_utf8(p_extension, ext_list[i]))
-            return 1;
-    }
-
     /* some extensionless files can be handled by vgmstream, try to play */
-    if (strlen(p_extension) <= 0) {
-        return 1;
-    }
-
-    return 0;
+    return vgmstream_ctx_is_valid(p_extension, VGMSTREAM_VALID_IS_EXTENSION | VGMSTREAM_VALID_ACCEPT_EXTENSIONLESS);
 }
 
 
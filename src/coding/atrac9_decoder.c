@@ -79,6 +79,7 @@ void decode_atrac9(VGMSTREAM *vgmstream, sample * outbuf, int32_t samples_to_do,
                 if (samples_to_get > data->samples_to_discard)
                     samples_to_get = data->samples_to_discard;
                 data->samples_to_discard -= samples_to_get;
+                VGM_COUNT(vgmstream, samples_discarded, samples_to_get);
             }
             else {
                 /* get max samples and copy */
@@ -95,6 +95,7 @@ void decode_celt_fsb(VGMSTREAM *vgmstream, sample * outbuf, int32_t samples_to_d
                 if (samples_to_get > data->samples_to_discard)
                     samples_to_get = data->samples_to_discard;
                 data->samples_to_discard -= samples_to_get;
+                VGM_COUNT(vgmstream, samples_discarded, samples_to_get);
             }
             else {
                 /* get max samples and copy */
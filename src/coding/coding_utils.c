@@ -1,6 +1,7 @@
 #include "coding.h"
 #include <math.h>
 #include "../vgmstream.h"
+#include "../scan_cache.h"
 
 
 /**
@@ -439,23 +440,63 @@ fail:
 /* XMA PARSING                                  */
 /* ******************************************** */
 
-static void ms_audio_parse_header(STREAMFILE *streamFile, int xma_version, off_t offset_b, int bits_frame_size, size_t *first_frame_b, size_t *packet_skip_count, size_t *header_size_b) {
+/* A whole packet in memory (plus a few bytes, as frame headers may cross to the next one), since
+ * parsing reads lots of small bit fields and doing each through the streamfile is slow. */
+typedef struct {
+    uint8_t * buf;
+    size_t buf_size;
+    size_t bytes;           /* actually read */
+    off_t offset_b;         /* packet start in global bits */
+    STREAMFILE * streamFile;
+} ms_packet;
+
+static int ms_packet_init(ms_packet * packet, STREAMFILE *streamFile, size_t bytes_per_packet) {
+    packet->buf_size = bytes_per_packet + 0x04;
+    packet->buf = malloc(packet->buf_size);
+    packet->bytes = 0;
+    packet->offset_b = 0;
+    packet->streamFile = streamFile;
+    return packet->buf != NULL;
+}
+
+static void ms_packet_read(ms_packet * packet, off_t offset) {
+    packet->offset_b = offset * 8;
+    packet->bytes = read_streamfile(packet->buf, offset, packet->buf_size, packet->streamFile);
+}
+
+/* same as read_bitsBE_b but from the packet buffer when possible (global bit offsets) */
+static uint32_t ms_packet_read_bits(ms_packet * packet, off_t bit_offset, int num_bits) {
+    uint32_t num, mask;
+    off_t offset_b = bit_offset - packet->offset_b;
+
+    if (num_bits > 25 || offset_b < 0 || offset_b / 8 + 4 > packet->bytes)
+        return read_bitsBE_b(bit_offset, num_bits, packet->streamFile);
+
+    num = get_32bitBE(packet->buf + offset_b / 8);
+    num = num << (offset_b % 8);
+    num = num >> (32 - num_bits);
+    mask = 0xffffffff >> (32 - num_bits);
+
+    return num & mask;
+}
+
+static void ms_audio_parse_header(ms_packet * packet, int xma_version, off_t offset_b, int bits_frame_size, size_t *first_frame_b, size_t *packet_skip_count, size_t *header_size_b) {
     if (xma_version == 1) { /* XMA1 */
-        //packet_sequence  = read_bitsBE_b(offset_b+0,  4,  streamFile); /* numbered from 0 to N */
-        //unknown          = read_bitsBE_b(offset_b+4,  2,  streamFile); /* packet_metadata? (always 2) */
-        *first_frame_b     = read_bitsBE_b(offset_b+6,  bits_frame_size, streamFile); /* offset in bits inside the packet */
-        *packet_skip_count = read_bitsBE_b(offset_b+21, 11, streamFile); /* packets to skip for next packet of this stream */
+        //packet_sequence  = ms_packet_read_bits(packet, offset_b+0,  4); /* numbered from 0 to N */
+        //unknown          = ms_packet_read_bits(packet, offset_b+4,  2); /* packet_metadata? (always 2) */
+        *first_frame_b     = ms_packet_read_bits(packet, offset_b+6,  bits_frame_size); /* offset in bits inside the packet */
+        *packet_skip_count = ms_packet_read_bits(packet, offset_b+21, 11); /* packets to skip for next packet of this stream */
         *header_size_b     = 32;
     } else if (xma_version == 2) { /* XMA2 */
-        //frame_count      = read_bitsBE_b(offset_b+0,  6,  streamFile); /* frames that begin in this packet */
-        *first_frame_b     = read_bitsBE_b(offset_b+6,  bits_frame_size, streamFile); /* offset in bits inside this packet */
-        //packet_metadata = read_bitsBE_b(offset_b+21, 3,  streamFile); /* packet_metadata (always 1) */
-        *packet_skip_count = read_bitsBE_b(offset_b+24, 8,  streamFile); /* packets to skip for next packet of this stream */
+        //frame_count      = ms_packet_read_bits(packet, offset_b+0,  6); /* frames that begin in this packet */
+        *first_frame_b     = ms_packet_read_bits(packet, offset_b+6,  bits_frame_size); /* offset in bits inside this packet */
+        //packet_metadata = ms_packet_read_bits(packet, offset_b+21, 3); /* packet_metadata (always 1) */
+        *packet_skip_count = ms_packet_read_bits(packet, offset_b+24, 8); /* packets to skip for next packet of this stream */
         *header_size_b     = 32;
     } else { /* WMAPRO(v3) */
-        //packet_sequence  = read_bitsBE_b(offset_b+0,  4,  streamFile); /* numbered from 0 to N */
-        //unknown          = read_bitsBE_b(offset_b+4,  2,  streamFile); /* packet_metadata? (always 2) */
-        *first_frame_b     = read_bitsBE_b(offset_b+6,  bits_frame_size, streamFile);  /* offset in bits inside the packet */
+        //packet_sequence  = ms_packet_read_bits(packet, offset_b+0,  4); /* numbered from 0 to N */
+        //unknown          = ms_packet_read_bits(packet, offset_b+4,  2); /* packet_metadata? (always 2) */
+        *first_frame_b     = ms_packet_read_bits(packet, offset_b+6,  bits_frame_size);  /* offset in bits inside the packet */
         *packet_skip_count = 0; /* xwma has no need to skip packets since it uses real multichannel audio */
         *header_size_b     = 4+2+bits_frame_size; /* variable-sized header */
     }
@@ -493,7 +534,7 @@ static void ms_audio_parse_header(STREAMFILE *streamFile, int xma_version, off_t
  *
  * XMA1/XMA2/WMAPRO data only differs in the packet headers.
  */
-static void ms_audio_get_samples(ms_sample_data * msd, STREAMFILE *streamFile, int channels_per_packet, int bytes_per_packet, int samples_per_frame, int samples_per_subframe, int bits_frame_size) {
+static int ms_audio_scan_samples(ms_sample_data * msd, STREAMFILE *streamFile, int channels_per_packet, int bytes_per_packet, int samples_per_frame, int samples_per_subframe, int bits_frame_size) {
     int frames = 0, samples = 0, loop_start_frame = 0, loop_end_frame = 0;
 
     size_t first_frame_b, packet_skip_count, header_size_b, frame_size_b;
@@ -504,14 +545,19 @@ static void ms_audio_get_samples(ms_sample_data * msd, STREAMFILE *streamFile, i
     off_t offset = msd->data_offset;
     off_t max_offset = msd->data_offset + msd->data_size;
     off_t stream_offset_b = msd->data_offset * 8;
+    ms_packet packet;
+
+    if (!ms_packet_init(&packet, streamFile, packet_size))
+        return 0;
 
     /* read packets */
     while (offset < max_offset) {
+        ms_packet_read(&packet, offset);
         offset_b = offset * 8; /* global offset in bits */
         offset += packet_size; /* global offset in bytes */
 
         /* packet header */
-        ms_audio_parse_header(streamFile, msd->xma_version, offset_b, bits_frame_size, &first_frame_b, &packet_skip_count, &header_size_b);
+        ms_audio_parse_header(&packet, msd->xma_version, offset_b, bits_frame_size, &first_frame_b, &packet_skip_count, &header_size_b);
         if (packet_skip_count > 0x7FF) {
             continue; /* full skip */
         }
@@ -532,7 +578,7 @@ static void ms_audio_get_samples(ms_sample_data * msd, STREAMFILE *streamFile, i
                 loop_end_frame = frames;
 
             /* frame header */
-            frame_size_b = read_bitsBE_b(frame_offset_b, bits_frame_size, streamFile);
+            frame_size_b = ms_packet_read_bits(&packet, frame_offset_b, bits_frame_size);
             frame_offset_b += bits_frame_size;
 
             /* stop when packet padding starts (0x00 for XMA1 or 0xFF in XMA2) */
@@ -547,12 +593,14 @@ static void ms_audio_get_samples(ms_sample_data * msd, STREAMFILE *streamFile, i
 
             /* last bit in frame = more frames flag, end packet to avoid reading garbage in some cases
              * (last frame spilling to other packets also has this flag, though it's ignored here) */
-            if (packet_offset_b < packet_size_b && !read_bitsBE_b(offset_b + packet_offset_b - 1, 1, streamFile)) {
+            if (packet_offset_b < packet_size_b && !ms_packet_read_bits(&packet, offset_b + packet_offset_b - 1, 1)) {
                 break;
             }
         }
     }
 
+    free(packet.buf);
+
     /* result */
     msd->num_samples = samples;
     if (msd->loop_flag && loop_end_frame > loop_start_frame) {
@@ -567,6 +615,54 @@ static void ms_audio_get_samples(ms_sample_data * msd, STREAMFILE *streamFile, i
         msd->num_samples += (samples_per_frame / 2); /* but doesn't add extra samples */
 #endif
     }
+
+    return 1;
+}
+
+/* same as the above, but reuses results from previous opens if enabled, as it reads the whole stream */
+static void ms_audio_get_samples(ms_sample_data * msd, STREAMFILE *streamFile, int channels_per_packet, int bytes_per_packet, int samples_per_frame, int samples_per_subframe, int bits_frame_size) {
+    scan_cache_key key;
+    struct {
+        int32_t xma_version, channels_per_packet, bytes_per_packet, samples_per_frame, samples_per_subframe, bits_frame_size;
+        uint32_t data_offset, data_size;
+        int32_t loop_flag;
+        uint32_t loop_start_b, loop_end_b, loop_start_subframe, loop_end_subframe;
+        int32_t loop_start_sample, loop_end_sample; /* kept if loops aren't found */
+    } params;
+    int32_t result[3];
+
+    memset(&params, 0, sizeof(params));
+    params.xma_version = msd->xma_version;
+    params.channels_per_packet = channels_per_packet;
+    params.bytes_per_packet = bytes_per_packet;
+    params.samples_per_frame = samples_per_frame;
+    params.samples_per_subframe = samples_per_subframe;
+    params.bits_frame_size = bits_frame_size;
+    params.data_offset = msd->data_offset;
+    params.data_size = msd->data_size;
+    params.loop_flag = msd->loop_flag;
+    params.loop_start_b = msd->loop_start_b;
+    params.loop_end_b = msd->loop_end_b;
+    params.loop_start_subframe = msd->loop_start_subframe;
+    params.loop_end_subframe = msd->loop_end_subframe;
+    params.loop_start_sample = msd->loop_start_sample;
+    params.loop_end_sample = msd->loop_end_sample;
+
+    if (scan_cache_get(&key, streamFile, "ms_audio_samples", &params, sizeof(params), result, sizeof(result))) {
+        msd->num_samples = result[0];
+        msd->loop_start_sample = result[1];
+        msd->loop_end_sample = result[2];
+        return;
+    }
+
+    /* values are left as-is on failure, which mustn't be saved as a result */
+    if (!ms_audio_scan_samples(msd, streamFile, channels_per_packet, bytes_per_packet, samples_per_frame, samples_per_subframe, bits_frame_size))
+        return;
+
+    result[0] = msd->num_samples;
+    result[1] = msd->loop_start_sample;
+    result[2] = msd->loop_end_sample;
+    scan_cache_put(&key, result, sizeof(result));
 }
 
 /* simlar to the above but only gets skips */
@@ -579,15 +675,21 @@ static void ms_audio_get_skips(STREAMFILE *streamFile, int xma_version, off_t da
     size_t packet_size = bytes_per_packet;
     size_t packet_size_b = packet_size * 8;
     off_t offset = data_offset;
+    ms_packet packet;
+
+    if (!ms_packet_init(&packet, streamFile, packet_size))
+        return;
 
     /* read packet */
     {
+        ms_packet_read(&packet, offset);
         offset_b = offset * 8; /* global offset in bits */
         offset += packet_size; /* global offset in bytes */
 
         /* packet header */
-        ms_audio_parse_header(streamFile, 2, offset_b, bits_frame_size, &first_frame_b, &packet_skip_count, &header_size_b);
+        ms_audio_parse_header(&packet, 2, offset_b, bits_frame_size, &first_frame_b, &packet_skip_count, &header_size_b);
         if (packet_skip_count > 0x7FF) {
+            free(packet.buf);
             return; /* full skip */
         }
 
@@ -598,7 +700,7 @@ static void ms_audio_get_skips(STREAMFILE *streamFile, int xma_version, off_t da
             frame_offset_b = offset_b + packet_offset_b; /* in bits for aligment stuff */
 
             /* frame header */
-            frame_size_b = read_bitsBE_b(frame_offset_b, bits_frame_size, streamFile);
+            frame_size_b = ms_packet_read_bits(&packet, frame_offset_b, bits_frame_size);
             frame_offset_b += bits_frame_size;
 
             /* stop when packet padding starts (0x00 for XMA1 or 0xFF in XMA2) */
@@ -616,10 +718,10 @@ static void ms_audio_get_skips(STREAMFILE *streamFile, int xma_version, off_t da
 
                 /* ignore "postproc transform" */
                 if (channels_per_packet > 1) {
-                    flag = read_bitsBE_b(frame_offset_b, 1, streamFile);
+                    flag = ms_packet_read_bits(&packet, frame_offset_b, 1);
                     frame_offset_b += 1;
                     if (flag) {
-                        flag = read_bitsBE_b(frame_offset_b, 1, streamFile);
+                        flag = ms_packet_read_bits(&packet, frame_offset_b, 1);
                         frame_offset_b += 1;
                         if (flag) {
                             frame_offset_b += 1 + 4 * channels_per_packet*channels_per_packet; /* 4-something per double channel? */
@@ -628,14 +730,14 @@ static void ms_audio_get_skips(STREAMFILE *streamFile, int xma_version, off_t da
                 }
 
                 /* get start/end skips to get the proper number of samples (both can be 0) */
-                flag = read_bitsBE_b(frame_offset_b, 1, streamFile);
+                flag = ms_packet_read_bits(&packet, frame_offset_b, 1);
                 frame_offset_b += 1;
                 if (flag) {
                     /* get start skip */
-                    flag = read_bitsBE_b(frame_offset_b, 1, streamFile);
+                    flag = ms_packet_read_bits(&packet, frame_offset_b, 1);
                     frame_offset_b += 1;
                     if (flag) {
-                        int new_skip = read_bitsBE_b(frame_offset_b, 10, streamFile);
+                        int new_skip = ms_packet_read_bits(&packet, frame_offset_b, 10);
                         //;VGM_LOG("MS_SAMPLES: start_skip %i at 0x%x (bit 0x%x)\n", new_skip, (uint32_t)frame_offset_b/8, (uint32_t)frame_offset_b);
                         frame_offset_b += 10;
 
@@ -647,10 +749,10 @@ static void ms_audio_get_skips(STREAMFILE *streamFile, int xma_version, off_t da
                     }
 
                     /* get end skip */
-                    flag = read_bitsBE_b(frame_offset_b, 1, streamFile);
+                    flag = ms_packet_read_bits(&packet, frame_offset_b, 1);
                     frame_offset_b += 1;
                     if (flag) {
-                        int new_skip = read_bitsBE_b(frame_offset_b, 10, streamFile);
+                        int new_skip = ms_packet_read_bits(&packet, frame_offset_b, 10);
                         //;VGM_LOG("MS_SAMPLES: end_skip %i at 0x%x (bit 0x%x)\n", new_skip, (uint32_t)frame_offset_b/8, (uint32_t)frame_offset_b);
                         frame_offset_b += 10;
 
@@ -664,6 +766,8 @@ static void ms_audio_get_skips(STREAMFILE *streamFile, int xma_version, off_t da
         }
     }
 
+    free(packet.buf);
+
     /* output results */
     if (out_start_skip) *out_start_skip = start_skip;
     if (out_end_skip) *out_end_skip = end_skip;
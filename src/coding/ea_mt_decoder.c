@@ -91,6 +91,8 @@ void decode_ea_mt(VGMSTREAM * vgmstream, sample * outbuf, int channelspacing, in
                 if (samples_to_get > ch_data->samples_discard)
                     samples_to_get = ch_data->samples_discard;
                 ch_data->samples_discard -= samples_to_get;
+                if (channel == 0)
+                    VGM_COUNT(vgmstream, samples_discarded, samples_to_get);
             }
             else {
                 /* get max samples and copy */
@@ -5,29 +5,23 @@
 /* internal sizes, can be any value */
 #define FFMPEG_DEFAULT_SAMPLE_BUFFER_SIZE 2048
 #define FFMPEG_DEFAULT_IO_BUFFER_SIZE 128 * 1024
-
-
-static volatile int g_ffmpeg_initialized = 0;
+#define FFMPEG_INDEX_PREROLL 2 /* packets decoded and discarded before a seek target (settles overlapped frames) */
 
 
 /* ******************************************** */
 /* INTERNAL UTILS                               */
 /* ******************************************** */
 
-/* Global FFmpeg init */
-static void g_init_ffmpeg() {
-    if (g_ffmpeg_initialized == 1) {
-        while (g_ffmpeg_initialized < 2); /* active wait for lack of a better way */
-    }
-    else if (g_ffmpeg_initialized == 0) {
-        g_ffmpeg_initialized = 1;
-        av_log_set_flags(AV_LOG_SKIP_REPEATED);
-        av_log_set_level(AV_LOG_ERROR);
-        //av_register_all(); /* not needed in newer versions */
-        g_ffmpeg_initialized = 2;
-    }
+/* Global FFmpeg init, once per process (streams may be opened from several threads) */
+static void g_init_ffmpeg_once(void) {
+    av_log_set_flags(AV_LOG_SKIP_REPEATED);
+    av_log_set_level(AV_LOG_ERROR);
+    //av_register_all(); /* not needed in newer versions */
 }
 
+static vgm_once_t g_ffmpeg_once = VGM_ONCE_INIT;
+static void g_init_ffmpeg() { vgm_once(&g_ffmpeg_once, g_init_ffmpeg_once); }
+
 /* converts codec's samples (can be in any format, ex. Ogg's float32) to PCM16 */
 static void convert_audio_pcm16(sample *outbuf, const uint8_t *inbuf, int fullSampleCount, int bitsPerSample, int floatingPoint) {
     int s;
@@ -175,6 +169,86 @@ fail:
     return -1;
 }
 
+/**
+ * Packet index, filled while decoding.
+ *
+ * For codecs where every packet decodes to one fixed-size frame, the sample position of each packet is
+ * known once decoded, so seeks can restart a few packets before the target rather than from 0 (the extra
+ * packets rebuild the decoder's overlap and are discarded). Codecs where frames cross packets (XMA/WMA)
+ * or the first frame after a flush isn't output (Vorbis/Opus) would end up off by some samples.
+ */
+static int is_indexable(ffmpeg_codec_data * data) {
+    switch(data->codecCtx->codec_id) {
+        case AV_CODEC_ID_ATRAC3:
+        case AV_CODEC_ID_ATRAC3P:
+            return data->blockAlign > 0 && data->frameSize > 0;
+        default:
+            return 0;
+    }
+}
+
+static void add_index_entry(ffmpeg_codec_data * data, int64_t pos) {
+    if (pos < 0) {
+        data->indexable = 0; /* can't seek to unknown positions */
+        return;
+    }
+
+    /* only new packets (after seeking back they are already there) */
+    if (data->indexCount > 0 && pos <= data->index[data->indexCount-1].pos)
+        return;
+
+    if (data->indexCount == data->indexMax) {
+        int new_max = data->indexMax ? data->indexMax * 2 : 0x400;
+        ffmpeg_index_entry * new_index = realloc(data->index, new_max * sizeof(ffmpeg_index_entry));
+        if (!new_index) {
+            data->indexable = 0;
+            return;
+        }
+        data->index = new_index;
+        data->indexMax = new_max;
+    }
+
+    data->index[data->indexCount].pos = pos;
+    data->index[data->indexCount].sample = data->samplesDecoded;
+    data->indexCount++;
+}
+
+/* seeks to some packets before the target sample using the index, returns 0 if not possible */
+static int seek_index(ffmpeg_codec_data * data, int64_t target) {
+    ffmpeg_index_entry * entry;
+    int lo, hi;
+
+    if (!data->indexable || data->indexCount == 0)
+        return 0;
+
+    /* last packet starting before the target */
+    lo = 0;
+    hi = data->indexCount - 1;
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+        if (data->index[mid].sample <= target)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    lo -= FFMPEG_INDEX_PREROLL;
+    if (lo <= 0)
+        return 0; /* near the beginning, regular seek is fine */
+    entry = &data->index[lo];
+
+    if (avformat_seek_file(data->formatCtx, data->streamIndex, entry->pos, entry->pos, entry->pos, AVSEEK_FLAG_BYTE) < 0) {
+        VGM_LOG("FFMPEG: can't seek to index at %lx\n", (long)entry->pos);
+        data->indexable = 0;
+        return 0;
+    }
+    avcodec_flush_buffers(data->codecCtx);
+
+    data->samplesDecoded = entry->sample;
+    data->samplesToDiscard = (int)(target - entry->sample);
+    return 1;
+}
+
 
 /* ******************************************** */
 /* AVIO CALLBACKS                               */
@@ -290,6 +364,7 @@ ffmpeg_codec_data * init_ffmpeg_header_offset_subsong(STREAMFILE *streamFile, ui
     ffmpeg_codec_data * data;
     int errcode, i;
     int streamIndex, streamCount;
+    AVInputFormat *fmt = NULL;
 
     AVStream *stream;
     AVCodecParameters *codecPar = NULL;
@@ -339,7 +414,11 @@ ffmpeg_codec_data * init_ffmpeg_header_offset_subsong(STREAMFILE *streamFile, ui
 
     data->formatCtx->pb = data->ioCtx;
 
-    if ((errcode = avformat_open_input(&data->formatCtx, "", NULL, NULL)) < 0) goto fail; /* autodetect */
+    /* our fake RIFF headers are plain WAVE, no need to probe every format (adds up when opening many subsongs) */
+    if (header_size >= 0x0c && memcmp(header + 0x00, "RIFF", 4) == 0 && memcmp(header + 0x08, "WAVE", 4) == 0)
+        fmt = av_find_input_format("wav");
+
+    if ((errcode = avformat_open_input(&data->formatCtx, "", fmt, NULL)) < 0) goto fail; /* autodetect if not set */
 
     if ((errcode = avformat_find_stream_info(data->formatCtx, NULL)) < 0) goto fail;
 
@@ -450,6 +529,8 @@ ffmpeg_codec_data * init_ffmpeg_header_offset_subsong(STREAMFILE *streamFile, ui
     if(data->frameSize == 0) /* some formats don't set frame_size but can get on request, and vice versa */
         data->frameSize = av_get_audio_frame_duration(data->codecCtx,0);
 
+    data->indexable = is_indexable(data);
+
     /* setup decode buffer */
     data->sampleBufferBlock = FFMPEG_DEFAULT_SAMPLE_BUFFER_SIZE;
     data->sampleBuffer = av_malloc( data->sampleBufferBlock * (data->bitsPerSample / 8) * data->channels );
@@ -558,6 +639,10 @@ void decode_ffmpeg(VGMSTREAM *vgmstream, sample * outbuf, int32_t samples_to_do,
 
                 if (packet->stream_index != data->streamIndex)
                     continue; /* ignore non-selected streams */
+
+                /* decoder has output all samples of previous packets at this point */
+                if (data->indexable && errcode >= 0)
+                    add_index_entry(data, packet->pos);
             }
 
             /* send compressed data to decoder in packet (NULL at EOF to "drain") */
@@ -597,6 +682,8 @@ void decode_ffmpeg(VGMSTREAM *vgmstream, sample * outbuf, int32_t samples_to_do,
                 }
             }
 
+            data->samplesDecoded += frame->nb_samples;
+
             /* get sample data size of current frame */
             dataSize = av_samples_get_buffer_size(NULL, codecCtx->channels, frame->nb_samples, codecCtx->sample_fmt, 1);
             if (dataSize < 0)
@@ -614,6 +701,7 @@ void decode_ffmpeg(VGMSTREAM *vgmstream, sample * outbuf, int32_t samples_to_do,
                 /* discard all of the frame's samples and continue to the next */
                 bytesConsumedFromDecodedFrame = dataSize;
                 data->samplesToDiscard -= samplesDataSize;
+                VGM_COUNT(vgmstream, samples_discarded, samplesDataSize);
                 continue;
             }
             else {
@@ -622,6 +710,7 @@ void decode_ffmpeg(VGMSTREAM *vgmstream, sample * outbuf, int32_t samples_to_do,
                 int dataSizeLeft = dataSize - bytesToDiscard;
 
                 bytesConsumedFromDecodedFrame += bytesToDiscard;
+                VGM_COUNT(vgmstream, samples_discarded, data->samplesToDiscard);
                 data->samplesToDiscard = 0;
                 if (toConsume > dataSizeLeft)
                     toConsume = dataSizeLeft;
@@ -690,6 +779,7 @@ void reset_ffmpeg(VGMSTREAM *vgmstream) {
     data->endOfStream = 0;
     data->endOfAudio = 0;
     data->samplesToDiscard = 0;
+    data->samplesDecoded = 0;
 
     /* consider skip samples (encoder delay), if manually set (otherwise let FFmpeg handle it) */
     if (data->skipSamplesSet) {
@@ -705,16 +795,22 @@ void reset_ffmpeg(VGMSTREAM *vgmstream) {
 void seek_ffmpeg(VGMSTREAM *vgmstream, int32_t num_sample) {
     ffmpeg_codec_data *data = (ffmpeg_codec_data *) vgmstream->codec_data;
     int64_t ts;
+    int indexed;
     if (!data)
         return;
 
     /* Start from 0 and discard samples until loop_start (slower but not too noticeable).
-     * Due to various FFmpeg quirks seeking to a sample is erratic in many formats (would need extra steps). */
-    data->samplesToDiscard = num_sample;
-    ts = 0;
+     * Due to various FFmpeg quirks seeking to a sample is erratic in many formats (would need extra steps).
+     * Codecs with a packet index start from a few packets before instead (decoded samples include manual skip). */
+    indexed = seek_index(data, num_sample + (data->skipSamplesSet ? data->skipSamples : 0));
+    if (!indexed) {
+        data->samplesToDiscard = num_sample;
+        data->samplesDecoded = 0;
+        ts = 0;
 
-    avformat_seek_file(data->formatCtx, data->streamIndex, ts, ts, ts, AVSEEK_FLAG_ANY);
-    avcodec_flush_buffers(data->codecCtx);
+        avformat_seek_file(data->formatCtx, data->streamIndex, ts, ts, ts, AVSEEK_FLAG_ANY);
+        avcodec_flush_buffers(data->codecCtx);
+    }
 
     data->readNextPacket = 1;
     data->bytesConsumedFromDecodedFrame = INT_MAX;
@@ -728,7 +824,8 @@ void seek_ffmpeg(VGMSTREAM *vgmstream, int32_t num_sample) {
         stream->skip_samples = 0;
         stream->start_skip_samples = 0;
 
-        data->samplesToDiscard += data->skipSamples;
+        if (!indexed)
+            data->samplesToDiscard += data->skipSamples;
     }
 }
 
@@ -777,6 +874,7 @@ void free_ffmpeg(ffmpeg_codec_data *data) {
         close_streamfile(data->streamfile);
         data->streamfile = NULL;
     }
+    free(data->index);
     free(data);
 }
 
@@ -1,5 +1,6 @@
 #include "coding.h"
 #include "../streamfile.h"
+#include "../scan_cache.h"
 #include <string.h>
 
 /**
@@ -267,7 +268,7 @@ fail:
 /* ******************************** */
 
 /* from ww2ogg - from Tremor (lowmem) */
-static uint32_t crc_lookup[256]={
+static const uint32_t crc_lookup[256]={
   0x00000000,0x04c11db7,0x09823b6e,0x0d4326d9,  0x130476dc,0x17c56b6b,0x1a864db2,0x1e475005,
   0x2608edb8,0x22c9f00f,0x2f8ad6d6,0x2b4bcb61,  0x350c9b64,0x31cd86d3,0x3c8ea00a,0x384fbdbd,
   0x4c11db70,0x48d0c6c7,0x4593e01e,0x4152fda9,  0x5f15adac,0x5bd4b01b,0x569796c2,0x52568b75,
@@ -523,7 +524,7 @@ static size_t get_xopus_packet_size(int packet, STREAMFILE * streamfile) {
 
 #ifdef VGM_USE_FFMPEG
 
-static size_t custom_opus_get_samples(off_t offset, size_t data_size, STREAMFILE *streamFile, opus_type_t type) {
+static size_t custom_opus_scan_samples(off_t offset, size_t data_size, STREAMFILE *streamFile, opus_type_t type) {
     size_t num_samples = 0;
     off_t end_offset = offset + data_size;
     int packet = 0;
@@ -569,6 +570,25 @@ static size_t custom_opus_get_samples(off_t offset, size_t data_size, STREAMFILE
     return num_samples;
 }
 
+/* reuses results from previous opens if enabled, as it reads the whole stream */
+static size_t custom_opus_get_samples(off_t offset, size_t data_size, STREAMFILE *streamFile, opus_type_t type) {
+    scan_cache_key key;
+    uint32_t params[3];
+    uint32_t num_samples;
+
+    params[0] = offset;
+    params[1] = data_size;
+    params[2] = type;
+    if (scan_cache_get(&key, streamFile, "custom_opus_samples", params, sizeof(params), &num_samples, sizeof(num_samples)))
+        return num_samples;
+
+    num_samples = custom_opus_scan_samples(offset, data_size, streamFile, type);
+
+    if (num_samples) /* 0 = failed scan, not cached */
+        scan_cache_put(&key, &num_samples, sizeof(num_samples));
+    return num_samples;
+}
+
 size_t switch_opus_get_samples(off_t offset, size_t data_size, STREAMFILE *streamFile) {
     return custom_opus_get_samples(offset, data_size, streamFile, OPUS_SWITCH);
 }
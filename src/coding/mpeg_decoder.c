@@ -180,21 +180,28 @@ fail:
 }
 
 
+/* Global mpg123 init, once per process (older versions fill shared tables, so it can't race with mpg123_new) */
+static int g_mpg123_init_result = MPG123_NOT_INITIALIZED;
+static void g_init_mpg123_once(void) {
+    g_mpg123_init_result = mpg123_init();
+}
+
+static vgm_once_t g_mpg123_once = VGM_ONCE_INIT;
+static int g_init_mpg123() {
+    vgm_once(&g_mpg123_once, g_init_mpg123_once);
+    return g_mpg123_init_result == MPG123_OK;
+}
+
 static mpg123_handle * init_mpg123_handle() {
     mpg123_handle *m = NULL;
     int rc;
 
+    if (!g_init_mpg123())
+        goto fail;
+
     /* inits a new mpg123 handle */
     m = mpg123_new(NULL,&rc);
-    if (rc == MPG123_NOT_INITIALIZED) {
-        /* inits the library if needed */
-        if (mpg123_init() != MPG123_OK)
-            goto fail;
-        m = mpg123_new(NULL,&rc);
-        if (rc != MPG123_OK) goto fail;
-    } else if (rc != MPG123_OK) {
-        goto fail;
-    }
+    if (rc != MPG123_OK) goto fail;
 
     mpg123_param(m,MPG123_REMOVE_FLAGS,MPG123_GAPLESS,0.0); /* wonky support */
     mpg123_param(m,MPG123_RESYNC_LIMIT, -1, 0x10000); /* should be enough */
@@ -312,6 +319,7 @@ static void decode_mpeg_custom(VGMSTREAM * vgmstream, mpeg_codec_data * data, sa
             }
             data->samples_to_discard -= samples_to_discard;
             samples_to_copy -= samples_to_discard;
+            VGM_COUNT(vgmstream, samples_discarded, samples_to_discard);
         }
 
 
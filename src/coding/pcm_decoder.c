@@ -139,7 +139,7 @@ static int expand_ulaw(uint8_t ulawbyte) {
 
 #if 0   // the above follows Sun's implementation, but this works too
     {
-        static int exp_lut[8] = {0,132,396,924,1980,4092,8316,16764}; /* precalcs from bias */
+        static const int exp_lut[8] = {0,132,396,924,1980,4092,8316,16764}; /* precalcs from bias */
         new_sample = exp_lut[segment] + (quantization << (segment + 3));
         if (sign != 0) new_sample = -new_sample;
     }
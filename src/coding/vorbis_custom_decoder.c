@@ -6,8 +6,23 @@
 #include <vorbis/codec.h>
 
 #define VORBIS_DEFAULT_BUFFER_SIZE 0x8000 /* should be at least the size of the setup header, ~0x2000 */
+#define VORBIS_SETUP_CACHE_UNUSED_MAX 8 /* parsed setups kept after their streams are closed */
+
+/* Parsed setups (codebooks and such) are shared between streams, as parsing them is slow and banks
+ * may have hundreds of subsongs using a handful of different setups. Setups are found by their
+ * identification + setup headers, so it works with setups rebuilt from ids or read from files. */
+typedef struct vorbis_setup_entry {
+    vorbis_info vi;             /* fully initialized (decode codebooks built), not modified after */
+    uint32_t hash;
+    uint8_t * headers;          /* id + setup headers, to compare */
+    size_t id_size;
+    size_t headers_size;
+    int refs;                   /* streams using this setup */
+    struct vorbis_setup_entry * next;
+} vorbis_setup_entry;
 
 static void pcm_convert_float_to_16(vorbis_custom_codec_data * data, sample * outbuf, int samples_to_do, float ** pcm);
+static void release_setup_entry(vorbis_setup_entry * entry);
 
 /**
  * Inits a vorbis stream of some custom variety.
@@ -57,8 +72,9 @@ vorbis_custom_codec_data * init_vorbis_custom(STREAMFILE *streamFile, off_t star
 
     data->op.b_o_s = 0; /* end of fake headers */
 
-    /* init vorbis global and block state */
-    if (vorbis_synthesis_init(&data->vd,&data->vi) != 0) goto fail;
+    /* init vorbis global and block state (the shared setup is read-only at this point) */
+    if (!data->setup_entry) goto fail;
+    if (vorbis_synthesis_init(&data->vd,&data->setup_entry->vi) != 0) goto fail;
     if (vorbis_block_init(&data->vd,&data->vb) != 0) goto fail;
 
 
@@ -166,6 +182,157 @@ decode_fail:
     memset(outbuf + samples_done * channels, 0, (samples_to_do - samples_done) * channels * sizeof(sample));
 }
 
+/* ********************************************** */
+
+static vorbis_setup_entry * setup_cache = NULL; /* most recently used first */
+
+static vgm_mutex_t setup_cache_lock = VGM_MUTEX_INIT;
+
+static uint32_t hash_headers(uint32_t hash, const uint8_t * buf, size_t buf_size) {
+    size_t i;
+    for (i = 0; i < buf_size; i++) { /* FNV-1a */
+        hash = (hash ^ buf[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+static void free_setup_entry(vorbis_setup_entry * entry) {
+    vorbis_info_clear(&entry->vi);
+    free(entry->headers);
+    free(entry);
+}
+
+/* find a setup in the cache and move it first, with the cache locked */
+static vorbis_setup_entry * find_setup_entry(uint32_t hash, const uint8_t * id, size_t id_size, const uint8_t * setup, size_t setup_size) {
+    vorbis_setup_entry ** prev = &setup_cache;
+
+    while (*prev) {
+        vorbis_setup_entry * entry = *prev;
+        if (entry->hash == hash && entry->id_size == id_size && entry->headers_size == id_size + setup_size &&
+                memcmp(entry->headers, id, id_size) == 0 && memcmp(entry->headers + id_size, setup, setup_size) == 0) {
+            *prev = entry->next;
+            entry->next = setup_cache;
+            setup_cache = entry;
+            return entry;
+        }
+        prev = &entry->next;
+    }
+    return NULL;
+}
+
+/* parses a new setup, outside the lock as it's the slow part */
+static vorbis_setup_entry * create_setup_entry(uint32_t hash, vorbis_comment * vc, const uint8_t * id, size_t id_size, ogg_packet * setup_op) {
+    vorbis_setup_entry * entry = NULL;
+    vorbis_dsp_state vd;
+    ogg_packet op = {0};
+
+    entry = calloc(1, sizeof(vorbis_setup_entry));
+    if (!entry) goto fail;
+    vorbis_info_init(&entry->vi);
+
+    entry->headers_size = id_size + setup_op->bytes;
+    entry->headers = malloc(entry->headers_size);
+    if (!entry->headers) goto fail;
+    memcpy(entry->headers, id, id_size);
+    memcpy(entry->headers + id_size, setup_op->packet, setup_op->bytes);
+    entry->id_size = id_size;
+    entry->hash = hash;
+
+    op.packet = entry->headers;
+    op.bytes = id_size;
+    op.b_o_s = 1;
+    if (vorbis_synthesis_headerin(&entry->vi, vc, &op) != 0) goto fail;
+    if (vorbis_synthesis_headerin(&entry->vi, vc, setup_op) != 0) goto fail;
+
+    /* the first decoder init builds decode codebooks into the vorbis_info, do it now so it's never
+     * modified by decoders using it (the temp state doesn't own anything in the vorbis_info) */
+    if (vorbis_synthesis_init(&vd, &entry->vi) != 0) goto fail;
+    vorbis_dsp_clear(&vd);
+
+    return entry;
+fail:
+    if (entry) free_setup_entry(entry);
+    return NULL;
+}
+
+static void release_setup_entry(vorbis_setup_entry * entry) {
+    vorbis_setup_entry ** prev;
+    int unused = 0;
+
+    if (!entry)
+        return;
+
+    vgm_mutex_lock(&setup_cache_lock);
+    entry->refs--;
+
+    /* keep a few unused setups around as subsongs are often opened one after another, and free the rest */
+    prev = &setup_cache;
+    while (*prev) {
+        vorbis_setup_entry * current = *prev;
+        if (current->refs == 0 && ++unused > VORBIS_SETUP_CACHE_UNUSED_MAX) {
+            *prev = current->next;
+            free_setup_entry(current);
+            continue;
+        }
+        prev = &current->next;
+    }
+    vgm_mutex_unlock(&setup_cache_lock);
+}
+
+/* Passes the packet in data->op (one of the 3 header packets) to libvorbis. The setup packet is parsed
+ * into a shared setup (or taken from another stream), so it must come after the identification packet. */
+int vorbis_custom_headerin(vorbis_custom_codec_data *data) {
+    vorbis_setup_entry * entry;
+    uint32_t hash;
+
+    if (data->op.bytes <= 0 || data->op.packet[0] != 0x05) {
+        /* identification and comment headers are cheap, but the first is needed to find the setup */
+        if (data->op.bytes > 0 && data->op.packet[0] == 0x01) {
+            if (data->op.bytes > sizeof(data->id_packet))
+                return OV_EBADHEADER;
+            memcpy(data->id_packet, data->op.packet, data->op.bytes);
+            data->id_packet_size = data->op.bytes;
+        }
+        return vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op);
+    }
+
+    if (data->setup_entry || !data->id_packet_size || !data->vc.vendor)
+        return OV_EBADHEADER;
+
+    hash = hash_headers(0x811C9DC5, data->id_packet, data->id_packet_size);
+    hash = hash_headers(hash, data->op.packet, data->op.bytes);
+
+    vgm_mutex_lock(&setup_cache_lock);
+    entry = find_setup_entry(hash, data->id_packet, data->id_packet_size, data->op.packet, data->op.bytes);
+    if (entry)
+        entry->refs++;
+    vgm_mutex_unlock(&setup_cache_lock);
+
+    if (!entry) {
+        vorbis_setup_entry * new_entry = create_setup_entry(hash, &data->vc, data->id_packet, data->id_packet_size, &data->op);
+        if (!new_entry)
+            return OV_EBADHEADER;
+
+        /* another stream may have added the same setup meanwhile */
+        vgm_mutex_lock(&setup_cache_lock);
+        entry = find_setup_entry(hash, data->id_packet, data->id_packet_size, data->op.packet, data->op.bytes);
+        if (!entry) {
+            entry = new_entry;
+            entry->next = setup_cache;
+            setup_cache = entry;
+            new_entry = NULL;
+        }
+        entry->refs++;
+        vgm_mutex_unlock(&setup_cache_lock);
+
+        if (new_entry)
+            free_setup_entry(new_entry);
+    }
+
+    data->setup_entry = entry;
+    return 0;
+}
+
 /* converts from internal Vorbis format to standard PCM (mostly from Xiph's decoder_example.c) */
 static void pcm_convert_float_to_16(vorbis_custom_codec_data * data, sample * outbuf, int samples_to_do, float ** pcm) {
     int i,j;
@@ -193,9 +360,11 @@ void free_vorbis_custom(vorbis_custom_codec_data * data) {
         return;
 
     /* internal decoder cleanp */
+    vorbis_block_clear(&data->vb);
+    vorbis_dsp_clear(&data->vd); /* before the setup, as it's used to free internal state */
+    release_setup_entry(data->setup_entry);
     vorbis_info_clear(&data->vi);
     vorbis_comment_clear(&data->vc);
-    vorbis_dsp_clear(&data->vd);
 
     free(data->buffer);
     free(data);
@@ -37,15 +37,15 @@ int vorbis_custom_setup_init_fsb(STREAMFILE *streamFile, off_t start_offset, vor
 
     data->op.bytes = build_header_identification(data->buffer, data->buffer_size, cfg.channels, cfg.sample_rate, 256, 2048); /* FSB default block sizes */
     if (!data->op.bytes) goto fail;
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse identification header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse identification header */
 
     data->op.bytes = build_header_comment(data->buffer, data->buffer_size);
     if (!data->op.bytes) goto fail;
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) !=0 ) goto fail; /* parse comment header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse comment header */
 
     data->op.bytes = build_header_setup(data->buffer, data->buffer_size, cfg.setup_id, streamFile);
     if (!data->op.bytes) goto fail;
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse setup header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse setup header */
 
     return 1;
 
@@ -187,12 +187,12 @@ static int load_fvs_file_single(uint8_t * buf, size_t bufsize, uint32_t setup_id
         if (read_streamfile(buf, 0, bytes, streamFileSetup) != bytes)
             goto fail;
 
-        streamFileSetup->close(streamFileSetup);
+        close_streamfile(streamFileSetup);
         return bytes;
     }
 
 fail:
-    if (streamFileSetup) streamFileSetup->close(streamFileSetup);
+    if (streamFileSetup) close_streamfile(streamFileSetup);
     return 0;
 }
 
@@ -238,12 +238,12 @@ static int load_fvs_file_multi(uint8_t * buf, size_t bufsize, uint32_t setup_id,
         if (read_streamfile(buf, offset, size, streamFileSetup) != size)
             goto fail;
 
-        streamFileSetup->close(streamFileSetup);
+        close_streamfile(streamFileSetup);
         return size;
     }
 
 fail:
-    if (streamFileSetup) streamFileSetup->close(streamFileSetup);
+    if (streamFileSetup) close_streamfile(streamFileSetup);
     return 0;
 }
 
@@ -22,21 +22,21 @@ int vorbis_custom_setup_init_ogl(STREAMFILE *streamFile, off_t start_offset, vor
     packet_size = (uint16_t)read_16bitLE(offset, streamFile) >> 2;
     if (packet_size > data->buffer_size) goto fail;
     data->op.bytes = read_streamfile(data->buffer,offset+2,packet_size, streamFile);
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse identification header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse identification header */
     offset += 2+packet_size;
 
     /* normal comment packet */
     packet_size = (uint16_t)read_16bitLE(offset, streamFile) >> 2;
     if (packet_size > data->buffer_size) goto fail;
     data->op.bytes = read_streamfile(data->buffer,offset+2,packet_size, streamFile);
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) !=0 ) goto fail; /* parse comment header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse comment header */
     offset += 2+packet_size;
 
     /* normal setup packet */
     packet_size = (uint16_t)read_16bitLE(offset, streamFile) >> 2;
     if (packet_size > data->buffer_size) goto fail;
     data->op.bytes = read_streamfile(data->buffer,offset+2,packet_size, streamFile);
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse setup header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse setup header */
     offset += 2+packet_size;
 
     /* data starts after triad */
@@ -45,15 +45,15 @@ int vorbis_custom_setup_init_sk(STREAMFILE *streamFile, off_t start_offset, vorb
     /* init with all offsets found */
     data->op.bytes = build_header(data->buffer, data->buffer_size, streamFile, id_offset, id_size);
     if (!data->op.bytes) goto fail;
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse identification header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse identification header */
 
     data->op.bytes = build_header(data->buffer, data->buffer_size, streamFile, comment_offset, comment_size);
     if (!data->op.bytes) goto fail;
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) !=0 ) goto fail; /* parse comment header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse comment header */
 
     data->op.bytes = build_header(data->buffer, data->buffer_size, streamFile, setup_offset, setup_size);
     if (!data->op.bytes) goto fail;
-    if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse setup header */
+    if (vorbis_custom_headerin(data) != 0) goto fail; /* parse setup header */
 
     /* data starts after triad */
     data->config.data_start_offset = offset;
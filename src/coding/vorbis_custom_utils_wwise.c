@@ -55,21 +55,21 @@ int vorbis_custom_setup_init_wwise(STREAMFILE *streamFile, off_t start_offset, v
         header_size = get_packet_header(streamFile, offset, cfg.header_type, (int*)&data->op.granulepos, &packet_size, cfg.big_endian);
         if (!header_size || packet_size > data->buffer_size) goto fail;
         data->op.bytes = read_streamfile(data->buffer,offset+header_size,packet_size, streamFile);
-        if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse identification header */
+        if (vorbis_custom_headerin(data) != 0) goto fail; /* parse identification header */
         offset += header_size + packet_size;
 
         /* normal comment packet */
         header_size = get_packet_header(streamFile, offset, cfg.header_type, (int*)&data->op.granulepos, &packet_size, cfg.big_endian);
         if (!header_size || packet_size > data->buffer_size) goto fail;
         data->op.bytes = read_streamfile(data->buffer,offset+header_size,packet_size, streamFile);
-        if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) !=0 ) goto fail; /* parse comment header */
+        if (vorbis_custom_headerin(data) != 0) goto fail; /* parse comment header */
         offset += header_size + packet_size;
 
         /* normal setup packet */
         header_size = get_packet_header(streamFile, offset, cfg.header_type, (int*)&data->op.granulepos, &packet_size, cfg.big_endian);
         if (!header_size || packet_size > data->buffer_size) goto fail;
         data->op.bytes = read_streamfile(data->buffer,offset+header_size,packet_size, streamFile);
-        if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse setup header */
+        if (vorbis_custom_headerin(data) != 0) goto fail; /* parse setup header */
         offset += header_size + packet_size;
     }
     else {
@@ -78,17 +78,17 @@ int vorbis_custom_setup_init_wwise(STREAMFILE *streamFile, off_t start_offset, v
         /* new identificacion packet */
         data->op.bytes = build_header_identification(data->buffer, data->buffer_size, cfg.channels, cfg.sample_rate, cfg.blocksize_0_exp, cfg.blocksize_1_exp);
         if (!data->op.bytes) goto fail;
-        if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse identification header */
+        if (vorbis_custom_headerin(data) != 0) goto fail; /* parse identification header */
 
         /* new comment packet */
         data->op.bytes = build_header_comment(data->buffer, data->buffer_size);
         if (!data->op.bytes) goto fail;
-        if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) !=0 ) goto fail; /* parse comment header */
+        if (vorbis_custom_headerin(data) != 0) goto fail; /* parse comment header */
 
         /* rebuild setup packet */
         data->op.bytes = rebuild_setup(data->buffer, data->buffer_size, streamFile, start_offset, data, cfg.big_endian, cfg.channels);
         if (!data->op.bytes) goto fail;
-        if (vorbis_synthesis_headerin(&data->vi, &data->vc, &data->op) != 0) goto fail; /* parse setup header */
+        if (vorbis_custom_headerin(data) != 0) goto fail; /* parse setup header */
     }
 
     return 1;
@@ -1148,14 +1148,14 @@ static int load_wvc_file(uint8_t * buf, size_t bufsize, uint32_t codebook_id, ST
 
         if (read_streamfile(buf, codebook_offset, codebook_size, streamFileWvc) != codebook_size)
             goto fail;
-        streamFileWvc->close(streamFileWvc);
+        close_streamfile(streamFileWvc);
 
         return codebook_size;
     }
 
 
 fail:
-    if (streamFileWvc) streamFileWvc->close(streamFileWvc);
+    if (streamFileWvc) close_streamfile(streamFileWvc);
     return 0;
 }
 
@@ -2,7 +2,8 @@
 
 
 /* Defines the list of accepted extensions. vgmstream doesn't use it internally so it's here
- * to inform plugins that need it. Common extensions are commented out to avoid stealing them. */
+ * to inform plugins that need it. Common extensions are commented out to avoid stealing them.
+ * Must be lowercase and sorted (strcmp order), as it's binary searched by vgmstream_ctx_is_valid. */
 
 /* Some extensions require external libraries and could be #ifdef, not worth. */
 
@@ -18,9 +19,9 @@ static const char* extension_list[] = {
     "2pfs",
     "800",
 
-    //"aac", //common
     "aa3", //FFmpeg/not parsed (ATRAC3/ATRAC3PLUS/MP3/LPCM/WMA)
     "aaap",
+    //"aac", //common
     "aax",
     "abk",
     //"ac3", //common, FFmpeg/not parsed (AC3)
@@ -37,8 +38,8 @@ static const char* extension_list[] = {
     "adx",
     "afc",
     "agsc",
-    "ahx",
     "ahv",
+    "ahx",
     "ai",
     //"aif", //common
     "aifc", //common?
@@ -83,8 +84,8 @@ static const char* extension_list[] = {
     "bgw",
     "bh2pcm",
     "bik",
-    "bika",
     "bik2",
+    "bika",
     "bk2",
     "bmdx",
     "bms",
@@ -185,8 +186,8 @@ static const char* extension_list[] = {
     "isd",
     "isws",
     "itl",
-    "ivaud",
     "ivag",
+    "ivaud",
     "ivb",
     "ivs", //txth/reserved [Burnout 2 (PS2)]
 
@@ -197,8 +198,8 @@ static const char* extension_list[] = {
     "kcey", //fake extension/header id for .pcm (renamed, to be removed)
     "khv", //fake extension/header id for .vas (renamed, to be removed)
     "km9",
-    "kovs", //fake extension/header id for .kvs
     "kns",
+    "kovs", //fake extension/header id for .kvs
     "kraw",
     "ktss", //fake extension/header id for .kns
     "kvs",
@@ -253,8 +254,8 @@ static const char* extension_list[] = {
     //"mp3", //common
     //"mp4", //common
     //"mpc", //common
-    "mpdsp",
     "mpds",
+    "mpdsp",
     "mpf",
     "mps", //txth/reserved [Scandal (PS2)]
     "ms",
@@ -350,17 +351,9 @@ static const char* extension_list[] = {
     "sb5",
     "sb6",
     "sb7",
+    "sbin",
     "sbr",
     "sbv",
-    "sm0",
-    "sm1",
-    "sm2",
-    "sm3",
-    "sm4",
-    "sm5",
-    "sm6",
-    "sm7",
-    "sbin",
     "sc",
     "scd",
     "sck",
@@ -378,6 +371,14 @@ static const char* extension_list[] = {
     "sl3",
     "slb", //txth/reserved [THE Nekomura no Hitobito (PS2)]
     "sli",
+    "sm0",
+    "sm1",
+    "sm2",
+    "sm3",
+    "sm4",
+    "sm5",
+    "sm6",
+    "sm7",
     "smc",
     "smp",
     "smpl", //fake extension/header id for .v0/v1 (renamed, to be removed)
@@ -409,12 +410,12 @@ static const char* extension_list[] = {
     "sts",
     "stx",
     "svag",
-    "svs",
     "svg",
+    "svs",
     "swag",
     "swav",
     "swd",
-    "switch_audio"
+    "switch_audio",
     "sx",
     "sxd",
     "sxd2",
@@ -445,8 +446,9 @@ static const char* extension_list[] = {
     "vb",
     "vbk",
     "vbx", //txth/reserved [THE Taxi 2 (PS2)]
-    "vds",
     "vdm",
+    "vds",
+    "vgmstream", //fake extension, catch-all for FFmpeg/txth/etc
     "vgs",
     "vgv",
     "vig",
@@ -496,18 +498,18 @@ static const char* extension_list[] = {
     "xau",
     "xma",
     "xma2",
+    "xmd",
     "xmu",
     "xnb",
-    "xsf",
+    "xopus",
+    "xps",
     "xsew",
+    "xsf",
     "xss",
     "xvag",
     "xvas",
     "xwav",//fake extension for .wav (renamed, to be removed)
     "xwb",
-    "xmd",
-    "xopus",
-    "xps",
     "xwc",
     "xwm",
     "xwma",
@@ -522,8 +524,6 @@ static const char* extension_list[] = {
     "zss",
     "zwdsp",
 
-    "vgmstream" /* fake extension, catch-all for FFmpeg/txth/etc */
-
     //, NULL //end mark
 };
 
@@ -88,6 +88,16 @@ void render_vgmstream_blocked(sample * buffer, int32_t sample_count, VGMSTREAM *
     }
 }
 
+/* reads up to size bytes of a block header (not an error if it's cut at EOF, getters handle it) */
+void read_block_header(block_header_t * header, off_t offset, size_t size, STREAMFILE * streamFile) {
+    if (size > BLOCK_HEADER_MAX)
+        size = BLOCK_HEADER_MAX;
+
+    header->streamfile = streamFile;
+    header->offset = offset;
+    header->size = (offset < 0) ? 0 : read_streamfile(header->data, offset, size, streamFile);
+}
+
 /* helper functions to parse new block */
 void block_update(off_t block_offset, VGMSTREAM * vgmstream) {
     switch (vgmstream->layout_type) {
@@ -4,18 +4,20 @@
 #include "../vgmstream.h"
 
 
-static size_t get_block_header_size(STREAMFILE *streamFile, off_t offset, int channels, int big_endian);
+static size_t get_block_header_size(block_header_t * header, int channels, int big_endian);
 
 /* AWC music chunks  */
 void block_update_awc(off_t block_offset, VGMSTREAM * vgmstream) {
     STREAMFILE* streamFile = vgmstream->ch[0].streamfile;
-    int32_t (*read_32bit)(off_t,STREAMFILE*) = vgmstream->codec_endian ? read_32bitBE : read_32bitLE;
+    int32_t (*get_32bit)(block_header_t*,off_t) = vgmstream->codec_endian ? get_block_32bitBE : get_block_32bitLE;
     size_t header_size, entries, block_size, block_samples;
+    block_header_t header;
     int i;
 
     /* assumed only AWC_IMA enters here, MPEG/XMA2 need special parsing as blocked layout is too limited */
 
-    entries = read_32bit(block_offset + 0x18*0 + 0x04, streamFile); /* assumed same for all channels */
+    read_block_header(&header, block_offset, 0x18*vgmstream->channels, streamFile);
+    entries = get_32bit(&header, 0x18*0 + 0x04); /* assumed same for all channels */
     block_samples = entries * (0x800-4)*2;
     block_size = vgmstream->full_block_size;
 
@@ -35,22 +37,22 @@ void block_update_awc(off_t block_offset, VGMSTREAM * vgmstream) {
      *   32b * entries = global samples per frame in each block (for MPEG probably per full frame)
      */
 
-    header_size = get_block_header_size(streamFile, block_offset, vgmstream->channels, vgmstream->codec_endian);
+    header_size = get_block_header_size(&header, vgmstream->channels, vgmstream->codec_endian);
     for (i = 0; i < vgmstream->channels; i++) {
         vgmstream->ch[i].offset = block_offset + header_size + 0x800*entries*i;
     }
 
 }
 
-static size_t get_block_header_size(STREAMFILE *streamFile, off_t offset, int channels, int big_endian) {
+static size_t get_block_header_size(block_header_t * header, int channels, int big_endian) {
     size_t header_size = 0;
     int i;
     int entries = channels;
-    int32_t (*read_32bit)(off_t,STREAMFILE*) = big_endian ? read_32bitBE : read_32bitLE;
+    int32_t (*get_32bit)(block_header_t*,off_t) = big_endian ? get_block_32bitBE : get_block_32bitLE;
 
     for (i = 0; i < entries; i++) {
         header_size += 0x18;
-        header_size += read_32bit(offset + 0x18*i + 0x04, streamFile) * 0x04; /* entries in the table */
+        header_size += get_32bit(header, 0x18*i + 0x04) * 0x04; /* entries in the table */
     }
 
     if (header_size % 0x800) /* padded */
@@ -5,17 +5,20 @@
 void block_update_caf(off_t block_offset, VGMSTREAM * vgmstream) {
     STREAMFILE* streamFile = vgmstream->ch[0].streamfile;
     int i,ch;
+    block_header_t header;
+
+    read_block_header(&header, block_offset, 0x34 + 0x2c*vgmstream->channels, streamFile);
 
     vgmstream->current_block_offset = block_offset;
-    vgmstream->next_block_offset = block_offset + read_32bitBE(block_offset+0x04, streamFile);
-    vgmstream->current_block_size = read_32bitBE(block_offset+0x14, streamFile);
+    vgmstream->next_block_offset = block_offset + get_block_32bitBE(&header, 0x04);
+    vgmstream->current_block_size = get_block_32bitBE(&header, 0x14);
 
     for (ch = 0; ch < vgmstream->channels; ch++) {
-        vgmstream->ch[ch].offset = block_offset + read_32bitBE(block_offset+0x10+(0x08*ch), streamFile);
+        vgmstream->ch[ch].offset = block_offset + get_block_32bitBE(&header, 0x10+(0x08*ch));
 
         /* re-read coeffs (though blocks seem to repeat them) */
         for (i = 0; i < 16; i++) {
-            vgmstream->ch[ch].adpcm_coef[i] = read_16bitBE(block_offset+0x34 + 0x2c*ch + 0x02*i, streamFile);
+            vgmstream->ch[ch].adpcm_coef[i] = get_block_16bitBE(&header, 0x34 + 0x2c*ch + 0x02*i);
         }
     }
 }
@@ -7,7 +7,8 @@ void block_update_ea_1snh(off_t block_offset, VGMSTREAM * vgmstream) {
     STREAMFILE* streamFile = vgmstream->ch[0].streamfile;
     int i;
     size_t block_size = 0, block_header = 0;
-    int32_t (*read_32bit)(off_t,STREAMFILE*) = vgmstream->codec_endian ? read_32bitBE : read_32bitLE;
+    block_header_t header;
+    int32_t (*get_32bit)(block_header_t*,off_t) = vgmstream->codec_endian ? get_block_32bitBE : get_block_32bitLE;
     size_t file_size = get_streamfile_size(streamFile);
 
 
@@ -21,19 +22,22 @@ void block_update_ea_1snh(off_t block_offset, VGMSTREAM * vgmstream) {
 
 
     while (block_offset < file_size) {
-        uint32_t id = read_32bitBE(block_offset+0x00,streamFile);
+        uint32_t id;
+        int32_t size_le, size_be;
+
+        read_block_header(&header, block_offset, 0x0c, streamFile);
+        id = get_block_32bitBE(&header, 0x00);
 
         /* BE in SAT, but one file may have both BE and LE chunks [FIFA 98 (SAT): movie LE, audio BE] */
-        if (guess_endianness32bit(block_offset+0x04,streamFile))
-            block_size = read_32bitBE(block_offset+0x04,streamFile);
-        else
-            block_size = read_32bitLE(block_offset+0x04,streamFile);
+        size_le = get_block_32bitLE(&header, 0x04);
+        size_be = get_block_32bitBE(&header, 0x04);
+        block_size = ((uint32_t)size_le > (uint32_t)size_be) ? size_be : size_le;
 
         block_header = 0;
 
         if (id == 0x31534E68 || id == 0x53454144) {  /* "1SNh" "SEAD" audio header */
             int is_sead = (id == 0x53454144);
-            int is_eacs = read_32bitBE(block_offset+0x08, streamFile) == 0x45414353;
+            int is_eacs = get_block_32bitBE(&header, 0x08) == 0x45414353;
 
             block_header = is_eacs ? 0x28 : (is_sead ? 0x14 : 0x2c);
             if (block_header >= block_size) /* sometimes has audio data after header */
@@ -87,13 +91,14 @@ void block_update_ea_1snh(off_t block_offset, VGMSTREAM * vgmstream) {
 
         case coding_DVI_IMA:
             if (vgmstream->codec_config == 1) { /* ADPCM hist */
-                vgmstream->current_block_samples = read_32bit(block_offset + block_header, streamFile);
+                read_block_header(&header, block_offset + block_header, 0x04 + 0x08*vgmstream->channels, streamFile);
+                vgmstream->current_block_samples = get_32bit(&header, 0x00);
                 vgmstream->current_block_size = 0; // - (0x04 + 0x08*vgmstream->channels); /* should be equivalent */
 
                 for(i = 0; i < vgmstream->channels; i++) {
                     off_t adpcm_offset = block_offset + block_header + 0x04;
-                    vgmstream->ch[i].adpcm_step_index  = read_32bit(adpcm_offset + i*0x04 + 0x00*vgmstream->channels, streamFile);
-                    vgmstream->ch[i].adpcm_history1_32 = read_32bit(adpcm_offset + i*0x04 + 0x04*vgmstream->channels, streamFile);
+                    vgmstream->ch[i].adpcm_step_index  = get_32bit(&header, 0x04 + i*0x04 + 0x00*vgmstream->channels);
+                    vgmstream->ch[i].adpcm_history1_32 = get_32bit(&header, 0x04 + i*0x04 + 0x04*vgmstream->channels);
                     vgmstream->ch[i].offset = adpcm_offset + 0x08*vgmstream->channels;
                 }
 
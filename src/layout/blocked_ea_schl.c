@@ -8,7 +8,8 @@ void block_update_ea_schl(off_t block_offset, VGMSTREAM * vgmstream) {
     int i;
     int new_schl = 0;
     size_t block_size, block_samples;
-    int32_t (*read_32bit)(off_t,STREAMFILE*) = vgmstream->codec_endian ? read_32bitBE : read_32bitLE;
+    block_header_t header;
+    int32_t (*get_32bit)(block_header_t*,off_t) = vgmstream->codec_endian ? get_block_32bitBE : get_block_32bitLE;
 
 
     /* EOF reads: signal we have nothing and let the layout fail */
@@ -19,14 +20,15 @@ void block_update_ea_schl(off_t block_offset, VGMSTREAM * vgmstream) {
         return;
     }
 
-    /* read a single block */
+    /* read a single block (id, size, samples and per-channel values, blocks can be small so read all at once) */
+    read_block_header(&header, block_offset, 0x0c + 0x04*vgmstream->channels, streamFile);
     {
-        uint32_t block_id = read_32bitBE(block_offset+0x00,streamFile);
+        uint32_t block_id = get_block_32bitBE(&header, 0x00);
 
         if (vgmstream->codec_config & 0x02) /* size is always LE, except in early SS/MAC */
-            block_size = read_32bitBE(block_offset + 0x04,streamFile);
+            block_size = get_block_32bitBE(&header, 0x04);
         else
-            block_size = read_32bitLE(block_offset + 0x04,streamFile);
+            block_size = get_block_32bitLE(&header, 0x04);
 
         switch(block_id) {
             case 0x5343446C: /* "SCDl" */
@@ -46,7 +48,7 @@ void block_update_ea_schl(off_t block_offset, VGMSTREAM * vgmstream) {
                 if (vgmstream->coding_type == coding_PSX)
                     block_samples = ps_bytes_to_samples(block_size-0x10, vgmstream->channels);
                 else
-                    block_samples = read_32bit(block_offset+0x08,streamFile);
+                    block_samples = get_32bit(&header, 0x08);
                 break;
             default:
                 /* ignore other chunks (audio "SCHl/SCCl/...", video "pIQT/MADk/...", etc) */
@@ -102,9 +104,9 @@ void block_update_ea_schl(off_t block_offset, VGMSTREAM * vgmstream) {
         /* id, size, IMA hist, stereo/mono data */
         case coding_DVI_IMA:
             for(i = 0; i < vgmstream->channels; i++) {
-                off_t header_offset = block_offset + 0xc + i*4;
-                vgmstream->ch[i].adpcm_history1_32 = read_16bitLE(header_offset+0x00, vgmstream->ch[i].streamfile);
-                vgmstream->ch[i].adpcm_step_index  = read_16bitLE(header_offset+0x02, vgmstream->ch[i].streamfile);
+                off_t header_offset = 0xc + i*4;
+                vgmstream->ch[i].adpcm_history1_32 = get_block_16bitLE(&header, header_offset+0x00);
+                vgmstream->ch[i].adpcm_step_index  = get_block_16bitLE(&header, header_offset+0x02);
                 vgmstream->ch[i].offset = block_offset + 0xc + (4*vgmstream->channels);
             }
 
@@ -142,7 +144,7 @@ void block_update_ea_schl(off_t block_offset, VGMSTREAM * vgmstream) {
         /* id, size, samples, offsets-per-channel, flag (0x01 = data start), data */
         case coding_EA_MT:
             for (i = 0; i < vgmstream->channels; i++) {
-                off_t channel_start = read_32bit(block_offset + 0x0C + (0x04*i),streamFile);
+                off_t channel_start = get_32bit(&header, 0x0C + (0x04*i));
                 vgmstream->ch[i].offset = block_offset + 0x0C + (0x04*vgmstream->channels) + channel_start + 0x01;
             }
 
@@ -162,9 +164,9 @@ void block_update_ea_schl(off_t block_offset, VGMSTREAM * vgmstream) {
 
                 /* EALayer3 6ch uses 1ch*6 with offsets, no flag in header [Medal of Honor 2010 (PC) movies] */
                 if (vgmstream->channels > 2) {
-                    channel_start = read_32bit(block_offset + 0x0C + 0x04*i,streamFile);
+                    channel_start = get_32bit(&header, 0x0C + 0x04*i);
                 } else {
-                    channel_start = read_32bit(block_offset + 0x0C,streamFile);
+                    channel_start = get_32bit(&header, 0x0C);
                 }
 
                 vgmstream->ch[i].offset = block_offset + 0x0C + (0x04*vgmstream->channels) + channel_start;
@@ -180,7 +182,7 @@ void block_update_ea_schl(off_t block_offset, VGMSTREAM * vgmstream) {
         /* id, size, samples, offsets-per-channel, interleaved data (w/ optional hist per channel) */
         default:
             for (i = 0; i < vgmstream->channels; i++) {
-                off_t channel_start = read_32bit(block_offset + 0x0C + (0x04*i),streamFile);
+                off_t channel_start = get_32bit(&header, 0x0C + (0x04*i));
                 vgmstream->ch[i].offset = block_offset + 0x0C + (0x04*vgmstream->channels) + channel_start;
             }
 
@@ -9,6 +9,7 @@ void block_update_ea_sns(off_t block_offset, VGMSTREAM * vgmstream) {
     size_t file_size = get_streamfile_size(streamFile);
     off_t channel_start;
     size_t channel_interleave;
+    block_header_t header;
     int i;
 
     /* EOF reads: signal we have nothing and let the layout fail */
@@ -20,7 +21,8 @@ void block_update_ea_sns(off_t block_offset, VGMSTREAM * vgmstream) {
     }
 
     /* always BE */
-    block_size = read_32bitBE(block_offset + 0x00,streamFile);
+    read_block_header(&header, block_offset, 0x08 + 0x10, streamFile);
+    block_size = get_block_32bitBE(&header, 0x00);
 
     /* At 0x00(1): block flag
      * - in SNS: 0x00=normal block, 0x80=last block (not mandatory)
@@ -29,7 +31,7 @@ void block_update_ea_sns(off_t block_offset, VGMSTREAM * vgmstream) {
     block_size &= 0x00FFFFFF;
 
     if (block_id == 0x00 || block_id == 0x80 || block_id == 0x44) {
-        block_samples = read_32bitBE(block_offset + 0x04, streamFile);
+        block_samples = get_block_32bitBE(&header, 0x04);
     } else {
         block_samples = 0;
     }
@@ -45,8 +47,8 @@ void block_update_ea_sns(off_t block_offset, VGMSTREAM * vgmstream) {
     switch (vgmstream->coding_type) {
         case coding_NGC_DSP:
             /* 0x04: unknown (0x00/02), 0x08: some size?, 0x34: null? */
-            channel_start = read_32bitBE(block_offset + 0x08 + 0x00, streamFile);
-            channel_interleave = read_32bitBE(block_offset + 0x08 + 0x0c, streamFile);
+            channel_start = get_block_32bitBE(&header, 0x08 + 0x00);
+            channel_interleave = get_block_32bitBE(&header, 0x08 + 0x0c);
             /* guessed as all known EA DSP only have one block with subheader (maybe changes coefs every block?) */
             if (channel_start >= 0x40) {
                 dsp_read_coefs_be(vgmstream, streamFile, block_offset + 0x08 + 0x10, 0x28);
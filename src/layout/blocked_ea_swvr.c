@@ -7,23 +7,25 @@ void block_update_ea_swvr(off_t block_offset, VGMSTREAM * vgmstream) {
     int i;
     size_t block_size, header_size = 0, channel_size = 0, interleave = 0;
     uint32_t block_id;
-    int32_t (*read_32bit)(off_t,STREAMFILE*) = vgmstream->codec_endian ? read_32bitBE : read_32bitLE;
-    int16_t (*read_16bit)(off_t,STREAMFILE*) = vgmstream->codec_endian ? read_16bitBE : read_16bitLE;
+    block_header_t header;
+    int32_t (*get_32bit)(block_header_t*,off_t) = vgmstream->codec_endian ? get_block_32bitBE : get_block_32bitLE;
+    int16_t (*get_16bit)(block_header_t*,off_t) = vgmstream->codec_endian ? get_block_16bitBE : get_block_16bitLE;
 
-    block_id   = read_32bit(block_offset+0x00, streamFile);
-    block_size = read_32bit(block_offset+0x04, streamFile);
+    read_block_header(&header, block_offset, 0x1c, streamFile);
+    block_id   = get_32bit(&header, 0x00);
+    block_size = get_32bit(&header, 0x04);
 
     /* parse blocks (Freekstyle uses multiblocks) */
     switch(block_id) {
         case 0x5641474D: /* "VAGM" */
-            if (read_16bit(block_offset+0x1a, streamFile) == 0x0024) {
+            if (get_16bit(&header, 0x1a) == 0x0024) {
                 header_size = 0x40;
                 channel_size = (block_size - header_size) / vgmstream->channels;
 
                 /* ignore blocks of other subsongs */
                 {
                     int target_subsong = vgmstream->stream_index ? vgmstream->stream_index : 1;
-                    if (read_32bit(block_offset+0x0c, streamFile)+1 != target_subsong) {
+                    if (get_32bit(&header, 0x0c)+1 != target_subsong) {
                         channel_size = 0;
                     }
                 }
@@ -33,7 +35,7 @@ void block_update_ea_swvr(off_t block_offset, VGMSTREAM * vgmstream) {
             }
             break;
         case 0x56414742: /* "VAGB" */
-            if (read_16bit(block_offset+0x1a, streamFile) == 0x6400) {
+            if (get_16bit(&header, 0x1a) == 0x6400) {
                 header_size = 0x40;
             } else {
                 header_size = 0x18;
@@ -48,7 +50,7 @@ void block_update_ea_swvr(off_t block_offset, VGMSTREAM * vgmstream) {
             /* ignore blocks of other subsongs */
             {
                 int target_subsong = vgmstream->stream_index ? vgmstream->stream_index : 1;
-                if (read_32bit(block_offset+0x0c, streamFile)+1 != target_subsong) {
+                if (get_32bit(&header, 0x0c)+1 != target_subsong) {
                     channel_size = 0;
                 }
             }
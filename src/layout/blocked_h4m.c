@@ -7,13 +7,15 @@ void block_update_h4m(off_t block_offset, VGMSTREAM * vgmstream) {
     STREAMFILE* streamFile = vgmstream->ch[0].streamfile;
     int i;
     size_t block_size, block_samples;
+    block_header_t header;
 
+    read_block_header(&header, block_offset, 0x0c, streamFile);
 
     /* use full_block_size as counter (a bit hacky but whatevs) */
     if (vgmstream->full_block_size <= 0) {
         /* new full block */
         /* 0x00: last_full_block_size */
-        uint32_t full_block_size      = read_32bitBE(block_offset+0x04, streamFile);
+        uint32_t full_block_size      = get_block_32bitBE(&header, 0x04);
         /* 0x08: vid_frame_count */
         /* 0x0c: aud_frame_count */
         /* 0x10: block_header_unk (0x01000000, except 0 in a couple of Bomberman Jetters files) */
@@ -24,14 +26,14 @@ void block_update_h4m(off_t block_offset, VGMSTREAM * vgmstream) {
     }
     else {
         /* new audio or video frames in the current full block */
-        uint16_t frame_type = read_16bitBE(block_offset+0x00, streamFile);
-        uint16_t frame_format = read_16bitBE(block_offset+0x02, streamFile);
-        uint32_t frame_size = read_32bitBE(block_offset+0x04, streamFile); /* not including 0x08 frame header */
+        uint16_t frame_type = get_block_16bitBE(&header, 0x00);
+        uint16_t frame_format = get_block_16bitBE(&header, 0x02);
+        uint32_t frame_size = get_block_32bitBE(&header, 0x04); /* not including 0x08 frame header */
 
 
         if (frame_type == 0x00) {
             /* HVQM4_AUDIO (there are more checks with frame_format but not too relevant for vgmstream) */
-            uint32_t frame_samples = read_32bitBE(block_offset+0x08, streamFile);
+            uint32_t frame_samples = get_block_32bitBE(&header, 0x08);
             size_t block_skip;
 
             if (vgmstream->codec_config & 0x80) {
@@ -7,6 +7,7 @@ void block_update_ivaud(off_t block_offset, VGMSTREAM * vgmstream) {
     size_t header_size, block_samples;
     int i;
     off_t seek_info_offset;
+    block_header_t header;
 
     /* base header */
     seek_info_offset = read_32bitLE(block_offset+0x00,streamFile); /*64b */
@@ -33,9 +34,10 @@ void block_update_ivaud(off_t block_offset, VGMSTREAM * vgmstream) {
         header_size = 0x800;
 
     /* get max data_size as channels may vary slightly (data is padded, hopefully won't create pops) */
+    read_block_header(&header, block_offset + seek_info_offset, 0x10*vgmstream->channels, streamFile);
     block_samples = 0;
     for(i = 0;i < vgmstream->channels; i++) {
-        size_t channel_samples = read_32bitLE(block_offset + seek_info_offset+0x0c + 0x10*i,streamFile);
+        size_t channel_samples = get_block_32bitLE(&header, 0x0c + 0x10*i);
         if (block_samples < channel_samples)
             block_samples = channel_samples;
     }
@@ -47,7 +49,7 @@ void block_update_ivaud(off_t block_offset, VGMSTREAM * vgmstream) {
 
     for(i = 0; i < vgmstream->channels; i++) {
         /* use seek table's start entry to find channel offset */
-        size_t interleave_size = read_32bitLE(block_offset + seek_info_offset+0x00 + 0x10*i,streamFile) * 0x800;
+        size_t interleave_size = get_block_32bitLE(&header, 0x00 + 0x10*i) * 0x800;
         vgmstream->ch[i].offset = block_offset + header_size + interleave_size;
     }
 }
@@ -9,6 +9,8 @@ void block_update_str_snds(off_t block_offset, VGMSTREAM * vgmstream) {
     STREAMFILE *streamfile;
     int FoundSSMP = 0;
     off_t SSMP_offset = -1;
+    int32_t SSMP_size = 0;
+    block_header_t header;
 
     current_chunk = block_offset;
     streamfile = vgmstream->ch[0].streamfile;
@@ -16,14 +18,20 @@ void block_update_str_snds(off_t block_offset, VGMSTREAM * vgmstream) {
 
     /* we may have to skip some chunks */
     while (!FoundSSMP && current_chunk < file_size) {
-        if (current_chunk+read_32bitBE(current_chunk+4,streamfile)>=file_size)
+        int32_t chunk_size;
+
+        read_block_header(&header, current_chunk, 0x14, streamfile);
+        chunk_size = get_block_32bitBE(&header, 0x04);
+
+        if (current_chunk+chunk_size>=file_size)
             break;
-        switch (read_32bitBE(current_chunk,streamfile)) {
+        switch (get_block_32bitBE(&header, 0x00)) {
             case 0x534e4453:    /* SNDS */
                 /* SSMP */
-                if (read_32bitBE(current_chunk+0x10,streamfile)==0x53534d50) {
+                if (get_block_32bitBE(&header, 0x10)==0x53534d50) {
                     FoundSSMP = 1;
                     SSMP_offset = current_chunk;
+                    SSMP_size = chunk_size;
                 }
                 break;
             case 0x46494c4c:    /* FILL, the main culprit */
@@ -31,22 +39,19 @@ void block_update_str_snds(off_t block_offset, VGMSTREAM * vgmstream) {
                 break;
         }
 
-        current_chunk += read_32bitBE(current_chunk+4,streamfile);
+        current_chunk += chunk_size;
     }
 
     if (!FoundSSMP) {
         /* if we couldn't find it all we can do is try playing the current
          * block, which is going to suck */
         vgmstream->current_block_offset = block_offset;
+        SSMP_size = read_32bitBE(SSMP_offset+4, streamfile);
     }
 
     vgmstream->current_block_offset = SSMP_offset;
-    vgmstream->current_block_size = (read_32bitBE(
-            vgmstream->current_block_offset+4,
-            vgmstream->ch[0].streamfile) - 0x18) / vgmstream->channels;
-    vgmstream->next_block_offset = vgmstream->current_block_offset +
-            read_32bitBE(vgmstream->current_block_offset+4,
-                    vgmstream->ch[0].streamfile);
+    vgmstream->current_block_size = (SSMP_size - 0x18) / vgmstream->channels;
+    vgmstream->next_block_offset = vgmstream->current_block_offset + SSMP_size;
 
     for (i = 0; i < vgmstream->channels; i++) {
         vgmstream->ch[i].offset = vgmstream->current_block_offset + 0x18 + i * vgmstream->interleave_block_size;
@@ -7,25 +7,31 @@ void block_update_thp(off_t block_offset, VGMSTREAM * vgmstream) {
 	STREAMFILE *streamFile=vgmstream->ch[0].streamfile;
 	off_t	start_offset;
 	int32_t	nextFrameSize;
+	block_header_t header;
+
+	read_block_header(&header, block_offset, 0x0c, streamFile);
 
 	vgmstream->current_block_offset = block_offset;
-	nextFrameSize=read_32bitBE(vgmstream->current_block_offset,streamFile);
+	nextFrameSize=get_block_32bitBE(&header, 0x00);
 
 	vgmstream->next_block_offset = vgmstream->current_block_offset
 		                         + vgmstream->full_block_size;
 	vgmstream->full_block_size = nextFrameSize;
 
 	start_offset=vgmstream->current_block_offset
-		         + read_32bitBE(vgmstream->current_block_offset+0x08,streamFile)+0x10;
-	vgmstream->current_block_size=read_32bitBE(start_offset,streamFile);
+		         + get_block_32bitBE(&header, 0x08)+0x10;
+
+	/* audio header: size, samples, coefs and hist per channel */
+	read_block_header(&header, start_offset, 0x08 + 0x24*vgmstream->channels, streamFile);
+	vgmstream->current_block_size=get_block_32bitBE(&header, 0x00);
 	start_offset+=8;
 
 	for(i=0;i<vgmstream->channels;i++) {
 		for(j=0;j<16;j++) {
-			vgmstream->ch[i].adpcm_coef[j]=read_16bitBE(start_offset+(i*0x20)+(j*2),streamFile);
+			vgmstream->ch[i].adpcm_coef[j]=get_block_16bitBE(&header, 0x08+(i*0x20)+(j*2));
 		}
-		vgmstream->ch[i].adpcm_history1_16=read_16bitBE(start_offset + (0x20*vgmstream->channels) + (i*4),streamFile);
-		vgmstream->ch[i].adpcm_history2_16=read_16bitBE(start_offset + (0x20*vgmstream->channels) + (i*4) + 2,streamFile);
+		vgmstream->ch[i].adpcm_history1_16=get_block_16bitBE(&header, 0x08 + (0x20*vgmstream->channels) + (i*4));
+		vgmstream->ch[i].adpcm_history2_16=get_block_16bitBE(&header, 0x08 + (0x20*vgmstream->channels) + (i*4) + 2);
         vgmstream->ch[i].offset = start_offset + (0x24*vgmstream->channels)+(i*vgmstream->current_block_size);
 	}
 }
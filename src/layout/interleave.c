@@ -1,6 +1,68 @@
 #include "layout.h"
 #include "../vgmstream.h"
+#include "../coding/coding.h"
+
+
+/* PCM interleaved every sample (most WAVs) has blocks of 1 sample, so going block by block means a full
+ * layout/decode round per sample. Since the data is the same as a sample-interleaved stream, runs of
+ * samples can be decoded at once with the "_int" decoders instead, moving offsets as blocks would. */
+static int has_sample_interleave_decoder(VGMSTREAM * vgmstream) {
+    switch (vgmstream->coding_type) {
+        case coding_PCM16LE:
+        case coding_PCM16BE:
+        case coding_PCM8:
+        case coding_PCM8_U:
+        case coding_ULAW:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void decode_sample_interleave(VGMSTREAM * vgmstream, sample * buffer, int32_t samples_to_do) {
+    VGMSTREAM_COUNTERS * counters = vgmstream->counters;
+    uint64_t start = counters ? get_time_ns() : 0;
+    int ch;
+
+    if (vgmstream->skip_decode) {
+        for (ch = 0; ch < vgmstream->channels; ch++) {
+            vgmstream->ch[ch].offset += vgmstream->interleave_block_size * vgmstream->channels * samples_to_do;
+        }
+        return;
+    }
+
+    for (ch = 0; ch < vgmstream->channels; ch++) {
+        VGMSTREAMCHANNEL * stream = &vgmstream->ch[ch];
+
+        switch (vgmstream->coding_type) {
+            case coding_PCM16LE:
+                decode_pcm16_int(stream, buffer + ch, vgmstream->channels, 0, samples_to_do, 0);
+                break;
+            case coding_PCM16BE:
+                decode_pcm16_int(stream, buffer + ch, vgmstream->channels, 0, samples_to_do, 1);
+                break;
+            case coding_PCM8:
+                decode_pcm8_int(stream, buffer + ch, vgmstream->channels, 0, samples_to_do);
+                break;
+            case coding_PCM8_U:
+                decode_pcm8_unsigned_int(stream, buffer + ch, vgmstream->channels, 0, samples_to_do);
+                break;
+            case coding_ULAW:
+                decode_ulaw_int(stream, buffer + ch, vgmstream->channels, 0, samples_to_do);
+                break;
+            default:
+                break;
+        }
 
+        stream->offset += vgmstream->interleave_block_size * vgmstream->channels * samples_to_do;
+    }
+
+    if (counters) {
+        counters->decode_time += get_time_ns() - start;
+        counters->decode_calls++;
+        counters->decode_samples += samples_to_do;
+    }
+}
 
 /* Decodes samples for interleaved streams.
  * Data has interleaved chunks per channel, and once one is decoded the layout moves offsets,
@@ -10,6 +72,7 @@ void render_vgmstream_interleave(sample * buffer, int32_t sample_count, VGMSTREA
     int samples_written = 0;
     int frame_size, samples_per_frame, samples_this_block;
     int has_interleave_last = vgmstream->interleave_last_block_size && vgmstream->channels > 1;
+    int is_sample_interleave;
 
     frame_size = get_vgmstream_frame_size(vgmstream);
     samples_per_frame = get_vgmstream_samples_per_frame(vgmstream);
@@ -27,6 +90,9 @@ void render_vgmstream_interleave(sample * buffer, int32_t sample_count, VGMSTREA
     if (samples_this_block == 0 && vgmstream->channels == 1)
         samples_this_block = vgmstream->num_samples;
 
+    is_sample_interleave = !has_interleave_last && samples_per_frame == 1 && vgmstream->interleave_block_size == frame_size &&
+            vgmstream->samples_into_block == 0 && has_sample_interleave_decoder(vgmstream);
+
 
     while (samples_written < sample_count) {
         int samples_to_do; 
@@ -43,6 +109,16 @@ void render_vgmstream_interleave(sample * buffer, int32_t sample_count, VGMSTREA
             continue;
         }
 
+        if (is_sample_interleave) {
+            samples_to_do = vgmstream_samples_to_do(sample_count - samples_written, samples_per_frame, vgmstream);
+            if (samples_to_do > 0) {
+                decode_sample_interleave(vgmstream, buffer + samples_written*vgmstream->channels, samples_to_do);
+                samples_written += samples_to_do;
+                vgmstream->current_sample += samples_to_do;
+                continue;
+            }
+        }
+
         samples_to_do = vgmstream_samples_to_do(samples_this_block, samples_per_frame, vgmstream);
         if (samples_to_do > sample_count - samples_written)
             samples_to_do = sample_count - samples_written;
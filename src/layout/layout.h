@@ -8,6 +8,40 @@
 void render_vgmstream_blocked(sample * buffer, int32_t sample_count, VGMSTREAM * vgmstream);
 void block_update(off_t block_offset, VGMSTREAM * vgmstream);
 
+/* Block header read at once, so block_update_* can parse fields from memory rather than doing
+ * many small reads. Fields outside what could be read are read from the streamfile as usual
+ * (returning -1 at EOF), so parsing works the same as before. */
+#define BLOCK_HEADER_MAX  0x200
+typedef struct {
+    STREAMFILE * streamfile;
+    off_t offset;
+    size_t size; /* valid bytes in data (may be less than requested near EOF) */
+    uint8_t data[BLOCK_HEADER_MAX];
+} block_header_t;
+
+void read_block_header(block_header_t * header, off_t offset, size_t size, STREAMFILE * streamFile);
+
+static inline int32_t get_block_32bitBE(block_header_t * header, off_t pos) {
+    if (pos < 0 || (size_t)pos + 0x04 > header->size)
+        return read_32bitBE(header->offset + pos, header->streamfile);
+    return get_32bitBE(header->data + pos);
+}
+static inline int32_t get_block_32bitLE(block_header_t * header, off_t pos) {
+    if (pos < 0 || (size_t)pos + 0x04 > header->size)
+        return read_32bitLE(header->offset + pos, header->streamfile);
+    return get_32bitLE(header->data + pos);
+}
+static inline int16_t get_block_16bitBE(block_header_t * header, off_t pos) {
+    if (pos < 0 || (size_t)pos + 0x02 > header->size)
+        return read_16bitBE(header->offset + pos, header->streamfile);
+    return get_16bitBE(header->data + pos);
+}
+static inline int16_t get_block_16bitLE(block_header_t * header, off_t pos) {
+    if (pos < 0 || (size_t)pos + 0x02 > header->size)
+        return read_16bitLE(header->offset + pos, header->streamfile);
+    return get_16bitLE(header->data + pos);
+}
+
 void block_update_ast(off_t block_ofset, VGMSTREAM * vgmstream);
 void block_update_mxch(off_t block_ofset, VGMSTREAM * vgmstream);
 void block_update_halpst(off_t block_ofset, VGMSTREAM * vgmstream);
@@ -0,0 +1,168 @@
+#include "vgmstream.h"
+#include "loop_cache.h"
+
+
+/* Loop cache: long plays of looped streams decode the same loop body on every pass, and codecs that
+ * loop by seeking may also re-decode from the start (some MPEG/Vorbis/FFmpeg) each time. When enabled,
+ * the first looped pass is copied to memory as it's decoded, and later passes are copied from there
+ * while the decoder stays at loop start. The first looped pass is recorded rather than the initial one
+ * since some decoders output slightly different samples after a seek, so output is the same as without
+ * the cache. The last pass before a loop target is decoded as usual, to continue into the stream end.
+ *
+ * Only the whole body is cached: continuing after a partial copy would need decoder state at that
+ * point, which can't be saved, so bodies over the memory limit are just decoded. */
+
+typedef struct {
+    size_t max_bytes;       /* 0 = disabled */
+    sample * buffer;        /* loop body, (loop_end - loop_start) * channels */
+    int32_t loop_start;     /* loop points the buffer was made for */
+    int32_t loop_end;
+    int32_t filled;         /* samples recorded since loop_start */
+    int complete;           /* whole body recorded */
+    int too_big;            /* body over max_bytes (or can't be allocated) */
+    int serving_pass;       /* loop_count of the pass being copied, if any */
+} loop_cache_data;
+
+
+static void release_cache(loop_cache_data * cache) {
+    free(cache->buffer);
+    cache->buffer = NULL;
+    cache->filled = 0;
+    cache->complete = 0;
+    cache->too_big = 0;
+    cache->serving_pass = 0;
+}
+
+int vgmstream_set_loop_cache(VGMSTREAM * vgmstream, size_t max_bytes) {
+    loop_cache_data * cache;
+
+    if (!vgmstream)
+        return 0;
+
+    /* layouts that loop on their own, and formats that keep ADPCM history between loops (see vgmstream_do_loop) */
+    if (vgmstream->layout_type == layout_aix ||
+            vgmstream->layout_type == layout_segmented ||
+            vgmstream->layout_type == layout_layered ||
+            vgmstream->meta_type == meta_DSP_STD ||
+            vgmstream->meta_type == meta_DSP_RS03 ||
+            vgmstream->meta_type == meta_DSP_CSTR ||
+            vgmstream->coding_type == coding_PSX ||
+            vgmstream->coding_type == coding_PSX_badflags)
+        return 0;
+
+    cache = vgmstream->loop_cache_data;
+    if (!cache) {
+        cache = vgmstream_arena_alloc(vgmstream, sizeof(loop_cache_data));
+        if (!cache) return 0;
+
+        /* also for the reset copy, or a reset would disable it */
+        vgmstream->loop_cache_data = cache;
+        if (vgmstream->start_vgmstream) {
+            VGMSTREAM * start_vgmstream = vgmstream->start_vgmstream;
+            start_vgmstream->loop_cache_data = cache;
+        }
+    }
+
+    release_cache(cache);
+    cache->max_bytes = max_bytes;
+    return 1;
+}
+
+int loop_cache_is_active(VGMSTREAM * vgmstream) {
+    loop_cache_data * cache = vgmstream->loop_cache_data;
+
+    if (!cache || !cache->max_bytes || !vgmstream->loop_flag)
+        return 0;
+
+    /* loop points changed after recording (forced loops) */
+    if (cache->loop_start != vgmstream->loop_start_sample || cache->loop_end != vgmstream->loop_end_sample) {
+        release_cache(cache);
+        cache->loop_start = vgmstream->loop_start_sample;
+        cache->loop_end = vgmstream->loop_end_sample;
+    }
+
+    return !cache->too_big && cache->loop_start < cache->loop_end;
+}
+
+int32_t loop_cache_read(VGMSTREAM * vgmstream, sample * buffer, int32_t sample_count) {
+    loop_cache_data * cache = vgmstream->loop_cache_data;
+    int32_t offset, samples_to_do;
+
+    if (!cache->complete || vgmstream->loop_count < 1)
+        return 0;
+
+    /* start a new pass (decoder is at loop start after the last loop), unless it's the last one */
+    if (vgmstream->current_sample == cache->loop_start) {
+        if (vgmstream->loop_target && vgmstream->loop_count + 1 >= vgmstream->loop_target)
+            return 0;
+        cache->serving_pass = vgmstream->loop_count;
+    }
+    else if (cache->serving_pass != vgmstream->loop_count) {
+        return 0;
+    }
+
+    offset = vgmstream->current_sample - cache->loop_start;
+    samples_to_do = cache->loop_end - vgmstream->current_sample;
+    if (samples_to_do > sample_count)
+        samples_to_do = sample_count;
+
+    memcpy(buffer, cache->buffer + offset * vgmstream->channels, samples_to_do * vgmstream->channels * sizeof(sample));
+    vgmstream->current_sample += samples_to_do;
+
+    return samples_to_do;
+}
+
+int loop_cache_do_loop(VGMSTREAM * vgmstream) {
+    loop_cache_data * cache = vgmstream->loop_cache_data;
+
+    if (!cache->serving_pass || cache->serving_pass != vgmstream->loop_count || vgmstream->current_sample != cache->loop_end)
+        return 0;
+
+    /* same as vgmstream_do_loop, minus seeking since the decoder never left loop start */
+    vgmstream->loop_count++;
+    VGM_COUNT(vgmstream, loops, 1);
+    vgmstream->current_sample = vgmstream->loop_sample;
+    cache->serving_pass = 0;
+    return 1;
+}
+
+void loop_cache_write(VGMSTREAM * vgmstream, const sample * buffer, int32_t start_sample, int32_t sample_count) {
+    loop_cache_data * cache = vgmstream->loop_cache_data;
+    int32_t offset = start_sample - cache->loop_start;
+
+    if (cache->complete || vgmstream->loop_count < 1 || offset < 0)
+        return;
+
+    /* record from the start of a looped pass (restarted if a reset or seek interrupted the last one) */
+    if (offset == 0) {
+        if (!cache->buffer) {
+            size_t body_bytes = (size_t)(cache->loop_end - cache->loop_start) * vgmstream->channels * sizeof(sample);
+
+            if (body_bytes > cache->max_bytes) {
+                cache->too_big = 1;
+                return;
+            }
+            cache->buffer = malloc(body_bytes);
+            if (!cache->buffer) {
+                VGM_LOG("LOOP CACHE: can't allocate %x bytes\n", (uint32_t)body_bytes);
+                cache->too_big = 1;
+                return;
+            }
+        }
+        cache->filled = 0;
+    }
+    if (!cache->buffer || offset != cache->filled || offset + sample_count > cache->loop_end - cache->loop_start)
+        return;
+
+    memcpy(cache->buffer + offset * vgmstream->channels, buffer, sample_count * vgmstream->channels * sizeof(sample));
+    cache->filled += sample_count;
+    if (cache->filled == cache->loop_end - cache->loop_start)
+        cache->complete = 1;
+}
+
+void loop_cache_free(VGMSTREAM * vgmstream) {
+    loop_cache_data * cache = vgmstream->loop_cache_data;
+
+    if (cache)
+        release_cache(cache);
+}
@@ -0,0 +1,26 @@
+/*
+ * loop_cache.h - optional in-memory copy of the decoded loop body, to play repeated loops without decoding
+ */
+#ifndef _LOOP_CACHE_H_
+#define _LOOP_CACHE_H_
+
+#include "vgmstream.h"
+
+/* Returns 1 if render_vgmstream must decode through loop_cache_read/write (looping at loop end itself). */
+int loop_cache_is_active(VGMSTREAM * vgmstream);
+
+/* Copies up to sample_count samples of a cached loop pass into buffer and moves the stream position
+ * (up to loop end). Returns samples copied, or 0 if they must be decoded. */
+int32_t loop_cache_read(VGMSTREAM * vgmstream, sample * buffer, int32_t sample_count);
+
+/* Loops back at loop end after a pass copied from the cache, once playback continues. Returns 0 if the
+ * pass was decoded, to loop with vgmstream_do_loop. */
+int loop_cache_do_loop(VGMSTREAM * vgmstream);
+
+/* Records sample_count samples decoded from start_sample, if they belong to the pass being cached. */
+void loop_cache_write(VGMSTREAM * vgmstream, const sample * buffer, int32_t start_sample, int32_t sample_count);
+
+/* Releases the cached samples, on close. */
+void loop_cache_free(VGMSTREAM * vgmstream);
+
+#endif /* _LOOP_CACHE_H_ */
@@ -4,15 +4,13 @@
 /* 2DX9 (found in beatmaniaIIDX16 - EMPRESS (Arcade) */
 VGMSTREAM * init_vgmstream_2dx9(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("2dx9",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"2dx9")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x32445839) /* 2DX9 */
@@ -47,7 +45,7 @@ VGMSTREAM * init_vgmstream_2dx9(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -3,14 +3,12 @@
 
 VGMSTREAM * init_vgmstream_afc(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag;
     const int channel_count = 2;    /* .afc seems to be stereo only */
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("afc",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"afc")) goto fail;
 
     /* don't grab AIFF-C with .afc extension */
     if ((uint32_t)read_32bitBE(0x0,streamFile)==0x464F524D) /* FORM */
@@ -46,7 +44,7 @@ VGMSTREAM * init_vgmstream_afc(STREAMFILE *streamFile) {
         int i;
 
         /* both channels use same buffer, as interleave is so small */
-        chstreamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        chstreamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!chstreamfile) goto fail;
 
         for (i=0;i<channel_count;i++) {
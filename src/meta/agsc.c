@@ -5,7 +5,6 @@
 
 VGMSTREAM * init_vgmstream_agsc(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     off_t header_offset;
     off_t start_offset;
@@ -13,8 +12,7 @@ VGMSTREAM * init_vgmstream_agsc(STREAMFILE *streamFile) {
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("agsc",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"agsc")) goto fail;
 
     /* check header */
     if ((uint32_t)read_32bitBE(0,streamFile)!=0x00000001)
@@ -55,7 +53,7 @@ VGMSTREAM * init_vgmstream_agsc(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -95,13 +95,8 @@ VGMSTREAM * init_vgmstream_aix(STREAMFILE *streamFile) {
     }
 
     /* open base streamfile, that will be shared by all open_aix_with_STREAMFILE */
-    {
-        char filename[PATH_LIMIT];
-
-        streamFile->get_name(streamFile,filename,sizeof(filename));
-        streamFileAIX = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE); //todo simplify
-        if (!streamFileAIX) goto fail;
-    }
+    streamFileAIX = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
+    if (!streamFileAIX) goto fail;
 
     /* init layout */
     {
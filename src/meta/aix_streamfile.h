@@ -124,6 +124,10 @@ static void get_name_aix(AIXSTREAMFILE *streamfile,char *buffer,size_t length) {
     buffer[length-1]='\0';
 }
 
+static const char * get_name_ref_aix(AIXSTREAMFILE *streamfile) {
+    return "ARBITRARY.ADX";
+}
+
 static STREAMFILE *open_aix_impl(AIXSTREAMFILE *streamfile,const char * const filename,size_t buffersize) {
     AIXSTREAMFILE *newfile;
     if (strcmp(filename,"ARBITRARY.ADX"))
@@ -133,11 +137,17 @@ static STREAMFILE *open_aix_impl(AIXSTREAMFILE *streamfile,const char * const fi
     if (!newfile)
         return NULL;
     memcpy(newfile,streamfile,sizeof(AIXSTREAMFILE));
+
+    /* name parts are per STREAMFILE (the copy's would point to the original's) */
+    newfile->sf.name_ref = NULL;
+    newfile->sf.filename_ref = NULL;
+    newfile->sf.ext_ref = NULL;
+    newfile->sf.name_alloc = NULL;
     return &newfile->sf;
 }
 
 /*static*/ STREAMFILE *open_aix_with_STREAMFILE(STREAMFILE *file, off_t start_offset, int stream_id) {
-    AIXSTREAMFILE *streamfile = malloc(sizeof(AIXSTREAMFILE));
+    AIXSTREAMFILE *streamfile = calloc(1,sizeof(AIXSTREAMFILE));
 
     if (!streamfile)
         return NULL;
@@ -148,8 +158,10 @@ static STREAMFILE *open_aix_impl(AIXSTREAMFILE *streamfile,const char * const fi
     streamfile->sf.get_size = (void*)get_size_aix;
     streamfile->sf.get_offset = (void*)get_offset_aix;
     streamfile->sf.get_name = (void*)get_name_aix;
+    streamfile->sf.get_name_ref = (void*)get_name_ref_aix;
     streamfile->sf.open = (void*)open_aix_impl;
     streamfile->sf.close = (void*)close_aix;
+    streamfile->sf.counters = file->counters;
 
     streamfile->real_file = file;
     streamfile->current_physical_offset = start_offset;
@@ -5,7 +5,6 @@
 VGMSTREAM * init_vgmstream_bar(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
     STREAMFILE* streamFileBAR = NULL; // don't close, this is just the source streamFile wrapped
-    char filename[PATH_LIMIT];
     off_t start_offset;
     off_t ch2_start_offset;
     int loop_flag;
@@ -14,8 +13,7 @@ VGMSTREAM * init_vgmstream_bar(STREAMFILE *streamFile) {
 
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("bar",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"bar")) goto fail;
 
     /* decryption wrapper for header reading */
     streamFileBAR = wrap_bar_STREAMFILE(streamFile);
@@ -49,9 +47,9 @@ VGMSTREAM * init_vgmstream_bar(STREAMFILE *streamFile) {
 
     {
         STREAMFILE *file1, *file2;
-        file1 = streamFileBAR->open(streamFileBAR,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file1 = reopen_streamfile(streamFileBAR, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file1) goto fail;
-        file2 = streamFileBAR->open(streamFileBAR,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file2 = reopen_streamfile(streamFileBAR, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file2)
         {
             close_streamfile(file1);
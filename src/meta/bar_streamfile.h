@@ -44,6 +44,10 @@ static void get_name_bar(BARSTREAMFILE *streamFile, char *name, size_t length) {
     streamFile->real_file->get_name(streamFile->real_file, name, length);
 }
 
+static const char * get_name_ref_bar(BARSTREAMFILE *streamFile) {
+    return get_streamfile_name_ref(streamFile->real_file);
+}
+
 STREAMFILE *open_bar(BARSTREAMFILE *streamFile, const char * const filename, size_t buffersize) {
     STREAMFILE *newfile = streamFile->real_file->open(streamFile->real_file,filename,buffersize);
     if (!newfile)
@@ -53,7 +57,7 @@ STREAMFILE *open_bar(BARSTREAMFILE *streamFile, const char * const filename, siz
 }
 
 static void close_bar(BARSTREAMFILE *streamFile) {
-    streamFile->real_file->close(streamFile->real_file);
+    close_streamfile(streamFile->real_file);
     free(streamFile);
     return;
 }
@@ -71,8 +75,10 @@ static void close_bar(BARSTREAMFILE *streamFile) {
     streamfile->sf.get_size = (void*)get_size_bar;
     streamfile->sf.get_offset = (void*)get_offset_bar;
     streamfile->sf.get_name = (void*)get_name_bar;
+    streamfile->sf.get_name_ref = (void*)get_name_ref_bar;
     streamfile->sf.open = (void*)open_bar;
     streamfile->sf.close = (void*)close_bar;
+    streamfile->sf.counters = file->counters;
 
     streamfile->real_file = file;
 
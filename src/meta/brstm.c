@@ -3,7 +3,6 @@
 
 VGMSTREAM * init_vgmstream_brstm(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     coding_t coding_type;
 
@@ -21,9 +20,8 @@ VGMSTREAM * init_vgmstream_brstm(STREAMFILE *streamFile) {
     off_t start_offset;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("brstm",filename_extension(filename))) {
-        if (strcasecmp("brstmspm",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"brstm")) {
+        if (!check_extensions(streamFile,"brstmspm")) goto fail;
         else spm_flag = 1;
     }
 
@@ -136,7 +134,7 @@ VGMSTREAM * init_vgmstream_brstm(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
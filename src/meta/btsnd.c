@@ -7,15 +7,12 @@ Wii U boot sound file for each game/app.
 
 VGMSTREAM * init_vgmstream_btsnd(STREAMFILE *streamFile) {
 	VGMSTREAM * vgmstream = NULL;
-	char filename[PATH_LIMIT];
 	int channel_count = 2;
 	int loop_flag;
 	off_t start_offset = 0x8;
 
 	/* check extension, case insensitive */
-	streamFile->get_name(streamFile, filename, sizeof(filename));
-	if (strcasecmp("btsnd", filename_extension(filename))) 
-		goto fail;
+	if (!check_extensions(streamFile,"btsnd")) goto fail;
 	
 	/* Checking for loop start */
 	if (read_32bitBE(0x4, streamFile) > 0)
@@ -48,8 +45,7 @@ VGMSTREAM * init_vgmstream_btsnd(STREAMFILE *streamFile) {
 	{
 		int i;
 		for (i = 0; i<channel_count; i++) {
-				vgmstream->ch[i].streamfile = streamFile->open(streamFile, filename,
-				STREAMFILE_DEFAULT_BUFFER_SIZE);
+				vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
 			if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -4,14 +4,12 @@
 /* CAPDSP (found in Capcom games) */
 VGMSTREAM * init_vgmstream_capdsp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("capdsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"capdsp")) goto fail;
 
     loop_flag = (read_32bitBE(0x14,streamFile) !=2);
     channel_count = read_32bitBE(0x10,streamFile);
@@ -49,7 +47,7 @@ VGMSTREAM * init_vgmstream_capdsp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -5,7 +5,6 @@
 /* .dsp w/ Cstr header, seen in Star Fox Assault and Donkey Konga */
 VGMSTREAM * init_vgmstream_cstr(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag;
     off_t start_offset;
@@ -16,8 +15,7 @@ VGMSTREAM * init_vgmstream_cstr(STREAMFILE *streamFile) {
     int double_loop_end = 0;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("dsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"dsp")) goto fail;
 
     /* check header */
     if ((uint32_t)read_32bitBE(0,streamFile)!=0x43737472)   /* "Cstr" */
@@ -73,7 +71,7 @@ VGMSTREAM * init_vgmstream_cstr(STREAMFILE *streamFile) {
         }
 
         /* open the file for reading by each channel */
-        vgmstream->ch[0].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        vgmstream->ch[0].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
         if (!vgmstream->ch[0].streamfile) goto fail;
 
@@ -280,7 +278,7 @@ VGMSTREAM * init_vgmstream_cstr(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<2;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -4,14 +4,12 @@
 /* ASD - found in Miss Moonlight (DC) */
 VGMSTREAM * init_vgmstream_dc_asd(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag;
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("asd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"asd")) goto fail;
 
     /* We have no "Magic" words in this header format, so we have to do some,
     other checks, it seems the samplecount is stored twice in the header,
@@ -54,7 +52,7 @@ VGMSTREAM * init_vgmstream_dc_asd(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
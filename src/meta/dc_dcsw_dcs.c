@@ -24,8 +24,8 @@ VGMSTREAM * init_vgmstream_dc_dcsw_dcs(STREAMFILE *streamFile) {
     off_t current_chunk;
     
     /* check extension, case insensitive */
+    if (!check_extensions(streamFile,"dcs")) goto fail;
     streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("dcs",filename_extension(filename))) goto fail;
 
     /* Getting the Header file name... */
     strcpy(filenameDCSW,filename);
@@ -7,7 +7,6 @@
 
 VGMSTREAM * init_vgmstream_dc_str(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
     int interleave;
@@ -15,8 +14,7 @@ VGMSTREAM * init_vgmstream_dc_str(STREAMFILE *streamFile) {
     int samples;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("str",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"str")) goto fail;
 
     /* check header */
     if (read_32bitBE(0xD5,streamFile) != 0x53656761) /* "Sega" */
@@ -76,7 +74,7 @@ VGMSTREAM * init_vgmstream_dc_str(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -102,14 +100,12 @@ fail:
 
 VGMSTREAM * init_vgmstream_dc_str_v2(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("str",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"str")) goto fail;
 
     /* check header */
     if ((read_32bitLE(0x00,streamFile) != 0x2))
@@ -144,7 +140,7 @@ VGMSTREAM * init_vgmstream_dc_str_v2(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -7,7 +7,6 @@
  */
 VGMSTREAM * init_vgmstream_dmsg(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 	int loop_flag = 0;
 	int frequency;
 	int channel_count;
@@ -18,8 +17,7 @@ VGMSTREAM * init_vgmstream_dmsg(STREAMFILE *streamFile) {
 	off_t start_offset;
     
 	/* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("dmsg",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"dmsg")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x52494646) /* "RIFF" */
@@ -91,7 +89,7 @@ VGMSTREAM * init_vgmstream_dmsg(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
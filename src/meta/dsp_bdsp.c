@@ -5,15 +5,13 @@
 VGMSTREAM * init_vgmstream_dsp_bdsp(STREAMFILE *streamFile) {
 
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int channel_count;
     int loop_flag;
     int i;
     off_t start_offset;
     
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("bdsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"bdsp")) goto fail;
 
     channel_count = 2;
     loop_flag = 0;
@@ -42,7 +40,7 @@ VGMSTREAM * init_vgmstream_dsp_bdsp(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
             
         if (!vgmstream->ch[i].streamfile) goto fail;
             vgmstream->ch[i].channel_start_offset=
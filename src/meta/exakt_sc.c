@@ -5,14 +5,12 @@
 
 VGMSTREAM * init_vgmstream_exakt_sc(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     size_t file_size;
 
     /* check extension, case insensitive */
     /* this is all we have to go on, SC is completely headerless */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sc",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"sc")) goto fail;
 
     file_size = get_streamfile_size(streamFile);
 
@@ -34,7 +32,7 @@ VGMSTREAM * init_vgmstream_exakt_sc(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<2;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -7,7 +7,6 @@
 /* .sfx, some .sf0 -  DSP and PCM */
 VGMSTREAM * init_vgmstream_eb_sfx(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
 	int channel_count;
@@ -17,10 +16,7 @@ VGMSTREAM * init_vgmstream_eb_sfx(STREAMFILE *streamFile) {
 	long header_size;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sfx",filename_extension(filename)) &&
-        strcasecmp("sf0",filename_extension(filename)))
-        goto fail;
+    if (!check_extensions(streamFile,"sfx,sf0")) goto fail;
 
     /* check sizes */
     body_size = read_32bitLE(0x00,streamFile);
@@ -87,7 +83,7 @@ VGMSTREAM * init_vgmstream_eb_sfx(STREAMFILE *streamFile) {
     /* open the file for reading */
     {
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         vgmstream->ch[0].streamfile = file;
 
@@ -115,15 +111,12 @@ fail:
 /* .sf0 - PCM (degenerate stereo .sfx?) */
 VGMSTREAM * init_vgmstream_eb_sf0(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int loop_flag = 0;
 	int channel_count;
     long file_size;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sf0",filename_extension(filename)))
-        goto fail;
+    if (!check_extensions(streamFile,"sf0")) goto fail;
 
     /* no header, check file size and go on faith */
     file_size = get_streamfile_size(streamFile);
@@ -149,7 +142,7 @@ VGMSTREAM * init_vgmstream_eb_sf0(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
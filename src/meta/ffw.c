@@ -4,14 +4,12 @@
 /* FFW (from Freedom Fighters [NGC]) */
 VGMSTREAM * init_vgmstream_ffw(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
 		int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("ffw",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"ffw")) goto fail;
 
     loop_flag = 0;
     channel_count = read_32bitLE(0x11C,streamFile);
@@ -43,7 +41,7 @@ VGMSTREAM * init_vgmstream_ffw(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -2,13 +2,25 @@
 #include "fsb_keys.h"
 
 #define FSB_KEY_MAX 128 /* probably 32 */
+#define FSB_HEADER_TEST_SIZE 0x18
+#define FSB_DECRYPTION_BUFFER 0x1000
 
+typedef struct {
+    uint8_t data[FSB_KEY_MAX * 2]; /* key repeated, so any key position has a full span after it */
+    size_t key_size;
+    size_t span; /* repeated part, in whole keys */
+} fsb_keystream;
+
+static void setup_fsb_keystream(fsb_keystream * keystream, const uint8_t * key, size_t key_size, int is_alt);
+static void decrypt_fsb(uint8_t * buf, size_t size, off_t offset, const fsb_keystream * keystream);
+static int test_fsb_key(const uint8_t * header, const uint8_t * key, size_t key_size, int is_alt);
 static STREAMFILE* setup_fsb_streamfile(STREAMFILE *streamFile, const uint8_t * key, size_t key_size, int is_alt);
 
 
 /* fully encrypted FSBs */
 VGMSTREAM * init_vgmstream_fsb_encrypted(STREAMFILE * streamFile) {
     VGMSTREAM * vgmstream = NULL;
+    uint8_t header[FSB_HEADER_TEST_SIZE];
 
     /* check extensions */
     if ( !check_extensions(streamFile, "fsb") )
@@ -19,6 +31,11 @@ VGMSTREAM * init_vgmstream_fsb_encrypted(STREAMFILE * streamFile) {
         goto fail;
 
 
+    /* Keys are tested first by decrypting the start of the header (fast), and the full parser only
+     * runs with a key that looks correct (sometimes a wrong key may pass, so parsers may fail). */
+    if (read_streamfile(header, 0x00, FSB_HEADER_TEST_SIZE, streamFile) != FSB_HEADER_TEST_SIZE)
+        goto fail;
+
     /* try fsbkey + all combinations of FSB4/5 and decryption algorithms */
     {
         STREAMFILE *temp_streamFile = NULL;
@@ -26,22 +43,20 @@ VGMSTREAM * init_vgmstream_fsb_encrypted(STREAMFILE * streamFile) {
         size_t key_size = read_key_file(key, FSB_KEY_MAX, streamFile);
 
         if (key_size) {
-            {
-                temp_streamFile = setup_fsb_streamfile(streamFile, key,key_size, 0);
-                if (!temp_streamFile) goto fail;
+            int is_alt;
 
-                if (!vgmstream) vgmstream = init_vgmstream_fsb(temp_streamFile);
-                if (!vgmstream) vgmstream = init_vgmstream_fsb5(temp_streamFile);
+            for (is_alt = 0; is_alt <= 1 && !vgmstream; is_alt++) {
+                int version = test_fsb_key(header, key,key_size, is_alt);
+                if (!version)
+                    continue;
 
-                close_streamfile(temp_streamFile);
-            }
-
-            if (!vgmstream) {
-                temp_streamFile = setup_fsb_streamfile(streamFile, key,key_size, 1);
+                temp_streamFile = setup_fsb_streamfile(streamFile, key,key_size, is_alt);
                 if (!temp_streamFile) goto fail;
 
-                if (!vgmstream) vgmstream = init_vgmstream_fsb(temp_streamFile);
-                if (!vgmstream) vgmstream = init_vgmstream_fsb5(temp_streamFile);
+                if (version == 5)
+                    vgmstream = init_vgmstream_fsb5(temp_streamFile);
+                else
+                    vgmstream = init_vgmstream_fsb(temp_streamFile);
 
                 close_streamfile(temp_streamFile);
             }
@@ -56,8 +71,13 @@ VGMSTREAM * init_vgmstream_fsb_encrypted(STREAMFILE * streamFile) {
 
         for (i = 0; i < fsbkey_list_count; i++) {
             fsbkey_info entry = fsbkey_list[i];
+            int version;
             //;VGM_LOG("fsbkey: size=%i, is_fsb5=%i, is_alt=%i\n", entry.fsbkey_size,entry.is_fsb5, entry.is_alt);
 
+            version = test_fsb_key(header, entry.fsbkey, entry.fsbkey_size, entry.is_alt);
+            if (version != (entry.is_fsb5 ? 5 : 4))
+                continue;
+
             temp_streamFile = setup_fsb_streamfile(streamFile, entry.fsbkey, entry.fsbkey_size, entry.is_alt);
             if (!temp_streamFile) goto fail;
 
@@ -83,76 +103,137 @@ fail:
 }
 
 
+/* Encrypted FSB info from guessfsb and fsbext: data is bit-reversed then XOR'ed with the key,
+ * or XOR'ed then bit-reversed in the alt mode (same as XOR'ing with the bit-reversed key). */
+static uint8_t reverse_bits(uint8_t val) {
+    val = (val >> 4) | (val << 4);
+    val = ((val & 0xCC) >> 2) | ((val & 0x33) << 2);
+    val = ((val & 0xAA) >> 1) | ((val & 0x55) << 1);
+    return val;
+}
+
+static void setup_fsb_keystream(fsb_keystream * keystream, const uint8_t * key, size_t key_size, int is_alt) {
+    size_t i;
+
+    keystream->key_size = key_size;
+    keystream->span = key_size * (FSB_KEY_MAX / key_size);
+    for (i = 0; i < keystream->span + key_size; i++) {
+        uint8_t xor = key[i % key_size];
+        keystream->data[i] = is_alt ? reverse_bits(xor) : xor;
+    }
+}
+
+static void decrypt_fsb(uint8_t * buf, size_t size, off_t offset, const fsb_keystream * keystream) {
+    const uint8_t * key = &keystream->data[offset % keystream->key_size];
+
+    /* done in whole spans (plain loop so compilers can vectorize it), that end on the same key position */
+    while (size > 0) {
+        size_t i, span_size = size > keystream->span ? keystream->span : size;
+
+        for (i = 0; i < span_size; i++) {
+            uint8_t val = buf[i];
+            val = (val >> 4) | (val << 4);
+            val = ((val & 0xCC) >> 2) | ((val & 0x33) << 2);
+            val = ((val & 0xAA) >> 1) | ((val & 0x55) << 1);
+            buf[i] = val ^ key[i];
+        }
+
+        buf += span_size;
+        size -= span_size;
+    }
+}
+
+/* decrypts the header start and returns FSB version (4 for FSB1~4, or 5) if it looks correct */
+static int test_fsb_key(const uint8_t * header, const uint8_t * key, size_t key_size, int is_alt) {
+    fsb_keystream keystream;
+    uint8_t buf[FSB_HEADER_TEST_SIZE];
+
+    if (!key_size || key_size > FSB_KEY_MAX)
+        return 0;
+
+    setup_fsb_keystream(&keystream, key, key_size, is_alt);
+    memcpy(buf, header, FSB_HEADER_TEST_SIZE);
+    decrypt_fsb(buf, FSB_HEADER_TEST_SIZE, 0x00, &keystream);
+
+    if (get_32bitBE(buf+0x00) == 0x46534235) { /* "FSB5" */
+        if (get_32bitLE(buf+0x04) != 0x00 && get_32bitLE(buf+0x04) != 0x01) /* version */
+            return 0;
+        if (get_32bitLE(buf+0x08) <= 0) /* subsongs */
+            return 0;
+        return 5;
+    }
+
+    if (get_32bitBE(buf+0x00) >= 0x46534231 && get_32bitBE(buf+0x00) <= 0x46534234) { /* "FSB1"~"FSB4" */
+        if (get_32bitLE(buf+0x04) <= 0) /* subsongs */
+            return 0;
+        return 4;
+    }
+
+    return 0;
+}
+
+
 typedef struct {
-    uint8_t key[FSB_KEY_MAX];
-    size_t key_size;
-    int is_alt;
+    fsb_keystream keystream;
+
+    /* decrypted window, as parsers/decoders often re-read small parts */
+    uint8_t buf[FSB_DECRYPTION_BUFFER];
+    off_t buf_offset;
+    size_t buf_size;
 } fsb_decryption_data;
 
-/* Encrypted FSB info from guessfsb and fsbext */
 static size_t fsb_decryption_read(STREAMFILE *streamfile, uint8_t *dest, off_t offset, size_t length, fsb_decryption_data* data) {
-    static const unsigned char reverse_bits_table[] = { /* LUT to simplify, could use some bitswap function */
-      0x00,0x80,0x40,0xC0,0x20,0xA0,0x60,0xE0,0x10,0x90,0x50,0xD0,0x30,0xB0,0x70,0xF0,
-      0x08,0x88,0x48,0xC8,0x28,0xA8,0x68,0xE8,0x18,0x98,0x58,0xD8,0x38,0xB8,0x78,0xF8,
-      0x04,0x84,0x44,0xC4,0x24,0xA4,0x64,0xE4,0x14,0x94,0x54,0xD4,0x34,0xB4,0x74,0xF4,
-      0x0C,0x8C,0x4C,0xCC,0x2C,0xAC,0x6C,0xEC,0x1C,0x9C,0x5C,0xDC,0x3C,0xBC,0x7C,0xFC,
-      0x02,0x82,0x42,0xC2,0x22,0xA2,0x62,0xE2,0x12,0x92,0x52,0xD2,0x32,0xB2,0x72,0xF2,
-      0x0A,0x8A,0x4A,0xCA,0x2A,0xAA,0x6A,0xEA,0x1A,0x9A,0x5A,0xDA,0x3A,0xBA,0x7A,0xFA,
-      0x06,0x86,0x46,0xC6,0x26,0xA6,0x66,0xE6,0x16,0x96,0x56,0xD6,0x36,0xB6,0x76,0xF6,
-      0x0E,0x8E,0x4E,0xCE,0x2E,0xAE,0x6E,0xEE,0x1E,0x9E,0x5E,0xDE,0x3E,0xBE,0x7E,0xFE,
-      0x01,0x81,0x41,0xC1,0x21,0xA1,0x61,0xE1,0x11,0x91,0x51,0xD1,0x31,0xB1,0x71,0xF1,
-      0x09,0x89,0x49,0xC9,0x29,0xA9,0x69,0xE9,0x19,0x99,0x59,0xD9,0x39,0xB9,0x79,0xF9,
-      0x05,0x85,0x45,0xC5,0x25,0xA5,0x65,0xE5,0x15,0x95,0x55,0xD5,0x35,0xB5,0x75,0xF5,
-      0x0D,0x8D,0x4D,0xCD,0x2D,0xAD,0x6D,0xED,0x1D,0x9D,0x5D,0xDD,0x3D,0xBD,0x7D,0xFD,
-      0x03,0x83,0x43,0xC3,0x23,0xA3,0x63,0xE3,0x13,0x93,0x53,0xD3,0x33,0xB3,0x73,0xF3,
-      0x0B,0x8B,0x4B,0xCB,0x2B,0xAB,0x6B,0xEB,0x1B,0x9B,0x5B,0xDB,0x3B,0xBB,0x7B,0xFB,
-      0x07,0x87,0x47,0xC7,0x27,0xA7,0x67,0xE7,0x17,0x97,0x57,0xD7,0x37,0xB7,0x77,0xF7,
-      0x0F,0x8F,0x4F,0xCF,0x2F,0xAF,0x6F,0xEF,0x1F,0x9F,0x5F,0xDF,0x3F,0xBF,0x7F,0xFF
-    };
     size_t bytes_read;
-    int i;
 
-    bytes_read = streamfile->read(streamfile, dest, offset, length);
+    if (offset < 0)
+        return 0;
 
-    /* decrypt data (inverted bits and xor) */
-    for (i = 0; i < bytes_read; i++) {
-        uint8_t xor = data->key[(offset + i) % data->key_size];
-        uint8_t val = dest[i];
-        if (data->is_alt) {
-            dest[i] = reverse_bits_table[val ^ xor];
-        }
-        else {
-            dest[i] = reverse_bits_table[val] ^ xor;
+    /* small reads: refill the window if needed and copy from it */
+    if (length < FSB_DECRYPTION_BUFFER) {
+        if (offset < data->buf_offset || offset + length > data->buf_offset + data->buf_size) {
+            data->buf_offset = offset;
+            data->buf_size = streamfile->read(streamfile, data->buf, offset, FSB_DECRYPTION_BUFFER);
+            decrypt_fsb(data->buf, data->buf_size, offset, &data->keystream);
         }
+
+        bytes_read = data->buf_offset + data->buf_size - offset;
+        if (bytes_read > length)
+            bytes_read = length;
+        memcpy(dest, data->buf + (offset - data->buf_offset), bytes_read);
+        return bytes_read;
     }
 
+    bytes_read = streamfile->read(streamfile, dest, offset, length);
+    decrypt_fsb(dest, bytes_read, offset, &data->keystream);
     return bytes_read;
 }
 
 static STREAMFILE* setup_fsb_streamfile(STREAMFILE *streamFile, const uint8_t * key, size_t key_size, int is_alt) {
     STREAMFILE *temp_streamFile = NULL, *new_streamFile = NULL;
-    fsb_decryption_data io_data = {0};
+    fsb_decryption_data *io_data = NULL;
     size_t io_data_size = sizeof(fsb_decryption_data);
 
     /* setup decryption with key (external) */
     if (!key_size || key_size > FSB_KEY_MAX) goto fail;
 
-    memcpy(io_data.key, key, key_size);
-    io_data.key_size = key_size;
-    io_data.is_alt = is_alt;
+    io_data = calloc(1, io_data_size);
+    if (!io_data) goto fail;
+    setup_fsb_keystream(&io_data->keystream, key, key_size, is_alt);
 
     /* setup subfile */
     new_streamFile = open_wrap_streamfile(streamFile);
     if (!new_streamFile) goto fail;
     temp_streamFile = new_streamFile;
 
-    new_streamFile = open_io_streamfile(temp_streamFile, &io_data,io_data_size, fsb_decryption_read,NULL);
+    new_streamFile = open_io_streamfile(temp_streamFile, io_data,io_data_size, fsb_decryption_read,NULL);
     if (!new_streamFile) goto fail;
     temp_streamFile = new_streamFile;
 
+    free(io_data);
     return temp_streamFile;
 
 fail:
+    free(io_data);
     close_streamfile(temp_streamFile);
     return NULL;
 }
@@ -3,14 +3,12 @@
 
 VGMSTREAM * init_vgmstream_gcsw(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int channel_count;
     int loop_flag;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("gcw",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"gcw")) goto fail;
 
     /* check header */
     if ((uint32_t)read_32bitBE(0,streamFile)!=0x47435357) /* "GCSW" */
@@ -43,7 +41,7 @@ VGMSTREAM * init_vgmstream_gcsw(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
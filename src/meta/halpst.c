@@ -5,7 +5,6 @@
 
 VGMSTREAM * init_vgmstream_halpst(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int channel_count;
     int loop_flag = 0;
@@ -15,8 +14,7 @@ VGMSTREAM * init_vgmstream_halpst(STREAMFILE *streamFile) {
     int32_t start_sample = 0;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("hps",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"hps")) goto fail;
 
     /* check header */
     if ((uint32_t)read_32bitBE(0,streamFile)!=0x2048414C || /* " HAL" */
@@ -104,7 +102,7 @@ VGMSTREAM * init_vgmstream_halpst(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
         }
@@ -6,7 +6,6 @@
 
 VGMSTREAM * init_vgmstream_his(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int channel_count;
     int loop_flag = 0;
     int bps = 0;
@@ -15,8 +14,7 @@ VGMSTREAM * init_vgmstream_his(STREAMFILE *streamFile) {
     uint8_t header_magic[0x16];
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("his",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"his")) goto fail;
 
     /* check header magic */
     if (0x16 != streamFile->read(streamFile, header_magic, 0, 0x16)) goto fail;
@@ -85,7 +83,7 @@ VGMSTREAM * init_vgmstream_his(STREAMFILE *streamFile) {
     /* open the file for reading */
     {
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         vgmstream->ch[0].streamfile = file;
 
@@ -94,7 +92,7 @@ VGMSTREAM * init_vgmstream_his(STREAMFILE *streamFile) {
 
         if (channel_count == 2)
         {
-            file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
             if (!file) goto fail;
             vgmstream->ch[1].streamfile = file;
         
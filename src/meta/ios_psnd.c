@@ -4,15 +4,13 @@
 /* PSND (from Crash Bandicoot Nitro Kart 2 (iOS) */
 VGMSTREAM * init_vgmstream_ios_psnd(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag;
    int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("psnd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"psnd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x50534E44) /* "PSND" */
@@ -55,7 +53,7 @@ VGMSTREAM * init_vgmstream_ios_psnd(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -4,7 +4,6 @@
 /* a simple PS2 ADPCM format seen in Langrisser 3 */
 VGMSTREAM * init_vgmstream_ivb(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     off_t stream_length;
 
@@ -12,8 +11,7 @@ VGMSTREAM * init_vgmstream_ivb(STREAMFILE *streamFile) {
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("ivb",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"ivb")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x42564949) /* "BVII", probably */
@@ -41,7 +39,7 @@ VGMSTREAM * init_vgmstream_ivb(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -6,14 +6,12 @@
 
 VGMSTREAM * init_vgmstream_lsf_n1nj4n(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     size_t file_size;
     off_t start_offset;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("lsf",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"lsf")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0, streamFile) != 0x216E316E || // "!n1n"
@@ -41,7 +39,7 @@ VGMSTREAM * init_vgmstream_lsf_n1nj4n(STREAMFILE *streamFile) {
 
     /* open the file for reading */
     {
-        vgmstream->ch[0].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        vgmstream->ch[0].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
         if (!vgmstream->ch[0].streamfile) goto fail;
 
@@ -4,14 +4,12 @@
 /* MSVP (from PoPcap Hits Vol. 1) */
 VGMSTREAM * init_vgmstream_msvp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("msvp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"msvp")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x4D535670) /* "MSVp" */
@@ -49,7 +47,7 @@ VGMSTREAM * init_vgmstream_msvp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -233,7 +233,6 @@ fail:
 /* MUSX (Version 010) [Dead Space: Extraction (Wii), Rio (PS3), Pirates of the Caribbean: At World's End (PSP)] */
 VGMSTREAM * init_vgmstream_musx_v010(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int musx_type; /* determining the decoder by strings like "PS2_", "GC__" and so on */
     //int musx_version; /* 0x08 provides a "version" byte */
@@ -241,8 +240,7 @@ VGMSTREAM * init_vgmstream_musx_v010(STREAMFILE *streamFile) {
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("musx",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"musx")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x4D555358) /* "MUSX" */
@@ -377,7 +375,7 @@ VGMSTREAM * init_vgmstream_musx_v010(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -400,7 +398,6 @@ fail:
 /* MUSX (Version 201) */
 VGMSTREAM * init_vgmstream_musx_v201(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     //int musx_version; /* 0x08 provides a "version" byte */
     int loop_flag;
@@ -409,8 +406,7 @@ VGMSTREAM * init_vgmstream_musx_v201(STREAMFILE *streamFile) {
     int loop_offsets;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("musx",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"musx")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x4D555358) /* "MUSX" */
@@ -467,7 +463,7 @@ VGMSTREAM * init_vgmstream_musx_v201(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
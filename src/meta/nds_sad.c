@@ -4,7 +4,6 @@
 /* sadl (only the Professor Layton interleaved IMA version) */
 VGMSTREAM * init_vgmstream_sadl(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag;
@@ -12,8 +11,7 @@ VGMSTREAM * init_vgmstream_sadl(STREAMFILE *streamFile) {
     int coding_type;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sad",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"sad")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x7361646c) /* "sadl" */
@@ -89,7 +87,7 @@ VGMSTREAM * init_vgmstream_sadl(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -5,7 +5,6 @@
     SWAV - found in Asphalt Urban GT & Asphalt Urban GT 2 */
 VGMSTREAM * init_vgmstream_nds_swav(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int codec_number;
     int channel_count;
     int loop_flag;
@@ -14,8 +13,7 @@ VGMSTREAM * init_vgmstream_nds_swav(STREAMFILE *streamFile) {
     int bits_per_sample;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("swav",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"swav")) goto fail;
 
     /* check header */
     if ((uint32_t)read_32bitBE(0x00,streamFile)!=0x53574156)	/* SWAV */
@@ -107,7 +105,7 @@ VGMSTREAM * init_vgmstream_nds_swav(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
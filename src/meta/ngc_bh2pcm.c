@@ -4,15 +4,13 @@
 /* BH2PCM (from Bio Hazard 2) */
 VGMSTREAM * init_vgmstream_ngc_bh2pcm(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 	int channel_count;
 	int format_detect;
     int loop_flag;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("bh2pcm",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"bh2pcm")) goto fail;
 
 #if 0
     /* check header */
@@ -66,7 +64,7 @@ VGMSTREAM * init_vgmstream_ngc_bh2pcm(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
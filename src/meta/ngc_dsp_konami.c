@@ -6,7 +6,6 @@
 */
 VGMSTREAM * init_vgmstream_ngc_dsp_konami(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int loop_flag = 0;
 	int channel_count;
     int i, j;
@@ -15,9 +14,7 @@ VGMSTREAM * init_vgmstream_ngc_dsp_konami(STREAMFILE *streamFile) {
     off_t coef_table[2] = {0x90, 0xD0};
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("dsp",filename_extension(filename)))
-				goto fail;
+    if (!check_extensions(streamFile,"dsp")) goto fail;
 
     /* check header */
     if ((read_32bitBE(0x00,streamFile)+0x800) != (get_streamfile_size(streamFile)))
@@ -58,13 +55,13 @@ VGMSTREAM * init_vgmstream_ngc_dsp_konami(STREAMFILE *streamFile) {
 
     /* open the file for reading */
     /* Channel 1 */
-    vgmstream->ch[0].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+    vgmstream->ch[0].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
     if (!vgmstream->ch[0].streamfile)
     	goto fail;
     vgmstream->ch[0].channel_start_offset = vgmstream->ch[0].offset=ch1_start;
     
     /* Channel 1 */
-    vgmstream->ch[1].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+    vgmstream->ch[1].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
     if (!vgmstream->ch[1].streamfile)
     	goto fail;
     vgmstream->ch[1].channel_start_offset = vgmstream->ch[1].offset=ch2_start;
@@ -540,7 +540,7 @@ fail:
 /* various dsp with differing extensions and interleave values */
 VGMSTREAM * init_vgmstream_ngc_dsp_std_int(STREAMFILE *streamFile) {
     dsp_meta dspm = {0};
-    char filename[PATH_LIMIT];
+    const char * filename;
 
     /* checks */
     if (!check_extensions(streamFile, "dsp,mss,gcm"))
@@ -554,7 +554,7 @@ VGMSTREAM * init_vgmstream_ngc_dsp_std_int(STREAMFILE *streamFile) {
     dspm.header_spacing = 0x60;
     dspm.start_offset = 0xc0;
 
-    streamFile->get_name(streamFile,filename,sizeof(filename));
+    filename = get_streamfile_name_ref(streamFile);
     if (strlen(filename) > 7 && !strcasecmp("_lr.dsp",filename+strlen(filename)-7)) { //todo improve
         dspm.interleave = 0x14180;
         dspm.meta_type = meta_DSP_JETTERS; /* Bomberman Jetters (GC) */
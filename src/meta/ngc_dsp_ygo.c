@@ -10,15 +10,13 @@
 
 VGMSTREAM * init_vgmstream_dsp_ygo(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int loop_flag;
     int channel_count;
     off_t start_offset;
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("dsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"dsp")) goto fail;
 
     /* check file size with size given in header */
     if ((read_32bitBE(0x0,streamFile)+0xE0) != (get_streamfile_size(streamFile)))
@@ -56,7 +54,7 @@ VGMSTREAM * init_vgmstream_dsp_ygo(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -4,14 +4,12 @@
 /* GCUB - found in 'Sega Soccer Slam' */
 VGMSTREAM * init_vgmstream_ngc_gcub(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-	char filename[PATH_LIMIT];
 	off_t start_offset;
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-	streamFile->get_name(streamFile,filename,sizeof(filename));
-	if (strcasecmp("gcub",filename_extension(filename))) goto fail;
+	if (!check_extensions(streamFile,"gcub")) goto fail;
 
     /* check header */
 	if (read_32bitBE(0x00,streamFile) != 0x47437562) /* "GCub" */
@@ -73,7 +71,7 @@ VGMSTREAM * init_vgmstream_ngc_gcub(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -84,7 +82,7 @@ VGMSTREAM * init_vgmstream_ngc_gcub(STREAMFILE *streamFile) {
 
 	/* The second channel */
     if (channel_count == 2) {
-        vgmstream->ch[1].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        vgmstream->ch[1].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
         if (!vgmstream->ch[1].streamfile) goto fail;
 
@@ -4,14 +4,12 @@
 /* LPS (found in Rave Master (Groove Adventure Rave)(GC) */
 VGMSTREAM * init_vgmstream_ngc_lps(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("lps",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"lps")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x8,streamFile) != 0x10000000)
@@ -49,7 +47,7 @@ VGMSTREAM * init_vgmstream_ngc_lps(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
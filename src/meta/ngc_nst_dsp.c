@@ -7,14 +7,12 @@
 
 VGMSTREAM * init_vgmstream_ngc_nst_dsp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag;
 		int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("dsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"dsp")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != read_32bitBE(0x54,streamFile))
@@ -68,7 +66,7 @@ VGMSTREAM * init_vgmstream_ngc_nst_dsp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
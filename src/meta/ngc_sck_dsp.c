@@ -18,8 +18,8 @@ VGMSTREAM * init_vgmstream_ngc_sck_dsp(STREAMFILE *streamFile) {
     int loop_flag;
 
     /* check extension, case insensitive */
+    if (!check_extensions(streamFile,"sck")) goto fail;
     streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sck",filename_extension(filename))) goto fail;
 
 
     strcpy(filenameDSP,filename);
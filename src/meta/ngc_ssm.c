@@ -4,7 +4,6 @@
 /* SSM (Golden Gashbell Full Power GC) */
 VGMSTREAM * init_vgmstream_ngc_ssm(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag;
 	int channel_count;
@@ -12,9 +11,7 @@ VGMSTREAM * init_vgmstream_ngc_ssm(STREAMFILE *streamFile) {
 	int coef2_start;
 	int second_channel_start;
 
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    	if (strcasecmp("ssm",filename_extension(filename)))
-    goto fail;
+    	if (!check_extensions(streamFile,"ssm")) goto fail;
 
     /* check header */
 #if 0
@@ -62,7 +59,7 @@ VGMSTREAM * init_vgmstream_ngc_ssm(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -73,7 +70,7 @@ VGMSTREAM * init_vgmstream_ngc_ssm(STREAMFILE *streamFile) {
 
 	/* The second channel */
     if (channel_count == 2) {
-        vgmstream->ch[1].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        vgmstream->ch[1].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
         if (!vgmstream->ch[1].streamfile) goto fail;
 
@@ -4,14 +4,12 @@
 /* TYDSP (Ty - The Tasmanian Tiger) */
 VGMSTREAM * init_vgmstream_ngc_tydsp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("tydsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"tydsp")) goto fail;
 
     loop_flag = 1;
     channel_count = 2;
@@ -51,7 +49,7 @@ VGMSTREAM * init_vgmstream_ngc_tydsp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
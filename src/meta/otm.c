@@ -6,15 +6,13 @@
 /* Otomedius OTM (Arcade) */
 VGMSTREAM * init_vgmstream_otm(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("otm",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"otm")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x20,streamFile) != 0x10B10200)
@@ -50,7 +48,7 @@ VGMSTREAM * init_vgmstream_otm(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
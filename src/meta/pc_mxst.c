@@ -5,7 +5,6 @@
 
 VGMSTREAM * init_vgmstream_pc_mxst(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int bits_per_sample;
@@ -18,8 +17,7 @@ VGMSTREAM * init_vgmstream_pc_mxst(STREAMFILE *streamFile) {
     off_t start_offset;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("mxst",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"mxst")) goto fail;
 
     /* looping info not found yet */
 	//loop_flag = get_streamfile_size(streamFile) > 700000;
@@ -201,7 +199,7 @@ VGMSTREAM * init_vgmstream_pc_mxst(STREAMFILE *streamFile) {
     {
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile =
-                streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+                reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
         }
@@ -5,15 +5,13 @@
 
 VGMSTREAM * init_vgmstream_pc_snds(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     size_t file_size;
     int i;
 
     /* check extension, case insensitive */
     /* this is all we have to go on, snds is completely headerless */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("snds",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"snds")) goto fail;
 
     file_size = get_streamfile_size(streamFile);
 
@@ -44,7 +42,7 @@ VGMSTREAM * init_vgmstream_pc_snds(STREAMFILE *streamFile) {
 
     /* open the file for reading */
     vgmstream->ch[0].streamfile = vgmstream->ch[1].streamfile =
-        streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
     if (!vgmstream->ch[0].streamfile) goto fail;
 
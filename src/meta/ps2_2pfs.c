@@ -12,7 +12,6 @@
 VGMSTREAM * init_vgmstream_ps2_2pfs(STREAMFILE *streamFile) 
 {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     
     off_t start_offset = 0x800;
     int interleave = 0x1000;
@@ -28,10 +27,7 @@ VGMSTREAM * init_vgmstream_ps2_2pfs(STREAMFILE *streamFile)
 
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if ( strcasecmp("2pfs",filename_extension(filename))
-         && strcasecmp("sap",filename_extension(filename))  )
-        goto fail;
+    if (!check_extensions(streamFile,"2pfs,sap")) goto fail;
 
     /* check header ("2PFS") */
     if (read_32bitBE(0x00,streamFile) != 0x32504653)
@@ -95,7 +91,7 @@ VGMSTREAM * init_vgmstream_ps2_2pfs(STREAMFILE *streamFile)
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         
 		for (i=0;i<channel_count;i++) 
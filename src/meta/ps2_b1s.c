@@ -4,13 +4,11 @@
 /* B1S (found in 7 Wonders of the Ancient World) */
 VGMSTREAM * init_vgmstream_ps2_b1s(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 		int channel_count;
 		off_t start_offset;
     
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("b1s",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"b1s")) goto fail;
 
     if ((read_32bitLE(0x04,streamFile)+0x18) != get_streamfile_size(streamFile))
         goto fail;
@@ -35,7 +33,7 @@ VGMSTREAM * init_vgmstream_ps2_b1s(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
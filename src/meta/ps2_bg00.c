@@ -5,14 +5,12 @@
 Note: Seems the Loop Infos are stored external... */
 VGMSTREAM * init_vgmstream_bg00(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("bg00",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"bg00")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x42473030) /* "BG00" */
@@ -44,7 +42,7 @@ VGMSTREAM * init_vgmstream_bg00(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
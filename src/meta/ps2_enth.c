@@ -4,15 +4,13 @@
 /* ENTH (from Enthusia - Professional Racing) */
 VGMSTREAM * init_vgmstream_ps2_enth(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 	int header_check;
     int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("enth",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"enth")) goto fail;
 
 	/* check header and loop_flag */
 	header_check = read_32bitBE(0x00,streamFile);
@@ -73,7 +71,7 @@ VGMSTREAM * init_vgmstream_ps2_enth(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
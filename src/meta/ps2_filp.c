@@ -5,15 +5,13 @@
 /* FILp (Resident Evil - Dead Aim) */
 VGMSTREAM * init_vgmstream_filp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
     int channel_count;
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("filp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"filp")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x46494C70) /* "FILp" */
@@ -43,7 +41,7 @@ VGMSTREAM * init_vgmstream_filp(STREAMFILE *streamFile) {
     /* open the file for reading */
     {
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -5,7 +5,6 @@
 
 VGMSTREAM * init_vgmstream_ps2_gbts(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int channel_count;
@@ -17,8 +16,7 @@ VGMSTREAM * init_vgmstream_ps2_gbts(STREAMFILE *streamFile) {
 	int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("gbts",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"gbts")) goto fail;
 
 	/* check loop */
 	start_offset=0x801;
@@ -73,7 +71,7 @@ VGMSTREAM * init_vgmstream_ps2_gbts(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
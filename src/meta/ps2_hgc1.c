@@ -4,14 +4,12 @@
 /* hgC1 (from Knights of the Temple 2) */
 VGMSTREAM * init_vgmstream_hgc1(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("hgc1",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"hgc1")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x68674331) /* "hgC1" */
@@ -43,7 +41,7 @@ VGMSTREAM * init_vgmstream_hgc1(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
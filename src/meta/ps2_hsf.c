@@ -5,7 +5,6 @@
 VGMSTREAM * init_vgmstream_ps2_hsf(STREAMFILE *streamFile) 
 {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
     int channel_count;
@@ -19,8 +18,7 @@ VGMSTREAM * init_vgmstream_ps2_hsf(STREAMFILE *streamFile)
 #endif
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("hsf",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"hsf")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x48534600) // "HSF"
@@ -81,7 +79,7 @@ VGMSTREAM * init_vgmstream_ps2_hsf(STREAMFILE *streamFile)
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
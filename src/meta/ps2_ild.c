@@ -5,15 +5,13 @@
 
 VGMSTREAM * init_vgmstream_ps2_ild(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int loop_flag=0;
     int channel_count;
     off_t start_offset;
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("ild",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"ild")) goto fail;
 
     /* check ILD Header */
     if (read_32bitBE(0x00,streamFile) != 0x494C4400)
@@ -50,7 +48,7 @@ VGMSTREAM * init_vgmstream_ps2_ild(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -4,16 +4,13 @@
 /* KCES (from Dance Dance Revolution) */
 VGMSTREAM * init_vgmstream_ps2_kces(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("kces",filename_extension(filename)) &&
-        strcasecmp("vig",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"kces,vig")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x01006408)
@@ -50,7 +47,7 @@ VGMSTREAM * init_vgmstream_ps2_kces(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
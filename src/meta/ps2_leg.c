@@ -5,14 +5,12 @@
 the headers are stored seperately in the main executable... */
 VGMSTREAM * init_vgmstream_leg(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("leg",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"leg")) goto fail;
 
     /* comparing the filesize with (num_samples*0x800) + headersize,
     if it doesn't match, we will abort the vgmstream... */
@@ -45,7 +43,7 @@ VGMSTREAM * init_vgmstream_leg(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
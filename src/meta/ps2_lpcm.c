@@ -4,15 +4,13 @@
 /* LPCM (from Ah! My Goddess (PS2)) */
 VGMSTREAM * init_vgmstream_ps2_lpcm(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag;
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("lpcm",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"lpcm")) goto fail;
 
     /* check header */
     if (read_32bitBE(0,streamFile) != 0x4C50434D) /* LPCM */
@@ -43,7 +41,7 @@ VGMSTREAM * init_vgmstream_ps2_lpcm(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
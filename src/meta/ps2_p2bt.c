@@ -5,7 +5,6 @@
 
 VGMSTREAM * init_vgmstream_ps2_p2bt(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int channel_count;
@@ -13,8 +12,7 @@ VGMSTREAM * init_vgmstream_ps2_p2bt(STREAMFILE *streamFile) {
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("p2bt",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"p2bt")) goto fail;
 
 	if((read_32bitBE(0x00,streamFile)!=0x4d4F5645) && // MOVE 
 	   (read_32bitBE(0x00,streamFile)!=0x50324254))   // P2BT
@@ -51,7 +49,7 @@ VGMSTREAM * init_vgmstream_ps2_p2bt(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -5,7 +5,6 @@
 
 VGMSTREAM * init_vgmstream_ps2_pnb(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int channel_count;
@@ -13,8 +12,7 @@ VGMSTREAM * init_vgmstream_ps2_pnb(STREAMFILE *streamFile) {
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("pnb",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"pnb")) goto fail;
 
 	/* check loop */
 	loop_flag = (read_32bitLE(0x0C,streamFile)!=0xFFFFFFFF);
@@ -47,7 +45,7 @@ VGMSTREAM * init_vgmstream_ps2_pnb(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
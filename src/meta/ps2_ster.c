@@ -4,15 +4,13 @@
 /* STER (from Juuni Kokuki: Kakukaku Taru Ou Michi Beni Midori no Uka) */
 VGMSTREAM * init_vgmstream_ps2_ster(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag;
    int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("ster",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"ster")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x53544552) /* "STER" */
@@ -45,7 +43,7 @@ VGMSTREAM * init_vgmstream_ps2_ster(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
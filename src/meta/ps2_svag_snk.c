@@ -9,7 +9,6 @@
 
 VGMSTREAM * init_vgmstream_ps2_svag_snk(STREAMFILE* streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     off_t start_offset = 0x20;
 
@@ -19,8 +18,7 @@ VGMSTREAM * init_vgmstream_ps2_svag_snk(STREAMFILE* streamFile) {
     int loop_end_block;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("svag",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"svag")) goto fail;
 
     /* check SNK SVAG Header ("VAGm") */
     if (read_32bitBE(0x00,streamFile) != 0x5641476D)
@@ -58,7 +56,7 @@ VGMSTREAM * init_vgmstream_ps2_svag_snk(STREAMFILE* streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
 
         for (i=0;i<channel_count;i++) {
@@ -5,7 +5,6 @@
 /* probably TECMO Vag Stream */
 VGMSTREAM * init_vgmstream_ps2_tec(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
   	int loop_flag;
 	  int channel_count;
     int current_chunk;
@@ -14,8 +13,7 @@ VGMSTREAM * init_vgmstream_ps2_tec(STREAMFILE *streamFile) {
     int Founddata = 0;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("tec",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"tec")) goto fail;
 
     loop_flag = 0;
     channel_count = 2;
@@ -72,7 +70,7 @@ VGMSTREAM * init_vgmstream_ps2_tec(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
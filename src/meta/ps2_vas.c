@@ -4,14 +4,12 @@
 /* VAS (from Pro Baseball Spirits 5) */
 VGMSTREAM * init_vgmstream_ps2_vas(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("vas",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"vas")) goto fail;
 
     /* check header */
 #if 0
@@ -45,7 +43,7 @@ VGMSTREAM * init_vgmstream_ps2_vas(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
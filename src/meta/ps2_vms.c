@@ -4,7 +4,6 @@
 /* VMS (Autobahn Raser: Police Madness [SLES-53536]) */
 VGMSTREAM * init_vgmstream_ps2_vms(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     
     int loop_flag = 0;
@@ -12,8 +11,7 @@ VGMSTREAM * init_vgmstream_ps2_vms(STREAMFILE *streamFile) {
     int header_size;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("vms",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"vms")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x564D5320)
@@ -45,7 +43,7 @@ VGMSTREAM * init_vgmstream_ps2_vms(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
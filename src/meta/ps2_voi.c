@@ -4,14 +4,12 @@
 /* VOI - found in "RAW Danger" (PS2) */
 VGMSTREAM * init_vgmstream_ps2_voi(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int loop_flag = 0;
 		int channel_count;
     off_t start_offset;
     
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("voi",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"voi")) goto fail;
 
     /* check header */
     if (((read_32bitLE(0x04,streamFile)*2)+0x800) != (get_streamfile_size(streamFile)))
@@ -60,7 +58,7 @@ VGMSTREAM * init_vgmstream_ps2_voi(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
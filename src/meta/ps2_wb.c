@@ -4,15 +4,13 @@
 /* WB (from Shooting Love. ~TRIZEAL~) */
 VGMSTREAM * init_vgmstream_ps2_wb(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag;
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("wb",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"wb")) goto fail;
 
     /* check header */
     if (read_32bitBE(0,streamFile) != 0x00000000)
@@ -43,7 +41,7 @@ VGMSTREAM * init_vgmstream_ps2_wb(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
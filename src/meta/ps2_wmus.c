@@ -26,12 +26,11 @@ VGMSTREAM * init_vgmstream_ps2_wmus(STREAMFILE *streamFile)
 	//_TCHAR szBuffer[100];
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    
-	if (strcasecmp("wmus",filename_extension(filename))) 
+	if (!check_extensions(streamFile,"wmus"))
 	{
 		goto fail;
 	}
+    streamFile->get_name(streamFile,filename,sizeof(filename));
 	
 	/* check for .WHED file */
 	strcpy(filenameWHED, filename);
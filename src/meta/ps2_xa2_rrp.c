@@ -4,15 +4,13 @@
 /* XA2 (RC Revenge Pro) */
 VGMSTREAM * init_vgmstream_ps2_xa2_rrp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag = 0;
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("xa2",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"xa2")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x50,streamFile) != 0x00000000)
@@ -42,7 +40,7 @@ VGMSTREAM * init_vgmstream_ps2_xa2_rrp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -9,7 +9,6 @@
 VGMSTREAM * init_vgmstream_ps3_ivag(STREAMFILE *streamFile) 
 {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     
     off_t start_offset;
 
@@ -17,8 +16,7 @@ VGMSTREAM * init_vgmstream_ps3_ivag(STREAMFILE *streamFile)
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("ivag",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"ivag")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x49564147) // "IVAG"
@@ -61,7 +59,7 @@ VGMSTREAM * init_vgmstream_ps3_ivag(STREAMFILE *streamFile)
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         
         for (i=0;i<channel_count;i++)
@@ -10,7 +10,6 @@ static int check_psadpcm(STREAMFILE *streamFile);
 VGMSTREAM * init_vgmstream_ps_headerless(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
     off_t start_offset = 0x00;
-    char filename[PATH_LIMIT];
 
     uint8_t mibBuffer[0x10];
     uint8_t testBuffer[0x10];
@@ -41,13 +40,7 @@ VGMSTREAM * init_vgmstream_ps_headerless(STREAMFILE *streamFile) {
      * .vb: Tantei Jinguuji Saburo - Mikan no Rupo (PS1)
      * .xag: Hagane no Renkinjutsushi - Dream Carnival (PS2)
      * */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("cvs",filename_extension(filename)) &&
-        strcasecmp("mib",filename_extension(filename)) && 
-        strcasecmp("mi4",filename_extension(filename)) &&
-        strcasecmp("snds",filename_extension(filename))&&
-        strcasecmp("vb",filename_extension(filename))  &&
-        strcasecmp("xag",filename_extension(filename)))
+    if (!check_extensions(streamFile,"cvs,mib,mi4,snds,vb,xag"))
         goto fail;
 
     /* test if raw PS-ADPCM */
@@ -135,10 +128,10 @@ VGMSTREAM * init_vgmstream_ps_headerless(STREAMFILE *streamFile) {
         channel_count=1;
 
     // force no loop
-    if(!strcasecmp("vb",filename_extension(filename)))
+    if(check_extensions(streamFile,"vb"))
         loopStart=0;
 
-    if(!strcasecmp("xag",filename_extension(filename)))
+    if(check_extensions(streamFile,"xag"))
         channel_count=2;
 
     // Calc Loop Points & Interleave ...
@@ -202,8 +195,7 @@ VGMSTREAM * init_vgmstream_ps_headerless(STREAMFILE *streamFile) {
             channel_count=newChannelCount;
     }
 
-    if (!strcasecmp("cvs", filename_extension(filename)) ||
-        !strcasecmp("vb",filename_extension(filename)))
+    if (check_extensions(streamFile,"cvs,vb"))
         channel_count=1;
 
 
@@ -216,20 +208,19 @@ VGMSTREAM * init_vgmstream_ps_headerless(STREAMFILE *streamFile) {
 
     vgmstream->interleave_block_size = interleave;
 
-    if(!strcasecmp("mib",filename_extension(filename)))
+    if(check_extensions(streamFile,"mib"))
         vgmstream->sample_rate = 44100;
 
-    if(!strcasecmp("mi4",filename_extension(filename)))
+    if(check_extensions(streamFile,"mi4"))
         vgmstream->sample_rate = 48000;
 
-    if(!strcasecmp("snds", filename_extension(filename)))
+    if(check_extensions(streamFile,"snds"))
         vgmstream->sample_rate = 48000;
 
-    if(!strcasecmp("xag",filename_extension(filename)))
+    if(check_extensions(streamFile,"xag"))
         vgmstream->sample_rate = 44100;
 
-    if (!strcasecmp("cvs", filename_extension(filename)) ||
-        !strcasecmp("vb",filename_extension(filename)))
+    if (check_extensions(streamFile,"cvs,vb"))
         vgmstream->sample_rate = 22050;
 
     vgmstream->num_samples = (int32_t)(fileLength/16/channel_count*28);
@@ -14,7 +14,6 @@
 
 VGMSTREAM * init_vgmstream_psx_gms(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int channel_count;
@@ -22,8 +21,7 @@ VGMSTREAM * init_vgmstream_psx_gms(STREAMFILE *streamFile) {
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("gms",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"gms")) goto fail;
 
     /* check loop */
 	loop_flag = (read_32bitLE(0x20,streamFile)==0);
@@ -57,7 +55,7 @@ VGMSTREAM * init_vgmstream_psx_gms(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -11,12 +11,10 @@
 
 VGMSTREAM * init_vgmstream_raw(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 	int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("raw",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"raw")) goto fail;
 
     /* No check to do as they are raw pcm */
 
@@ -38,7 +36,7 @@ VGMSTREAM * init_vgmstream_raw(STREAMFILE *streamFile) {
         STREAMFILE *chstreamfile;
 
         /* have both channels use the same buffer, as interleave is so small */
-        chstreamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        chstreamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         
         if (!chstreamfile) goto fail;
 
@@ -15,7 +15,6 @@ static uint32_t find_key(uint32_t firstword) {
    RS3D - RedSpark (Mario & Luigi: Dream Team I fi*/
 VGMSTREAM * init_vgmstream_redspark(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag;
 	int channel_count;
@@ -29,8 +28,7 @@ VGMSTREAM * init_vgmstream_redspark(STREAMFILE *streamFile) {
 	get_32bit = get_32bitBE;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-	if (strcasecmp("rsd", filename_extension(filename))) goto fail;
+	if (!check_extensions(streamFile,"rsd")) goto fail;
     /* decrypt into buffer */
     {
         uint32_t data;
@@ -129,7 +127,7 @@ VGMSTREAM * init_vgmstream_redspark(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
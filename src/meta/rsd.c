@@ -6,15 +6,13 @@
 /* RSD2VAG */
 VGMSTREAM * init_vgmstream_rsd2vag(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534432) /* RSD2 */
@@ -48,7 +46,7 @@ VGMSTREAM * init_vgmstream_rsd2vag(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -72,15 +70,13 @@ fail:
 /* RSD2PCMB - Big Endian */
 VGMSTREAM * init_vgmstream_rsd2pcmb(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534432) /* RSD2 */
@@ -121,7 +117,7 @@ VGMSTREAM * init_vgmstream_rsd2pcmb(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -187,15 +183,13 @@ fail:
 /* RSD3VAG */
 VGMSTREAM * init_vgmstream_rsd3vag(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534433) /* RSD3 */
@@ -229,7 +223,7 @@ VGMSTREAM * init_vgmstream_rsd3vag(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -253,15 +247,13 @@ fail:
 /* RSD3GADP */
 VGMSTREAM * init_vgmstream_rsd3gadp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534433) /* RSD3 */
@@ -300,7 +292,7 @@ VGMSTREAM * init_vgmstream_rsd3gadp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -324,15 +316,13 @@ fail:
 /* RSD3PCM  - Little Endian */
 VGMSTREAM * init_vgmstream_rsd3pcm(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534433) /* RSD3 */
@@ -373,7 +363,7 @@ VGMSTREAM * init_vgmstream_rsd3pcm(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -398,15 +388,13 @@ fail:
 /* RSD3PCMB - Big Endian */
 VGMSTREAM * init_vgmstream_rsd3pcmb(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534433) /* RSD3 */
@@ -447,7 +435,7 @@ VGMSTREAM * init_vgmstream_rsd3pcmb(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -472,15 +460,13 @@ fail:
 /* RSD4VAG */
 VGMSTREAM * init_vgmstream_rsd4vag(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534434) /* RSD4 */
@@ -514,7 +500,7 @@ VGMSTREAM * init_vgmstream_rsd4vag(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -538,15 +524,13 @@ fail:
 /* RSD4PCM  - Little Endian */
 VGMSTREAM * init_vgmstream_rsd4pcm(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534434) /* RSD4 */
@@ -580,7 +564,7 @@ VGMSTREAM * init_vgmstream_rsd4pcm(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -605,15 +589,13 @@ fail:
 /* RSD4PCMB - Big Endian */
 VGMSTREAM * init_vgmstream_rsd4pcmb(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534434) /* RSD4 */
@@ -647,7 +629,7 @@ VGMSTREAM * init_vgmstream_rsd4pcmb(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -670,15 +652,13 @@ fail:
 /* RSD4RADP */
 VGMSTREAM * init_vgmstream_rsd4radp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534434) /* RSD4 */
@@ -711,7 +691,7 @@ VGMSTREAM * init_vgmstream_rsd4radp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -731,15 +711,13 @@ fail:
 /* RSD6RADP */
 VGMSTREAM * init_vgmstream_rsd6radp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534436) /* RSD6 */
@@ -772,7 +750,7 @@ VGMSTREAM * init_vgmstream_rsd6radp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -792,15 +770,13 @@ fail:
 /* RSD6VAG */
 VGMSTREAM * init_vgmstream_rsd6vag(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
 	int loop_flag;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x0,streamFile) != 0x52534436) /* RSD6 */
@@ -834,7 +810,7 @@ VGMSTREAM * init_vgmstream_rsd6vag(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -6,14 +6,12 @@
 
 VGMSTREAM * init_vgmstream_rsf(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     size_t file_size;
 
     /* check extension, case insensitive */
     /* this is all we have to go on, rsf is completely headerless */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rsf",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rsf")) goto fail;
 
     file_size = get_streamfile_size(streamFile);
 
@@ -51,7 +49,7 @@ VGMSTREAM * init_vgmstream_rsf(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<2;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -93,7 +93,6 @@ static void read_rwar(struct rwav_data * rd)
  * single stream form here */
 VGMSTREAM * init_vgmstream_rwsd(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     coding_t coding_type;
 
@@ -119,9 +118,7 @@ VGMSTREAM * init_vgmstream_rwsd(STREAMFILE *streamFile) {
     rwav_data.wave_offset = -1;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-
-    ext = filename_extension(filename);
+    ext = get_streamfile_ext_ref(streamFile);
 
     if (strcasecmp("rwsd",ext))
     {
@@ -368,7 +365,7 @@ VGMSTREAM * init_vgmstream_rwsd(STREAMFILE *streamFile) {
     {
         int i;
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
 
@@ -3,15 +3,13 @@
 /* RWX (found in Air Force Delta Storm (XBOX)) */
 VGMSTREAM * init_vgmstream_rwx(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("rwx",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"rwx")) goto fail;
 
 	/* check header */
     if (read_32bitBE(0x00,streamFile) != 0x52415758)
@@ -45,7 +43,7 @@ VGMSTREAM * init_vgmstream_rwx(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -22,8 +22,7 @@ VGMSTREAM * init_vgmstream_s14_sss(STREAMFILE *streamFile) {
     /* raw siren comes in 3 frame sizes, try to guess the correct one
      * (should try to decode and check the error flag but it isn't currently reported) */
     {
-        char filename[PATH_LIMIT];
-        streamFile->get_name(streamFile,filename,sizeof(filename));
+        const char * filename = get_streamfile_name_ref(streamFile);
 
         /* horrid but I ain't losing sleep over it (besides the header must be somewhere as some tracks loop) */
         if (strstr(filename,"S037")==filename || strstr(filename,"b06")==filename) /* Korogashi Puzzle Katamari Damacy */
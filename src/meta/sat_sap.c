@@ -4,15 +4,13 @@
 /* SAP (from Bubble_Symphony) */
 VGMSTREAM * init_vgmstream_sat_sap(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sap",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"sap")) goto fail;
 
 
     /* check header */
@@ -46,7 +44,7 @@ VGMSTREAM * init_vgmstream_sat_sap(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -17,8 +17,8 @@ VGMSTREAM * init_vgmstream_spt_spd(STREAMFILE *streamFile) {
   int i;
 
   /* check extension, case insensitive */
+    if (!check_extensions(streamFile,"spd")) goto fail;
     streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("spd",filename_extension(filename))) goto fail;
 
   	strcpy(filenameSPT,filename);
 	  strcpy(filenameSPT+strlen(filenameSPT)-3,"spt");
@@ -4,16 +4,13 @@
 /* STR -ASR (from Donkey Kong Jet Race) */
 VGMSTREAM * init_vgmstream_str_asr(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
 
     int loop_flag = 0;
 	int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("str",filename_extension(filename)) &&	/* PCM Files */
-		strcasecmp("asr",filename_extension(filename)))		/* DSP Files */
+    if (!check_extensions(streamFile,"str,asr")) /* PCM Files, DSP Files */
 	goto fail;
 		
     /* check header */
@@ -76,7 +73,7 @@ VGMSTREAM * init_vgmstream_str_asr(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -10,7 +10,6 @@
 
 VGMSTREAM * init_vgmstream_str_snds(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int channel_count;
     int loop_flag = 0;
@@ -21,8 +20,7 @@ VGMSTREAM * init_vgmstream_str_snds(STREAMFILE *streamFile) {
     size_t file_size;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("str",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"str")) goto fail;
 
     /* check for opening CTRL or SNDS chunk */
     if (read_32bitBE(0x0,streamFile) != 0x4354524c &&   /* CTRL */
@@ -135,8 +133,7 @@ VGMSTREAM * init_vgmstream_str_snds(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         int i;
-        vgmstream->ch[0].streamfile = streamFile->open(streamFile,filename,
-                STREAMFILE_DEFAULT_BUFFER_SIZE);
+        vgmstream->ch[0].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!vgmstream->ch[0].streamfile) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = vgmstream->ch[0].streamfile;
@@ -3,14 +3,12 @@
 
 VGMSTREAM * init_vgmstream_stx(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     const int loop_flag = 0;
     const int channel_count = 2;    /* .stx seems to be stereo only */
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("stx",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"stx")) goto fail;
 
     /* length of data */
     if (read_32bitBE(0x00,streamFile) !=
@@ -49,7 +47,7 @@ VGMSTREAM * init_vgmstream_stx(STREAMFILE *streamFile) {
         int i;
 
         /* both channels use same buffer, as interleave is so small */
-        chstreamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        chstreamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!chstreamfile) goto fail;
 
         for (i=0;i<channel_count;i++) {
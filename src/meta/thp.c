@@ -9,7 +9,6 @@ VGMSTREAM * init_vgmstream_thp(STREAMFILE *streamFile) {
     
     VGMSTREAM * vgmstream = NULL;
 
-    char filename[PATH_LIMIT];
     off_t start_offset;
     
     uint32_t maxAudioSize=0;
@@ -25,9 +24,7 @@ VGMSTREAM * init_vgmstream_thp(STREAMFILE *streamFile) {
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("thp",filename_extension(filename)) &&
-        strcasecmp("dsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"thp,dsp")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x54485000)
@@ -80,7 +77,7 @@ VGMSTREAM * init_vgmstream_thp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -5,7 +5,6 @@
 /* BNS - Wii "Banner Sound" disc jingle */
 VGMSTREAM * init_vgmstream_wii_bns(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t BNS_offset;
     uint32_t info_offset=0,data_offset=0;
     uint32_t channel_info_offset_list_offset;
@@ -15,8 +14,7 @@ VGMSTREAM * init_vgmstream_wii_bns(STREAMFILE *streamFile) {
     uint32_t sample_count, loop_start;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("bns",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"bns")) goto fail;
 
     // check header
     BNS_offset = 0;
@@ -132,7 +130,7 @@ VGMSTREAM * init_vgmstream_wii_bns(STREAMFILE *streamFile) {
             /* always been 0... */
             if (read_32bitBE(channel_info_offset+8,streamFile) != 0) goto fail;
 
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
             if (!vgmstream->ch[i].streamfile) goto fail;
 
             vgmstream->ch[i].channel_start_offset=
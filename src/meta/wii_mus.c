@@ -7,7 +7,6 @@
 /* Doesn't seem to be working quite right yet, coef table looks odd */
 VGMSTREAM * init_vgmstream_wii_mus(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     off_t start_offset;
     off_t interleave;
@@ -26,8 +25,7 @@ VGMSTREAM * init_vgmstream_wii_mus(STREAMFILE *streamFile) {
     } channel[2];
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("mus",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"mus")) goto fail;
 
     start_offset = read_32bitBE(0x08,streamFile);
     interleave = read_32bitBE(0x04,streamFile);
@@ -100,9 +98,9 @@ VGMSTREAM * init_vgmstream_wii_mus(STREAMFILE *streamFile) {
     vgmstream->ch[1].adpcm_history1_16 = channel[1].initial_hist1;
     vgmstream->ch[1].adpcm_history2_16 = channel[1].initial_hist2;
 
-    vgmstream->ch[0].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+    vgmstream->ch[0].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
     if (!vgmstream->ch[0].streamfile) goto fail;
-    vgmstream->ch[1].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+    vgmstream->ch[1].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
     if (!vgmstream->ch[1].streamfile) goto fail;
 
     /* open the file for reading */
@@ -4,7 +4,6 @@
 /* SNG (from Excite Truck [WII]) */
 VGMSTREAM * init_vgmstream_wii_sng(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int i;
     int loop_flag;
@@ -19,8 +18,7 @@ VGMSTREAM * init_vgmstream_wii_sng(STREAMFILE *streamFile) {
     off_t current_chunk;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sng",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"sng")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x30545352) /* "0STR" */
@@ -95,7 +93,7 @@ VGMSTREAM * init_vgmstream_wii_sng(STREAMFILE *streamFile) {
     /* open the file for reading */
     {
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -106,7 +104,7 @@ VGMSTREAM * init_vgmstream_wii_sng(STREAMFILE *streamFile) {
 
 	/* The second channel */
     if (channel_count == 2) {
-        vgmstream->ch[1].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        vgmstream->ch[1].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
         if (!vgmstream->ch[1].streamfile) goto fail;
 
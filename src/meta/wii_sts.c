@@ -9,7 +9,6 @@
 
 VGMSTREAM * init_vgmstream_wii_sts(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int channel_count;
@@ -17,8 +16,7 @@ VGMSTREAM * init_vgmstream_wii_sts(STREAMFILE *streamFile) {
 	off_t	start_offset;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("sts",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"sts")) goto fail;
 
 	/* First bytes contain the size of the file (-4) */
 	if(read_32bitBE(0x0,streamFile)!=get_streamfile_size(streamFile)-4)
@@ -71,7 +69,7 @@ VGMSTREAM * init_vgmstream_wii_sts(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
             vgmstream->ch[i].offset = 0x50+(i*(start_offset+0x26-0x50));
 
             if (!vgmstream->ch[i].streamfile) goto fail;
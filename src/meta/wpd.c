@@ -4,14 +4,12 @@
 /* WPD (from Shuffle! (PC)) */
 VGMSTREAM * init_vgmstream_wpd(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int channel_count;
     int loop_flag;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("wpd",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"wpd")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x20445057) /* " DPW" */
@@ -38,7 +36,7 @@ VGMSTREAM * init_vgmstream_wpd(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
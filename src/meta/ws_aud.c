@@ -6,7 +6,6 @@
 
 VGMSTREAM * init_vgmstream_ws_aud(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     coding_t coding_type = -1;
     off_t format_offset;
@@ -17,8 +16,7 @@ VGMSTREAM * init_vgmstream_ws_aud(STREAMFILE *streamFile) {
     int bytes_per_sample = 0;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("aud",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"aud")) goto fail;
 
     /* check for 0x0000DEAF chunk marker for first chunk */
     if (read_32bitLE(0x10,streamFile)==0x0000DEAF) {    /* new */
@@ -107,8 +105,7 @@ VGMSTREAM * init_vgmstream_ws_aud(STREAMFILE *streamFile) {
         int i;
         STREAMFILE * file;
 
-        file = streamFile->open(streamFile,filename,
-                STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
 
         for (i=0;i<channel_count;i++) {
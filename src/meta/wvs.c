@@ -54,14 +54,12 @@ fail:
 */
 VGMSTREAM * init_vgmstream_ngc_wvs(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag;
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("wvs",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"wvs")) goto fail;
 
     if ((read_32bitBE(0x14,streamFile)*read_32bitBE(0x00,streamFile)+0x60)
         != (get_streamfile_size(streamFile)))
@@ -113,7 +111,7 @@ VGMSTREAM * init_vgmstream_ngc_wvs(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -11,15 +11,13 @@
 */
 VGMSTREAM * init_vgmstream_x360_tra(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int channel_count;
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("tra",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"tra")) goto fail;
 
     /* No loop on wavm */
 	loop_flag = 0;
@@ -45,7 +43,7 @@ VGMSTREAM * init_vgmstream_x360_tra(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
 
             if (!vgmstream->ch[i].streamfile) goto fail;
         }
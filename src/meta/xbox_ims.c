@@ -9,15 +9,13 @@
 
 VGMSTREAM * init_vgmstream_xbox_matx(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
 
     int loop_flag=0;
 	int channel_count;
     int i;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("matx",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"matx")) goto fail;
 
 	loop_flag = 0;
 	channel_count=read_16bitLE(0x4,streamFile);
@@ -37,7 +35,7 @@ VGMSTREAM * init_vgmstream_xbox_matx(STREAMFILE *streamFile) {
     /* open the file for reading by each channel */
     {
         for (i=0;i<channel_count;i++) {
-            vgmstream->ch[i].streamfile = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+            vgmstream->ch[i].streamfile = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
             if (!vgmstream->ch[i].streamfile) goto fail;
         }
     }
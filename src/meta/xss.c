@@ -4,14 +4,12 @@
 /* XSS (found in Dino Crisis 3) */
 VGMSTREAM * init_vgmstream_xss(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     off_t start_offset;
     int loop_flag = 0;
     int channel_count;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("xss",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"xss")) goto fail;
 
     /* check header */
     if ((uint16_t)read_16bitLE(0x15A,streamFile) != 0x10)
@@ -51,7 +49,7 @@ VGMSTREAM * init_vgmstream_xss(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -4,14 +4,12 @@
 /* YDSP (from WWE Day of Reckoning) */
 VGMSTREAM * init_vgmstream_ydsp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int loop_flag;
     int channel_count;
     off_t start_offset;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("ydsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"ydsp")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x59445350) /* "YDSP" */
@@ -72,7 +70,7 @@ VGMSTREAM * init_vgmstream_ydsp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
@@ -4,15 +4,13 @@
 /* ZWDSP (hcs' custom DSP files from Zack & Wiki) */
 VGMSTREAM * init_vgmstream_zwdsp(STREAMFILE *streamFile) {
     VGMSTREAM * vgmstream = NULL;
-    char filename[PATH_LIMIT];
     int second_channel_start;
     int loop_flag;
     int channel_count = 2;
     off_t start_offset;
 
     /* check extension, case insensitive */
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    if (strcasecmp("zwdsp",filename_extension(filename))) goto fail;
+    if (!check_extensions(streamFile,"zwdsp")) goto fail;
 
     /* check header */
     if (read_32bitBE(0x00,streamFile) != 0x00000000) /* 0x0 */
@@ -70,7 +68,7 @@ VGMSTREAM * init_vgmstream_zwdsp(STREAMFILE *streamFile) {
     {
         int i;
         STREAMFILE * file;
-        file = streamFile->open(streamFile,filename,STREAMFILE_DEFAULT_BUFFER_SIZE);
+        file = reopen_streamfile(streamFile, STREAMFILE_DEFAULT_BUFFER_SIZE);
         if (!file) goto fail;
         for (i=0;i<channel_count;i++) {
             vgmstream->ch[i].streamfile = file;
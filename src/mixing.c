@@ -0,0 +1,304 @@
+#include "vgmstream.h"
+#include "mixing.h"
+
+
+/* Output mixing: output channels are a weighted sum of input (decoded) channels, with a matrix set
+ * once per stream. render_vgmstream decodes in chunks to an internal buffer then mixes to the
+ * caller's buffer, so the caller only needs to handle output channels.
+ *
+ * Mixing is done in float per output channel, skipping zero weights (most downmix matrixes are
+ * sparse), and in simple loops so compilers may vectorize them. Plain channel selection (each
+ * output copying one input) is a straight copy. */
+
+#define MIXING_MAX_CHANNELS  64
+
+typedef struct {
+    int input_channels;
+    int output_channels;
+    float gain;
+    float * matrix;         /* [output][input] as configured */
+    float * weights;        /* matrix * gain */
+    int select[MIXING_MAX_CHANNELS]; /* per output: input to copy, or -1 if it's a real mix */
+    int select_only;        /* all outputs are copies */
+    sample * buffer;        /* decoded input, MIXING_BUFFER_SAMPLES */
+    float * accum;          /* one output channel, MIXING_BUFFER_SAMPLES */
+} mixing_data;
+
+
+/* gets the mixing config, allocating on first use (in the VGMSTREAM's arena, so it's freed on close) */
+static mixing_data * get_mixing(VGMSTREAM * vgmstream) {
+    mixing_data * mix = vgmstream->mixing_data;
+    int input_channels = vgmstream->channels;
+    size_t matrix_size = MIXING_MAX_CHANNELS * input_channels * sizeof(float);
+
+    if (mix)
+        return mix;
+    if (input_channels <= 0 || input_channels > MIXING_MAX_CHANNELS)
+        return NULL;
+
+    mix = vgmstream_arena_alloc(vgmstream, sizeof(mixing_data));
+    if (!mix) return NULL;
+    mix->matrix = vgmstream_arena_alloc(vgmstream, matrix_size);
+    mix->weights = vgmstream_arena_alloc(vgmstream, matrix_size);
+    mix->buffer = vgmstream_arena_alloc(vgmstream, MIXING_BUFFER_SAMPLES * input_channels * sizeof(sample));
+    mix->accum = vgmstream_arena_alloc(vgmstream, MIXING_BUFFER_SAMPLES * sizeof(float));
+    if (!mix->matrix || !mix->weights || !mix->buffer || !mix->accum)
+        return NULL;
+
+    mix->input_channels = input_channels;
+    mix->gain = 1.0f;
+    return mix;
+}
+
+/* activates mixing after a config change, also for the reset copy (or a reset would disable it) */
+static void update_mixing(VGMSTREAM * vgmstream, mixing_data * mix) {
+    int in, out;
+
+    mix->select_only = 1;
+    for (out = 0; out < mix->output_channels; out++) {
+        const float * row = &mix->matrix[out * mix->input_channels];
+        int used = 0;
+
+        mix->select[out] = -1;
+        for (in = 0; in < mix->input_channels; in++) {
+            mix->weights[out * mix->input_channels + in] = row[in] * mix->gain;
+            if (row[in] != 0.0f) {
+                used++;
+                mix->select[out] = in;
+            }
+        }
+
+        if (used != 1 || row[mix->select[out]] * mix->gain != 1.0f) {
+            mix->select[out] = -1;
+            mix->select_only = 0;
+        }
+    }
+
+    vgmstream->mixing_data = mix;
+    if (vgmstream->start_vgmstream) {
+        VGMSTREAM * start_vgmstream = vgmstream->start_vgmstream;
+        start_vgmstream->mixing_data = mix;
+    }
+}
+
+int vgmstream_mixing_matrix(VGMSTREAM * vgmstream, int output_channels, const float * matrix) {
+    mixing_data * mix;
+
+    if (!vgmstream || !matrix || output_channels <= 0 || output_channels > MIXING_MAX_CHANNELS)
+        return 0;
+    mix = get_mixing(vgmstream);
+    if (!mix) return 0;
+
+    memcpy(mix->matrix, matrix, output_channels * mix->input_channels * sizeof(float));
+    mix->output_channels = output_channels;
+
+    update_mixing(vgmstream, mix);
+    return 1;
+}
+
+int vgmstream_mixing_select(VGMSTREAM * vgmstream, int start_channel, int channel_count) {
+    float matrix[MIXING_MAX_CHANNELS * MIXING_MAX_CHANNELS] = {0};
+    int ch;
+
+    if (!vgmstream || start_channel < 0 || channel_count <= 0 || start_channel + channel_count > vgmstream->channels)
+        return 0;
+
+    for (ch = 0; ch < channel_count; ch++) {
+        matrix[ch * vgmstream->channels + start_channel + ch] = 1.0f;
+    }
+
+    return vgmstream_mixing_matrix(vgmstream, channel_count, matrix);
+}
+
+int vgmstream_mixing_downmix(VGMSTREAM * vgmstream, int output_channels) {
+    float matrix[MIXING_MAX_CHANNELS * MIXING_MAX_CHANNELS] = {0};
+    int input_channels, in, out;
+
+    if (!vgmstream || output_channels < 1 || output_channels > 2)
+        return 0;
+    input_channels = vgmstream->channels;
+    if (input_channels > MIXING_MAX_CHANNELS)
+        return 0;
+
+    if (input_channels == 6 && output_channels == 2) {
+        /* standard 5.1 (FL FR FC LFE BL BR), LFE is dropped */
+        const float center = 0.7071f, back = 0.7071f, norm = 1.0f / (1.0f + 0.7071f + 0.7071f);
+        matrix[0*6 + 0] = 1.0f * norm;
+        matrix[0*6 + 2] = center * norm;
+        matrix[0*6 + 4] = back * norm;
+        matrix[1*6 + 1] = 1.0f * norm;
+        matrix[1*6 + 2] = center * norm;
+        matrix[1*6 + 5] = back * norm;
+    }
+    else {
+        /* channels are usually stereo pairs/layers, so each input goes to (input % outputs),
+         * averaged to avoid clipping */
+        for (in = 0; in < input_channels; in++) {
+            out = in % output_channels;
+            matrix[out * input_channels + in] = 1.0f;
+        }
+        for (out = 0; out < output_channels; out++) {
+            int sources = 0;
+            for (in = 0; in < input_channels; in++) {
+                if (matrix[out * input_channels + in] != 0.0f)
+                    sources++;
+            }
+            for (in = 0; in < input_channels; in++) {
+                if (sources > 1)
+                    matrix[out * input_channels + in] /= sources;
+            }
+        }
+
+        /* mono input to stereo: copy to both sides */
+        if (input_channels == 1 && output_channels == 2) {
+            matrix[1] = 1.0f;
+        }
+    }
+
+    return vgmstream_mixing_matrix(vgmstream, output_channels, matrix);
+}
+
+int vgmstream_mixing_gain(VGMSTREAM * vgmstream, float gain) {
+    mixing_data * mix;
+    int ch;
+
+    if (!vgmstream || gain < 0.0f)
+        return 0;
+    mix = get_mixing(vgmstream);
+    if (!mix) return 0;
+
+    /* gain without a matrix applies to all channels */
+    if (mix->output_channels == 0) {
+        mix->output_channels = mix->input_channels;
+        for (ch = 0; ch < mix->input_channels; ch++) {
+            mix->matrix[ch * mix->input_channels + ch] = 1.0f;
+        }
+    }
+    mix->gain = gain;
+
+    update_mixing(vgmstream, mix);
+    return 1;
+}
+
+void vgmstream_mixing_disable(VGMSTREAM * vgmstream) {
+    if (!vgmstream)
+        return;
+
+    /* config memory stays in the arena, in case it's enabled again */
+    vgmstream->mixing_data = NULL;
+    if (vgmstream->start_vgmstream) {
+        VGMSTREAM * start_vgmstream = vgmstream->start_vgmstream;
+        start_vgmstream->mixing_data = NULL;
+    }
+}
+
+int get_vgmstream_output_channels(VGMSTREAM * vgmstream) {
+    mixing_data * mix = vgmstream->mixing_data;
+    return mix ? mix->output_channels : vgmstream->channels;
+}
+
+
+sample * mixing_get_buffer(VGMSTREAM * vgmstream) {
+    mixing_data * mix = vgmstream->mixing_data;
+    return mix ? mix->buffer : NULL;
+}
+
+void mixing_apply(VGMSTREAM * vgmstream, sample * outbuf, int32_t sample_count) {
+    mixing_data * mix = vgmstream->mixing_data;
+    int input_channels = mix->input_channels;
+    int output_channels = mix->output_channels;
+    const sample * inbuf = mix->buffer;
+    float * accum = mix->accum;
+    int s, in, out;
+
+    for (out = 0; out < output_channels; out++) {
+        const float * weights = &mix->weights[out * input_channels];
+
+        /* plain copy */
+        if (mix->select[out] >= 0) {
+            const sample * src = inbuf + mix->select[out];
+            for (s = 0; s < sample_count; s++) {
+                outbuf[s * output_channels + out] = src[s * input_channels];
+            }
+            continue;
+        }
+
+        for (s = 0; s < sample_count; s++) {
+            accum[s] = 0.0f;
+        }
+
+        for (in = 0; in < input_channels; in++) {
+            const sample * src = inbuf + in;
+            float weight = weights[in];
+            if (weight == 0.0f)
+                continue;
+
+            for (s = 0; s < sample_count; s++) {
+                accum[s] += src[s * input_channels] * weight;
+            }
+        }
+
+        for (s = 0; s < sample_count; s++) {
+            float value = accum[s];
+            if (value > 32767.0f) value = 32767.0f;
+            else if (value < -32768.0f) value = -32768.0f;
+            outbuf[s * output_channels + out] = (sample)value;
+        }
+    }
+}
+
+
+void mixing_apply_channel_mappings(VGMSTREAM * vgmstream, sample * buffer, int32_t sample_count) {
+    int channels = vgmstream->channels;
+    int map[MIXING_MAX_CHANNELS];
+    int identity = 1;
+    int ch, s;
+
+    if (channels > MIXING_MAX_CHANNELS)
+        return;
+
+    /* Custom mappings swap channel "i" with "[i]", in order. Doing the same swaps once to the channel
+     * indexes gives where each channel comes from, so samples can be moved once per frame. */
+    for (ch = 0; ch < channels; ch++) {
+        map[ch] = ch;
+    }
+    if (vgmstream->channel_mappings_on) {
+        int ch_from, ch_to, temp;
+        for (ch_from = 0; ch_from < channels && ch_from < 32; ch_from++) {
+            ch_to = vgmstream->channel_mappings[ch_from];
+            if (ch_to < 1 || ch_to > 32 || ch_to > channels-1 || ch_from == ch_to)
+                continue;
+
+            temp = map[ch_from];
+            map[ch_from] = map[ch_to];
+            map[ch_to] = temp;
+        }
+    }
+
+    /* channel bitmask to silence non-set channels (up to 32) */
+    if (vgmstream->channel_mask) {
+        for (ch = 0; ch < channels; ch++) {
+            if (ch >= 32 || !((vgmstream->channel_mask >> ch) & 1))
+                map[ch] = -1;
+        }
+    }
+
+    for (ch = 0; ch < channels; ch++) {
+        if (map[ch] != ch)
+            identity = 0;
+    }
+    if (identity)
+        return;
+
+    for (s = 0; s < sample_count; s++) {
+        sample frame[MIXING_MAX_CHANNELS];
+        sample * buf = buffer + s * channels;
+
+        for (ch = 0; ch < channels; ch++) {
+            frame[ch] = buf[ch];
+        }
+        for (ch = 0; ch < channels; ch++) {
+            buf[ch] = map[ch] < 0 ? 0 : frame[map[ch]];
+        }
+    }
+}
@@ -0,0 +1,21 @@
+/*
+ * mixing.h - output mixing (channel matrix, selection and gain) done after decoding
+ */
+#ifndef _MIXING_H_
+#define _MIXING_H_
+
+#include "vgmstream.h"
+
+/* max samples decoded at once into the mixing buffer */
+#define MIXING_BUFFER_SAMPLES  0x400
+
+/* Returns the buffer to decode input channels when mixing is active (MIXING_BUFFER_SAMPLES), or NULL. */
+sample * mixing_get_buffer(VGMSTREAM * vgmstream);
+
+/* Mixes sample_count decoded samples from the mixing buffer into outbuf (in output channels). */
+void mixing_apply(VGMSTREAM * vgmstream, sample * outbuf, int32_t sample_count);
+
+/* Applies channel_mappings/channel_mask (set by metas like TXTP) to a decoded buffer. */
+void mixing_apply_channel_mappings(VGMSTREAM * vgmstream, sample * buffer, int32_t sample_count);
+
+#endif /* _MIXING_H_ */
@@ -0,0 +1,459 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#include "vgmstream.h"
+#include "mixing.h"
+
+
+/* Parallel rendering: the output timeline is split into slices, decoded by worker threads with their own
+ * copy of the stream, then output in order. Only for codecs where each frame carries its own state (so
+ * decoding from a frame start doesn't depend on previous frames) and simple layouts: a copy is moved to
+ * its slice by running the layout without decoding (skip_decode), which is fast, then decodes for real.
+ * Slice starts are moved forward to the next frame start, found with a separate copy when opening, so
+ * output is the same as decoding sequentially. Copies reopen the file by name with stdio.
+ *
+ * Workers take slices in order, and at most a few slices ahead of output are decoded to bound memory. */
+
+#define PARALLEL_MAX_THREADS    64
+#define PARALLEL_SLICE_SAMPLES  0x40000 /* nominal (slices may be a bit longer to end on a frame) */
+#define PARALLEL_ALIGN_MAX      0x10000 /* max samples after a nominal start to find a frame start */
+#define PARALLEL_SKIP_SAMPLES   0x1000  /* samples per call when skipping */
+
+#ifdef _WIN32
+typedef HANDLE parallel_thread_t;
+#else
+typedef pthread_t parallel_thread_t;
+#endif
+
+struct VGMSTREAM_PARALLEL;
+
+typedef struct {
+    struct VGMSTREAM_PARALLEL * parallel;
+    VGMSTREAM * vgmstream;  /* own copy */
+    int32_t position;       /* samples rendered so far */
+    sample * scratch;       /* for skips */
+    parallel_thread_t thread;
+    int thread_started;
+} parallel_worker;
+
+typedef struct {
+    sample * buffer;        /* decoded samples (input channels) */
+    int slice;              /* slice in buffer once ready, or -1 */
+} parallel_slot;
+
+struct VGMSTREAM_PARALLEL {
+    VGMSTREAM * vgmstream;  /* config and mixing (not decoded) */
+    int channels;
+
+    int32_t * bounds;       /* slice N decodes bounds[N] to bounds[N+1] */
+    int slice_count;
+    int32_t position;       /* samples output so far */
+    int current;            /* slice being output */
+
+    parallel_worker * workers;
+    int worker_count;
+    parallel_slot * slots;  /* slice N goes to slot N % slot_count */
+    int slot_count;
+
+    vgm_mutex_t mutex;
+    vgm_cond_t cond;
+    /* shared with workers (mutex) */
+    int next_slice;         /* next slice to decode */
+    int done_slices;        /* slices fully output (their slots are free) */
+    int exit;
+};
+
+
+/* codecs whose frames can be decoded without previous frames (header has the ADPCM state, or no state) */
+static int is_parallel_codec(coding_t coding_type) {
+    switch (coding_type) {
+        case coding_PCM16LE:
+        case coding_PCM16BE:
+        case coding_PCM16_int:
+        case coding_PCM8:
+        case coding_PCM8_int:
+        case coding_PCM8_U:
+        case coding_PCM8_U_int:
+        case coding_PCM8_SB:
+        case coding_ULAW:
+        case coding_ULAW_int:
+        case coding_ALAW:
+        case coding_PCMFLOAT:
+        case coding_MSADPCM:
+        case coding_MSADPCM_int:
+        case coding_MS_IMA:
+        case coding_XBOX_IMA:
+        case coding_XBOX_IMA_int:
+        case coding_APPLE_IMA4:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* moves the stream forward as if sample_count samples were rendered */
+static void skip_samples(VGMSTREAM * vgmstream, sample * scratch, int32_t sample_count) {
+    vgmstream->skip_decode = 1;
+    while (sample_count > 0) {
+        int32_t samples_to_do = sample_count;
+        if (samples_to_do > PARALLEL_SKIP_SAMPLES)
+            samples_to_do = PARALLEL_SKIP_SAMPLES;
+
+        render_vgmstream(scratch, samples_to_do, vgmstream);
+        sample_count -= samples_to_do;
+    }
+    vgmstream->skip_decode = 0;
+}
+
+/* Returns samples until the next frame is decoded from its start (0 if at one now). A pending loop is done
+ * first as the layout would on the next render, since that changes where the next frame is. */
+static int32_t get_samples_to_frame(VGMSTREAM * vgmstream) {
+    int samples_per_frame;
+
+    if (vgmstream->loop_flag && vgmstream->current_sample == vgmstream->loop_end_sample)
+        vgmstream_do_loop(vgmstream);
+
+    samples_per_frame = get_vgmstream_samples_per_frame(vgmstream);
+    if (samples_per_frame <= 1 || vgmstream->samples_into_block % samples_per_frame == 0)
+        return 0;
+    return samples_per_frame - vgmstream->samples_into_block % samples_per_frame;
+}
+
+/* STREAMFILEs opened from the same one may share handles and buffers, so each copy gets its own */
+static VGMSTREAM * open_copy(VGMSTREAM * vgmstream, STREAMFILE * streamFile) {
+    VGMSTREAM * copy;
+    STREAMFILE * streamCopy;
+    char filename[PATH_LIMIT];
+
+    get_streamfile_name(streamFile, filename, sizeof(filename));
+    streamCopy = open_stdio_streamfile(filename);
+    if (!streamCopy) return NULL;
+    streamCopy->stream_index = streamFile->stream_index;
+
+    copy = init_vgmstream_from_STREAMFILE(streamCopy);
+    close_streamfile(streamCopy);
+    if (!copy) return NULL;
+
+    if (copy->channels != vgmstream->channels ||
+            copy->coding_type != vgmstream->coding_type ||
+            copy->layout_type != vgmstream->layout_type ||
+            copy->num_samples != vgmstream->num_samples) {
+        close_vgmstream(copy);
+        return NULL;
+    }
+
+    vgmstream_force_loop(copy, vgmstream->loop_flag, vgmstream->loop_start_sample, vgmstream->loop_end_sample);
+    vgmstream_set_loop_target(copy, vgmstream->loop_target);
+    copy->channel_mask = vgmstream->channel_mask;
+    copy->channel_mappings_on = vgmstream->channel_mappings_on;
+    memcpy(copy->channel_mappings, vgmstream->channel_mappings, sizeof(copy->channel_mappings));
+    return copy;
+}
+
+/* finds slice bounds, moving nominal starts to the next frame start */
+static int find_bounds(VGMSTREAM_PARALLEL * parallel, VGMSTREAM * probe, sample * scratch, int32_t play_samples) {
+    int32_t position = 0;
+    int slice_max = play_samples / PARALLEL_SLICE_SAMPLES + 1;
+
+    parallel->bounds = calloc(slice_max + 1, sizeof(int32_t));
+    if (!parallel->bounds) return 0;
+
+    parallel->slice_count = 0;
+    while (1) {
+        int32_t start = (parallel->slice_count + 1) * PARALLEL_SLICE_SAMPLES;
+        int32_t samples_to_frame;
+
+        if (start < position) /* last slice was extended past this start */
+            start = position;
+        if (start >= play_samples)
+            break;
+
+        skip_samples(probe, scratch, start - position);
+        position = start;
+
+        while ((samples_to_frame = get_samples_to_frame(probe)) > 0) {
+            if (position - start > PARALLEL_ALIGN_MAX) {
+                VGM_LOG("PARALLEL: no frame start found near %i\n", start);
+                return 0;
+            }
+            skip_samples(probe, scratch, samples_to_frame);
+            position += samples_to_frame;
+        }
+
+        /* a partial frame after loop start is decoded with the state saved when first reaching it, but skipping doesn't have it */
+        if (probe->loop_flag && probe->hit_loop) {
+            int samples_per_frame = get_vgmstream_samples_per_frame(probe);
+            if (samples_per_frame > 1 && probe->loop_samples_into_block % samples_per_frame != 0) {
+                VGM_LOG("PARALLEL: loop start not on a frame start\n");
+                return 0;
+            }
+        }
+
+        if (position >= play_samples)
+            break;
+        parallel->slice_count++;
+        parallel->bounds[parallel->slice_count] = position;
+    }
+
+    parallel->slice_count++;
+    parallel->bounds[parallel->slice_count] = play_samples;
+    return 1;
+}
+
+
+static void worker_work(parallel_worker * worker) {
+    VGMSTREAM_PARALLEL * parallel = worker->parallel;
+
+    vgm_mutex_lock(&parallel->mutex);
+    while (1) {
+        int slice;
+        parallel_slot * slot;
+        int32_t start, end;
+
+        while (!parallel->exit && parallel->next_slice < parallel->slice_count &&
+                parallel->next_slice >= parallel->done_slices + parallel->slot_count)
+            vgm_cond_wait(&parallel->cond, &parallel->mutex);
+        if (parallel->exit || parallel->next_slice >= parallel->slice_count)
+            break;
+
+        slice = parallel->next_slice++;
+        slot = &parallel->slots[slice % parallel->slot_count];
+        vgm_mutex_unlock(&parallel->mutex);
+
+        start = parallel->bounds[slice];
+        end = parallel->bounds[slice + 1];
+        skip_samples(worker->vgmstream, worker->scratch, start - worker->position);
+        render_vgmstream(slot->buffer, end - start, worker->vgmstream);
+        worker->position = end;
+
+        vgm_mutex_lock(&parallel->mutex);
+        slot->slice = slice;
+        vgm_cond_broadcast(&parallel->cond);
+    }
+    vgm_mutex_unlock(&parallel->mutex);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker_thread(LPVOID arg) {
+    worker_work(arg);
+    return 0;
+}
+#else
+static void *worker_thread(void *arg) {
+    worker_work(arg);
+    return NULL;
+}
+#endif
+
+
+VGMSTREAM_PARALLEL * vgmstream_parallel_open(VGMSTREAM * vgmstream, STREAMFILE * streamFile, int threads, int32_t play_samples) {
+    VGMSTREAM_PARALLEL * parallel = NULL;
+    VGMSTREAM * probe = NULL;
+    sample * scratch = NULL;
+    int32_t slice_max_samples = 0;
+    size_t thread_count, slot_count;
+    int i;
+
+    if (!vgmstream || !streamFile || threads <= 0 || play_samples <= 0)
+        return NULL;
+    thread_count = threads > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : (size_t)threads;
+
+    if (!is_parallel_codec(vgmstream->coding_type) ||
+            vgmstream->layout_type == layout_aix ||
+            vgmstream->layout_type == layout_segmented ||
+            vgmstream->layout_type == layout_layered ||
+            vgmstream->codec_data)
+        return NULL;
+
+    parallel = calloc(1, sizeof(VGMSTREAM_PARALLEL));
+    if (!parallel) goto fail;
+    parallel->vgmstream = vgmstream;
+    parallel->channels = vgmstream->channels;
+
+    scratch = malloc(PARALLEL_SKIP_SAMPLES * parallel->channels * sizeof(sample));
+    if (!scratch) goto fail;
+    probe = open_copy(vgmstream, streamFile);
+    if (!probe) goto fail;
+    if (!find_bounds(parallel, probe, scratch, play_samples))
+        goto fail;
+    close_vgmstream(probe);
+    probe = NULL;
+    free(scratch);
+    scratch = NULL;
+
+    for (i = 0; i < parallel->slice_count; i++) {
+        int32_t slice_samples = parallel->bounds[i + 1] - parallel->bounds[i];
+        if (slice_max_samples < slice_samples)
+            slice_max_samples = slice_samples;
+    }
+    if (parallel->slice_count <= 0)
+        goto fail;
+    if (thread_count > (size_t)parallel->slice_count)
+        thread_count = (size_t)parallel->slice_count;
+
+    /* a few slices ahead, so workers don't wait for slow output */
+    slot_count = thread_count * 2;
+    parallel->slot_count = (int)slot_count;
+    parallel->slots = calloc(slot_count, sizeof(parallel_slot));
+    if (!parallel->slots) goto fail;
+    for (i = 0; i < parallel->slot_count; i++) {
+        parallel->slots[i].slice = -1;
+        parallel->slots[i].buffer = malloc(slice_max_samples * parallel->channels * sizeof(sample));
+        if (!parallel->slots[i].buffer) goto fail;
+    }
+
+    parallel->workers = calloc(thread_count, sizeof(parallel_worker));
+    if (!parallel->workers) goto fail;
+    for (i = 0; i < (int)thread_count; i++) {
+        parallel_worker * worker = &parallel->workers[i];
+        worker->parallel = parallel;
+        worker->vgmstream = open_copy(vgmstream, streamFile);
+        worker->scratch = malloc(PARALLEL_SKIP_SAMPLES * parallel->channels * sizeof(sample));
+        parallel->worker_count++;
+        if (!worker->vgmstream || !worker->scratch) goto fail;
+    }
+
+    vgm_mutex_init(&parallel->mutex);
+    vgm_cond_init(&parallel->cond);
+    for (i = 0; i < parallel->worker_count; i++) {
+        parallel_worker * worker = &parallel->workers[i];
+#ifdef _WIN32
+        worker->thread = CreateThread(NULL, 0, worker_thread, worker, 0, NULL);
+        worker->thread_started = (worker->thread != NULL);
+#else
+        worker->thread_started = (pthread_create(&worker->thread, NULL, worker_thread, worker) == 0);
+#endif
+    }
+    if (!parallel->workers[0].thread_started) {
+        VGM_LOG("PARALLEL: can't start threads\n");
+        vgmstream_parallel_close(parallel);
+        return NULL;
+    }
+
+    return parallel;
+
+fail:
+    close_vgmstream(probe);
+    free(scratch);
+    if (parallel) {
+        for (i = 0; i < parallel->worker_count; i++) {
+            close_vgmstream(parallel->workers[i].vgmstream);
+            free(parallel->workers[i].scratch);
+        }
+        for (i = 0; parallel->slots && i < parallel->slot_count; i++) {
+            free(parallel->slots[i].buffer);
+        }
+        free(parallel->workers);
+        free(parallel->slots);
+        free(parallel->bounds);
+        free(parallel);
+    }
+    return NULL;
+}
+
+/* copies decoded samples to the output, mixing them if needed */
+static void output_samples(VGMSTREAM_PARALLEL * parallel, sample * outbuf, const sample * inbuf, int32_t sample_count) {
+    VGMSTREAM * vgmstream = parallel->vgmstream;
+    sample * mix_buffer = mixing_get_buffer(vgmstream);
+    int output_channels;
+
+    if (!mix_buffer) {
+        memcpy(outbuf, inbuf, sample_count * parallel->channels * sizeof(sample));
+        return;
+    }
+
+    output_channels = get_vgmstream_output_channels(vgmstream);
+    while (sample_count > 0) {
+        int32_t samples_to_do = sample_count;
+        if (samples_to_do > MIXING_BUFFER_SAMPLES)
+            samples_to_do = MIXING_BUFFER_SAMPLES;
+
+        memcpy(mix_buffer, inbuf, samples_to_do * parallel->channels * sizeof(sample));
+        mixing_apply(vgmstream, outbuf, samples_to_do);
+
+        inbuf += samples_to_do * parallel->channels;
+        outbuf += samples_to_do * output_channels;
+        sample_count -= samples_to_do;
+    }
+}
+
+void vgmstream_parallel_render(VGMSTREAM_PARALLEL * parallel, sample * buffer, int32_t sample_count) {
+    int output_channels = get_vgmstream_output_channels(parallel->vgmstream);
+
+    while (sample_count > 0) {
+        parallel_slot * slot;
+        int32_t start, end, samples_to_do;
+
+        if (parallel->current >= parallel->slice_count) {
+            /* past play_samples */
+            memset(buffer, 0, sample_count * output_channels * sizeof(sample));
+            return;
+        }
+
+        slot = &parallel->slots[parallel->current % parallel->slot_count];
+        vgm_mutex_lock(&parallel->mutex);
+        while (slot->slice != parallel->current)
+            vgm_cond_wait(&parallel->cond, &parallel->mutex);
+        vgm_mutex_unlock(&parallel->mutex);
+
+        start = parallel->bounds[parallel->current];
+        end = parallel->bounds[parallel->current + 1];
+        samples_to_do = end - parallel->position;
+        if (samples_to_do > sample_count)
+            samples_to_do = sample_count;
+
+        output_samples(parallel, buffer, slot->buffer + (parallel->position - start) * parallel->channels, samples_to_do);
+        buffer += samples_to_do * output_channels;
+        sample_count -= samples_to_do;
+        parallel->position += samples_to_do;
+
+        /* free the slot for later slices */
+        if (parallel->position == end) {
+            vgm_mutex_lock(&parallel->mutex);
+            slot->slice = -1;
+            parallel->current++;
+            parallel->done_slices = parallel->current;
+            vgm_cond_broadcast(&parallel->cond);
+            vgm_mutex_unlock(&parallel->mutex);
+        }
+    }
+}
+
+void vgmstream_parallel_close(VGMSTREAM_PARALLEL * parallel) {
+    int i;
+
+    if (!parallel)
+        return;
+
+    vgm_mutex_lock(&parallel->mutex);
+    parallel->exit = 1;
+    vgm_cond_broadcast(&parallel->cond);
+    vgm_mutex_unlock(&parallel->mutex);
+
+    for (i = 0; i < parallel->worker_count; i++) {
+        parallel_worker * worker = &parallel->workers[i];
+        if (worker->thread_started) {
+#ifdef _WIN32
+            WaitForSingleObject(worker->thread, INFINITE);
+            CloseHandle(worker->thread);
+#else
+            pthread_join(worker->thread, NULL);
+#endif
+        }
+        close_vgmstream(worker->vgmstream);
+        free(worker->scratch);
+    }
+    vgm_cond_destroy(&parallel->cond);
+    vgm_mutex_destroy(&parallel->mutex);
+
+    for (i = 0; i < parallel->slot_count; i++) {
+        free(parallel->slots[i].buffer);
+    }
+    free(parallel->workers);
+    free(parallel->slots);
+    free(parallel->bounds);
+    free(parallel);
+}
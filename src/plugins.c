@@ -1,7 +1,53 @@
+#include <ctype.h>
 #include "vgmstream.h"
 #include "plugins.h"
 
 
+#define VALID_EXTENSION_MAX 0x20
+
+static int compare_extension(const void* key, const void* elem) {
+    return strcmp((const char*)key, *(const char**)elem);
+}
+
+int vgmstream_ctx_is_valid(const char* filename, int flags) {
+    const char ** ext_list;
+    size_t ext_list_len;
+    const char* ext;
+    char ext_lower[VALID_EXTENSION_MAX];
+    int i;
+
+    if (flags & VGMSTREAM_VALID_IS_EXTENSION) {
+        ext = filename;
+    }
+    else {
+        const char* base = filename;
+        const char* path;
+
+        path = strrchr(base, '/');
+        if (path) base = path + 1;
+        path = strrchr(base, '\\');
+        if (path) base = path + 1;
+
+        ext = strrchr(base, '.');
+        ext = ext ? ext + 1 : "";
+    }
+
+    if (ext[0] == '\0')
+        return (flags & VGMSTREAM_VALID_ACCEPT_EXTENSIONLESS) ? 1 : 0;
+
+    /* fold case once, then binary search the (sorted) list */
+    for (i = 0; ext[i] != '\0'; i++) {
+        if (i + 1 >= VALID_EXTENSION_MAX)
+            return 0; /* longer than any extension */
+        ext_lower[i] = (ext[i] >= 'A' && ext[i] <= 'Z') ? ext[i] + ('a' - 'A') : ext[i];
+    }
+    ext_lower[i] = '\0';
+
+    ext_list = vgmstream_get_formats(&ext_list_len);
+    return bsearch(ext_lower, ext_list, ext_list_len, sizeof(const char*), compare_extension) != NULL;
+}
+
+
 static void tags_clean(VGMSTREAM_TAGS* tag) {
     int i;
     int val_len = strlen(tag->val);
@@ -149,3 +195,318 @@ void vgmstream_tags_reset(VGMSTREAM_TAGS* tag, const char* target_filename) {
         strcpy(tag->targetname, target_filename);
     }
 }
+
+
+/* ****************************************** */
+/* TAGS DB                                    */
+/* ****************************************** */
+
+/* The tagfile is parsed like vgmstream_tags_next_tag would, keeping relevant lines as entries in file
+ * order. Then tags for a filename are: global tags before its line, plus file tags in its section. */
+typedef enum { TAGS_ENTRY_GLOBAL, TAGS_ENTRY_FILE, TAGS_ENTRY_NAME } tags_entry_t;
+
+typedef struct {
+    tags_entry_t type;
+    int key;            /* offset in strings (filename for names) */
+    int val;            /* offset in strings */
+    int section_start;  /* names: first entry after the previous name */
+    int track;          /* names: filename number in the file */
+    int next;           /* names: next name with the same hash, or -1 */
+} tags_entry;
+
+struct VGMSTREAM_TAGS_DB {
+    /* loaded tagfile */
+    int loaded;
+    char* filename;
+    size_t file_size;
+    int64_t mtime;
+
+    tags_entry* entries;
+    int entries_count;
+    int entries_max;
+    int* globals;       /* global tag entries, in order */
+    int globals_count;
+    int globals_max;
+    char* strings;
+    int strings_size;
+    int strings_max;
+
+    int* buckets;       /* name entries by hash, or -1 */
+    int buckets_count;  /* power of 2 */
+    int autotrack_entry; /* entries after this get TRACK, or -1 */
+};
+
+
+static void tags_db_clear(VGMSTREAM_TAGS_DB* db) {
+    free(db->filename);
+    free(db->entries);
+    free(db->globals);
+    free(db->strings);
+    free(db->buckets);
+    memset(db, 0, sizeof(VGMSTREAM_TAGS_DB));
+    db->autotrack_entry = -1;
+}
+
+static uint32_t tags_db_hash(const char* name) {
+    uint32_t hash = 0x811C9DC5;
+    while (*name) { /* FNV-1a, case-insensitive like strcasecmp */
+        hash = (hash ^ (uint8_t)tolower((uint8_t)*name)) * 0x01000193;
+        name++;
+    }
+    return hash;
+}
+
+static int tags_db_add_string(VGMSTREAM_TAGS_DB* db, const char* str) {
+    int offset = db->strings_size;
+    int len = strlen(str) + 1;
+
+    if (db->strings_size + len > db->strings_max) {
+        int new_max = db->strings_max ? db->strings_max * 2 : 0x1000;
+        char* new_strings;
+        while (new_max < db->strings_size + len)
+            new_max *= 2;
+        new_strings = realloc(db->strings, new_max);
+        if (!new_strings) return -1;
+        db->strings = new_strings;
+        db->strings_max = new_max;
+    }
+
+    memcpy(db->strings + offset, str, len);
+    db->strings_size += len;
+    return offset;
+}
+
+static tags_entry* tags_db_add_entry(VGMSTREAM_TAGS_DB* db, tags_entry_t type, const char* key, const char* val) {
+    tags_entry* entry;
+
+    if (db->entries_count == db->entries_max) {
+        int new_max = db->entries_max ? db->entries_max * 2 : 0x100;
+        tags_entry* new_entries = realloc(db->entries, new_max * sizeof(tags_entry));
+        if (!new_entries) return NULL;
+        db->entries = new_entries;
+        db->entries_max = new_max;
+    }
+
+    if (type == TAGS_ENTRY_GLOBAL) {
+        if (db->globals_count == db->globals_max) {
+            int new_max = db->globals_max ? db->globals_max * 2 : 0x20;
+            int* new_globals = realloc(db->globals, new_max * sizeof(int));
+            if (!new_globals) return NULL;
+            db->globals = new_globals;
+            db->globals_max = new_max;
+        }
+        db->globals[db->globals_count++] = db->entries_count;
+    }
+
+    entry = &db->entries[db->entries_count++];
+    memset(entry, 0, sizeof(tags_entry));
+    entry->type = type;
+    entry->key = tags_db_add_string(db, key);
+    entry->val = val ? tags_db_add_string(db, val) : -1;
+    entry->next = -1;
+    if (entry->key < 0 || (val && entry->val < 0)) return NULL;
+    return entry;
+}
+
+static int tags_db_build_index(VGMSTREAM_TAGS_DB* db) {
+    int i, names = 0;
+
+    for (i = 0; i < db->entries_count; i++) {
+        if (db->entries[i].type == TAGS_ENTRY_NAME)
+            names++;
+    }
+
+    db->buckets_count = 0x10;
+    while (db->buckets_count < names * 2)
+        db->buckets_count *= 2;
+    db->buckets = malloc(db->buckets_count * sizeof(int));
+    if (!db->buckets) return 0;
+    memset(db->buckets, 0xFF, db->buckets_count * sizeof(int)); /* -1 */
+
+    /* added in reverse, so chains are in file order and repeated names find the first one like a scan */
+    for (i = db->entries_count - 1; i >= 0; i--) {
+        tags_entry* entry = &db->entries[i];
+        uint32_t bucket;
+        if (entry->type != TAGS_ENTRY_NAME)
+            continue;
+
+        bucket = tags_db_hash(db->strings + entry->key) & (db->buckets_count - 1);
+        entry->next = db->buckets[bucket];
+        db->buckets[bucket] = i;
+    }
+
+    return 1;
+}
+
+/* same parsing as vgmstream_tags_next_tag, see there */
+static int tags_db_parse(VGMSTREAM_TAGS_DB* db, STREAMFILE* tagfile) {
+    VGMSTREAM_TAGS* tag = NULL; /* for its buffers */
+    off_t file_size = get_streamfile_size(tagfile);
+    off_t offset = 0;
+    int section_start = 0, track_count = 0;
+    char line[TAG_LINE_MAX] = {0};
+    int ok, bytes_read, line_done;
+
+    tag = malloc(sizeof(VGMSTREAM_TAGS));
+    if (!tag) goto fail;
+
+    /* skip BOM if needed */
+    if ((uint16_t)read_16bitLE(0x00, tagfile) == 0xFFFE ||
+        (uint16_t)read_16bitLE(0x00, tagfile) == 0xFEFF) {
+        offset = 0x02;
+    }
+    else if (((uint32_t)read_32bitBE(0x00, tagfile) & 0xFFFFFF00) ==  0xEFBBBF00) {
+        offset = 0x03;
+    }
+
+    while (offset <= file_size) {
+        bytes_read = get_streamfile_text_line(TAG_LINE_MAX,line, offset,tagfile, &line_done);
+        if (!line_done || bytes_read == 0) break;
+
+        offset += bytes_read;
+
+        if (line[0] == '#') {
+            /* global command */
+            ok = sscanf(line, "# $%[^ \t] %[^\r\n]", tag->key,tag->val);
+            if (ok == 1 || ok == 2) {
+                if (strcasecmp(tag->key,"AUTOTRACK") == 0 && db->autotrack_entry < 0) {
+                    db->autotrack_entry = db->entries_count;
+                }
+                continue;
+            }
+
+            /* global tag */
+            ok = sscanf(line, "# @%[^ \t] %[^\r\n]", tag->key,tag->val);
+            if (ok == 2) {
+                tags_clean(tag);
+                if (!tags_db_add_entry(db, TAGS_ENTRY_GLOBAL, tag->key, tag->val)) goto fail;
+                continue;
+            }
+
+            /* file tag */
+            ok = sscanf(line, "# %%%[^ \t] %[^\r\n] ", tag->key,tag->val);
+            if (ok == 2) {
+                tags_clean(tag);
+                if (!tags_db_add_entry(db, TAGS_ENTRY_FILE, tag->key, tag->val)) goto fail;
+            }
+            continue;
+        }
+
+        /* filename, ends current section */
+        ok = sscanf(line, " %[^\r\n] ", tag->targetname);
+        if (ok == 1)  {
+            tags_entry* entry = tags_db_add_entry(db, TAGS_ENTRY_NAME, tag->targetname, NULL);
+            if (!entry) goto fail;
+            entry->section_start = section_start;
+            entry->track = ++track_count;
+            section_start = db->entries_count;
+        }
+    }
+
+    if (!tags_db_build_index(db)) goto fail;
+
+    free(tag);
+    return 1;
+fail:
+    free(tag);
+    return 0;
+}
+
+
+VGMSTREAM_TAGS_DB* vgmstream_tags_db_init(void) {
+    VGMSTREAM_TAGS_DB* db = calloc(1, sizeof(VGMSTREAM_TAGS_DB));
+    if (!db) return NULL;
+
+    db->autotrack_entry = -1;
+    return db;
+}
+
+int vgmstream_tags_db_load(VGMSTREAM_TAGS_DB* db, STREAMFILE* tagfile, int64_t mtime) {
+    const char* filename = get_streamfile_name_ref(tagfile);
+    size_t file_size = get_streamfile_size(tagfile);
+
+    if (db->loaded && db->file_size == file_size && db->mtime == mtime && strcmp(db->filename, filename) == 0)
+        return 1; /* not changed */
+
+    tags_db_clear(db);
+
+    db->filename = malloc(strlen(filename) + 1);
+    if (!db->filename) goto fail;
+    strcpy(db->filename, filename);
+    db->file_size = file_size;
+    db->mtime = mtime;
+
+    if (!tags_db_parse(db, tagfile)) goto fail;
+
+    db->loaded = 1;
+    return 1;
+fail:
+    tags_db_clear(db);
+    return 0;
+}
+
+int vgmstream_tags_db_next_tag(VGMSTREAM_TAGS_DB* db, VGMSTREAM_TAGS* tag) {
+    const tags_entry* entry;
+    int limit;
+
+    if (!db->loaded)
+        goto fail;
+
+    /* find target's filename entry */
+    if (!tag->db_started) {
+        uint32_t bucket = tags_db_hash(tag->targetname) & (db->buckets_count - 1);
+        int index = db->buckets[bucket];
+
+        while (index >= 0 && strcasecmp(db->strings + db->entries[index].key, tag->targetname) != 0) {
+            index = db->entries[index].next;
+        }
+
+        tag->db_target = index;
+        tag->db_global = 0;
+        tag->db_entry = index >= 0 ? db->entries[index].section_start : 0;
+        tag->db_started = 1;
+    }
+
+    /* global tags before the target (all if not found) */
+    limit = tag->db_target >= 0 ? tag->db_target : db->entries_count;
+    if (tag->db_global < db->globals_count && db->globals[tag->db_global] < limit) {
+        entry = &db->entries[db->globals[tag->db_global]];
+        tag->db_global++;
+        goto found;
+    }
+
+    if (tag->db_target < 0)
+        goto fail;
+
+    /* file tags in target's section */
+    while (tag->db_entry < tag->db_target) {
+        entry = &db->entries[tag->db_entry];
+        tag->db_entry++;
+        if (entry->type == TAGS_ENTRY_FILE)
+            goto found;
+    }
+
+    /* write extra tags after all regular tags */
+    if (db->autotrack_entry >= 0 && db->autotrack_entry < tag->db_target && !tag->autotrack_written) {
+        sprintf(tag->key, "%s", "TRACK");
+        sprintf(tag->val, "%i", db->entries[tag->db_target].track);
+        tag->autotrack_written = 1;
+        return 1;
+    }
+
+fail:
+    tag->key[0] = '\0';
+    tag->val[0] = '\0';
+    return 0;
+
+found:
+    strcpy(tag->key, db->strings + entry->key);
+    strcpy(tag->val, db->strings + entry->val);
+    return 1;
+}
+
+void vgmstream_tags_db_close(VGMSTREAM_TAGS_DB* db) {
+    if (!db) return;
+    tags_db_clear(db);
+    free(db);
+}
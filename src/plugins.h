@@ -7,6 +7,16 @@
 #include "streamfile.h"
 #define TAG_LINE_MAX 2048
 
+
+/* vgmstream_ctx_is_valid flags */
+#define VGMSTREAM_VALID_IS_EXTENSION        (1 << 0) /* filename is just the extension (no dot) */
+#define VGMSTREAM_VALID_ACCEPT_EXTENSIONLESS (1 << 1) /* some extensionless files can be played */
+
+/* Returns if vgmstream should try to open filename by its extension (see formats.c), so plugins
+ * can quickly reject unrelated files. Case insensitive, doesn't check the file itself. */
+int vgmstream_ctx_is_valid(const char* filename, int flags);
+
+
 //todo improve API and make opaque
 //typedef struct VGMSTREAM_TAGS VGMSTREAM_TAGS;
 typedef struct {
@@ -27,6 +37,12 @@ typedef struct {
     int autotrack_on;
     int autotrack_written;
     int track_count;
+
+    /* tags database position (see vgmstream_tags_db_next_tag) */
+    int db_started;
+    int db_target;      /* target's filename entry, or -1 if not found */
+    int db_global;      /* next global tag */
+    int db_entry;       /* next entry in the target's section */
 } VGMSTREAM_TAGS;
 
 
@@ -38,4 +54,20 @@ int vgmstream_tags_next_tag(VGMSTREAM_TAGS* tag, STREAMFILE* tagfile);
 /* resets tagfile to restart reading from the beginning for a new filename */
 void vgmstream_tags_reset(VGMSTREAM_TAGS* tag, const char* target_filename);
 
+
+/* Tags database, a tagfile parsed once and indexed by filename. Same results as the above, but
+ * faster when getting tags for many files (like a whole folder). Not thread-safe. */
+typedef struct VGMSTREAM_TAGS_DB VGMSTREAM_TAGS_DB;
+
+VGMSTREAM_TAGS_DB* vgmstream_tags_db_init(void);
+
+/* Parses tagfile into the db, unless it's already loaded (same name, size and mtime, which may be 0
+ * if unknown). Returns 0 on error (then no tags are found). */
+int vgmstream_tags_db_load(VGMSTREAM_TAGS_DB* db, STREAMFILE* tagfile, int64_t mtime);
+
+/* Like vgmstream_tags_next_tag, after vgmstream_tags_reset with the target filename. */
+int vgmstream_tags_db_next_tag(VGMSTREAM_TAGS_DB* db, VGMSTREAM_TAGS* tag);
+
+void vgmstream_tags_db_close(VGMSTREAM_TAGS_DB* db);
+
 #endif /* _PLUGINS_H_ */
@@ -0,0 +1,187 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "vgmstream.h"
+#include "scan_cache.h"
+
+
+/* Some formats must read the whole stream on open to find sample counts or loops (XMA, some Opus),
+ * which is slow for big files or network drives, and hosts often open the same file several times
+ * (tags, playlist, play). When enabled, results are saved as small files in a dir, named by a hash
+ * of the file identity and scan params, and reused on later opens. The file's mtime isn't available
+ * through STREAMFILEs, so data at the start and end is hashed instead to detect changed files. */
+
+#define SCAN_CACHE_ID           0x56475343 /* "VGSC" */
+#define SCAN_CACHE_VERSION      1
+#define SCAN_CACHE_HEADER_SIZE  0x10
+#define SCAN_CACHE_HASH_BYTES   0x800
+#define SCAN_CACHE_MAX_RESULT   0x100
+
+static char scan_cache_dir[PATH_LIMIT]; /* empty = disabled */
+static uint32_t scan_cache_temp_count; /* for unique temp names */
+
+/* the dir is only read through cache filenames, under a lock, as streams may be opened from other threads */
+static vgm_mutex_t scan_cache_lock = VGM_MUTEX_INIT;
+
+void vgmstream_set_scan_cache(const char * dir) {
+    vgm_mutex_lock(&scan_cache_lock);
+    if (!dir || strlen(dir) + 0x20 >= sizeof(scan_cache_dir))
+        scan_cache_dir[0] = '\0';
+    else
+        strcpy(scan_cache_dir, dir);
+    vgm_mutex_unlock(&scan_cache_lock);
+}
+
+static int is_scan_cache_enabled(void) {
+    int enabled;
+
+    vgm_mutex_lock(&scan_cache_lock);
+    enabled = scan_cache_dir[0] != '\0';
+    vgm_mutex_unlock(&scan_cache_lock);
+    return enabled;
+}
+
+
+/* FNV-1a */
+static uint32_t hash_bytes(uint32_t hash, const void * data, size_t size) {
+    const uint8_t * bytes = data;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+static void hash_key(scan_cache_key * key, const void * data, size_t size) {
+    key->hash1 = hash_bytes(key->hash1, data, size);
+    key->hash2 = hash_bytes(key->hash2, data, size);
+}
+
+/* returns 0 if the cache was disabled meanwhile (or the name doesn't fit) */
+static int get_cache_filename(const scan_cache_key * key, char * filename, size_t size) {
+    int enabled, len;
+
+    vgm_mutex_lock(&scan_cache_lock);
+    enabled = scan_cache_dir[0] != '\0';
+    len = snprintf(filename, size, "%s/%08x%08x.vgsc", scan_cache_dir, key->hash1, key->hash2);
+    vgm_mutex_unlock(&scan_cache_lock);
+    return enabled && len > 0 && (size_t)len < size;
+}
+
+/* unique per writer (process and call), so concurrent writers of the same result never share a file */
+static int get_cache_temp_filename(const char * filename, char * temp_filename, size_t size) {
+    uint32_t pid, count;
+    int len;
+
+#ifdef _WIN32
+    pid = GetCurrentProcessId();
+#else
+    pid = getpid();
+#endif
+    vgm_mutex_lock(&scan_cache_lock);
+    count = scan_cache_temp_count++;
+    vgm_mutex_unlock(&scan_cache_lock);
+
+    len = snprintf(temp_filename, size, "%s.%x.%x.tmp", filename, pid, count);
+    return len > 0 && (size_t)len < size;
+}
+
+int scan_cache_get(scan_cache_key * key, STREAMFILE * streamFile, const char * type, const void * params, size_t params_size, void * result, size_t result_size) {
+    char filename[PATH_LIMIT];
+    uint8_t buf[SCAN_CACHE_HASH_BYTES];
+    uint32_t file_size, stream_index;
+    size_t bytes;
+    FILE * file = NULL;
+
+    key->enabled = 0;
+    if (!is_scan_cache_enabled() || result_size > SCAN_CACHE_MAX_RESULT)
+        return 0;
+
+    /* file identity */
+    key->hash1 = 0x811C9DC5;
+    key->hash2 = 0x2A1F5B3D;
+    get_streamfile_name(streamFile, filename, sizeof(filename));
+    hash_key(key, filename, strlen(filename));
+
+    file_size = get_streamfile_size(streamFile);
+    stream_index = streamFile->stream_index;
+    hash_key(key, &file_size, sizeof(file_size));
+    hash_key(key, &stream_index, sizeof(stream_index));
+
+    bytes = read_streamfile(buf, 0x00, sizeof(buf), streamFile);
+    hash_key(key, buf, bytes);
+    if (file_size > sizeof(buf)) {
+        bytes = read_streamfile(buf, file_size - sizeof(buf), sizeof(buf), streamFile);
+        hash_key(key, buf, bytes);
+    }
+
+    /* scan config */
+    hash_key(key, type, strlen(type));
+    hash_key(key, params, params_size);
+    key->enabled = 1;
+
+
+    /* find result */
+    if (!get_cache_filename(key, filename, sizeof(filename)))
+        return 0;
+    file = fopen(filename, "rb");
+    if (!file)
+        return 0;
+
+    bytes = fread(buf, 1, SCAN_CACHE_HEADER_SIZE + result_size + 1, file);
+    fclose(file);
+    if (bytes != SCAN_CACHE_HEADER_SIZE + result_size)
+        return 0;
+    if (get_32bitLE(buf+0x00) != SCAN_CACHE_ID ||
+            get_32bitLE(buf+0x04) != SCAN_CACHE_VERSION ||
+            (uint32_t)get_32bitLE(buf+0x08) != key->hash1 ||
+            (uint32_t)get_32bitLE(buf+0x0c) != key->hash2)
+        return 0;
+
+    memcpy(result, buf + SCAN_CACHE_HEADER_SIZE, result_size);
+    return 1;
+}
+
+void scan_cache_put(const scan_cache_key * key, const void * result, size_t result_size) {
+    char filename[PATH_LIMIT], temp_filename[PATH_LIMIT];
+    uint8_t buf[SCAN_CACHE_HEADER_SIZE + SCAN_CACHE_MAX_RESULT];
+    FILE * file = NULL;
+
+    if (!key->enabled || result_size > SCAN_CACHE_MAX_RESULT)
+        return;
+
+    put_32bitLE(buf+0x00, SCAN_CACHE_ID);
+    put_32bitLE(buf+0x04, SCAN_CACHE_VERSION);
+    put_32bitLE(buf+0x08, key->hash1);
+    put_32bitLE(buf+0x0c, key->hash2);
+    memcpy(buf + SCAN_CACHE_HEADER_SIZE, result, result_size);
+
+    /* written to a temp file first so other processes never see partial results */
+    if (!get_cache_filename(key, filename, sizeof(filename)))
+        return;
+    if (!get_cache_temp_filename(filename, temp_filename, sizeof(temp_filename)))
+        return;
+
+    file = fopen(temp_filename, "wb");
+    if (!file) {
+        VGM_LOG("SCAN CACHE: can't write %s\n", temp_filename);
+        return;
+    }
+    if (fwrite(buf, 1, SCAN_CACHE_HEADER_SIZE + result_size, file) != SCAN_CACHE_HEADER_SIZE + result_size) {
+        fclose(file);
+        remove(temp_filename);
+        return;
+    }
+    fclose(file);
+
+    if (rename(temp_filename, filename) != 0) {
+        remove(filename); /* Windows can't rename over existing files */
+        if (rename(temp_filename, filename) != 0)
+            remove(temp_filename);
+    }
+}
@@ -0,0 +1,23 @@
+/*
+ * scan_cache.h - optional on-disk cache of open-time scans (sample counts found by reading the whole stream)
+ */
+#ifndef _SCAN_CACHE_H_
+#define _SCAN_CACHE_H_
+
+#include "streamfile.h"
+
+typedef struct {
+    int enabled;
+    uint32_t hash1;
+    uint32_t hash2;
+} scan_cache_key;
+
+/* Makes a key from the file (name, size, subsong, start/end data) plus the scan's type and params
+ * (must be fully initialized, including padding), then loads a result saved with the same key.
+ * Returns 1 if result was loaded, or 0 if the scan must be done (then saved with scan_cache_put). */
+int scan_cache_get(scan_cache_key * key, STREAMFILE * streamFile, const char * type, const void * params, size_t params_size, void * result, size_t result_size);
+
+/* Saves a result for a key from scan_cache_get (does nothing if the cache is disabled). */
+void scan_cache_put(const scan_cache_key * key, const void * result, size_t result_size);
+
+#endif /* _SCAN_CACHE_H_ */
@@ -1,11 +1,47 @@
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#include <ctype.h>
 #include "streamfile.h"
 #include "util.h"
 #include "vgmstream.h"
 
 
+/* Files opened from a root stdio STREAMFILE (companion headers, per-channel reopens, keys, .txth, etc)
+ * share a "session" so repeated opens of the same file reuse its FILE handle and cached size, default
+ * buffers are recycled, and files known to be missing aren't fopen'ed again. The session lives until
+ * the last STREAMFILE using it is closed. Reads always fseek before refilling so sharing a FILE is ok. */
+#define STDIO_SESSION_MAX_HANDLES  32
+#define STDIO_SESSION_MAX_MISSES   64
+#define STDIO_SESSION_MAX_BUFFERS  8
+
+typedef struct {
+    FILE * infile;          /* shared FILE */
+    char * name;            /* FILE filename */
+    size_t filesize;        /* cached file size */
+    int refs;               /* STREAMFILEs using this handle (kept open at 0 until evicted) */
+} STDIO_HANDLE;
+
+typedef struct {
+    int refs;               /* open STREAMFILEs in this session */
+
+    STDIO_HANDLE handles[STDIO_SESSION_MAX_HANDLES];
+    int handles_count;
+
+    char * misses[STDIO_SESSION_MAX_MISSES]; /* negative lookups (ring) */
+    int misses_count;
+    int misses_next;
+
+    uint8_t * buffers[STDIO_SESSION_MAX_BUFFERS]; /* unused default-sized buffers */
+    int buffers_count;
+} STDIO_SESSION;
+
 /* a STREAMFILE that operates via standard IO using a buffer */
 typedef struct {
     STREAMFILE sf;          /* callbacks */
@@ -18,17 +54,182 @@ typedef struct {
     size_t buffersize;      /* max buffer size */
     size_t validsize;       /* current buffer size */
     size_t filesize;        /* buffered file size */
+
+    STDIO_SESSION * session; /* shared handles/buffers */
+    int handle_index;       /* index in session handles, or -1 if this STREAMFILE owns infile */
+    VGMSTREAM_FILE_COUNTERS * file_counters; /* set on first read if sf.counters is set */
 } STDIOSTREAMFILE;
 
 static STREAMFILE * open_stdio_streamfile_buffer(const char * const filename, size_t buffersize);
 static STREAMFILE * open_stdio_streamfile_buffer_by_file(FILE *infile,const char * const filename, size_t buffersize);
+static STREAMFILE * open_stdio_session(STDIO_SESSION *session, FILE *infile, const char * const filename, size_t buffersize);
+
+/* like strncpy but without zero-filling the rest of the buffer (usually PATH_LIMIT) */
+static void copy_name(char * buffer, size_t length, const char * name) {
+    size_t name_len = strlen(name);
+
+    if (length == 0)
+        return;
+    if (name_len > length - 1)
+        name_len = length - 1;
+    memcpy(buffer, name, name_len);
+    buffer[name_len] = '\0';
+}
+
+static STDIO_SESSION * stdio_session_init(void) {
+    return calloc(1,sizeof(STDIO_SESSION));
+}
+
+static void stdio_session_close(STDIO_SESSION *session) {
+    int i;
+
+    for (i = 0; i < session->handles_count; i++) {
+        if (session->handles[i].infile)
+            fclose(session->handles[i].infile);
+        free(session->handles[i].name);
+    }
+    for (i = 0; i < session->misses_count; i++) {
+        free(session->misses[i]);
+    }
+    for (i = 0; i < session->buffers_count; i++) {
+        free(session->buffers[i]);
+    }
+    free(session);
+}
+
+static int stdio_session_find_handle(STDIO_SESSION *session, const char * filename) {
+    int i;
+    for (i = 0; i < session->handles_count; i++) {
+        if (session->handles[i].infile && strcmp(session->handles[i].name, filename) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/* registers an already opened FILE, returns its index or -1 if the session is full */
+static int stdio_session_add_handle(STDIO_SESSION *session, FILE *infile, const char * filename, size_t filesize) {
+    STDIO_HANDLE *handle = NULL;
+    char *name;
+    int i, index = -1;
+
+    if (session->handles_count < STDIO_SESSION_MAX_HANDLES) {
+        index = session->handles_count;
+    }
+    else {
+        /* evict some unused handle */
+        for (i = 0; i < session->handles_count; i++) {
+            if (session->handles[i].refs == 0) {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0) return -1;
+    }
+
+    name = malloc(strlen(filename) + 1);
+    if (!name) return -1;
+    strcpy(name, filename);
+
+    handle = &session->handles[index];
+    if (handle->infile)
+        fclose(handle->infile);
+    free(handle->name);
+
+    handle->infile = infile;
+    handle->name = name;
+    handle->filesize = filesize;
+    handle->refs = 0;
+    if (index == session->handles_count)
+        session->handles_count++;
+    return index;
+}
+
+static int stdio_session_is_missing(STDIO_SESSION *session, const char * filename) {
+    int i;
+    for (i = 0; i < session->misses_count; i++) {
+        if (strcmp(session->misses[i], filename) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+static void stdio_session_add_missing(STDIO_SESSION *session, const char * filename) {
+    char *name = malloc(strlen(filename) + 1);
+    if (!name) return;
+    strcpy(name, filename);
+
+    /* overwrite oldest entries once full */
+    if (session->misses_count < STDIO_SESSION_MAX_MISSES) {
+        session->misses[session->misses_count] = name;
+        session->misses_count++;
+    }
+    else {
+        free(session->misses[session->misses_next]);
+        session->misses[session->misses_next] = name;
+        session->misses_next = (session->misses_next + 1) % STDIO_SESSION_MAX_MISSES;
+    }
+}
+
+static uint8_t * stdio_session_get_buffer(STDIO_SESSION *session, size_t buffersize) {
+    if (buffersize == STREAMFILE_DEFAULT_BUFFER_SIZE && session->buffers_count > 0) {
+        session->buffers_count--;
+        return session->buffers[session->buffers_count]; /* contents don't matter as validsize starts at 0 */
+    }
+    return calloc(buffersize,1);
+}
+
+static void stdio_session_put_buffer(STDIO_SESSION *session, uint8_t *buffer, size_t buffersize) {
+    if (buffersize == STREAMFILE_DEFAULT_BUFFER_SIZE && session->buffers_count < STDIO_SESSION_MAX_BUFFERS) {
+        session->buffers[session->buffers_count] = buffer;
+        session->buffers_count++;
+        return;
+    }
+    free(buffer);
+}
+
+
+/* finds or adds a file's counters (files past the max are added together) */
+static VGMSTREAM_FILE_COUNTERS * get_file_counters(VGMSTREAM_COUNTERS * counters, const char * filename) {
+    VGMSTREAM_FILE_COUNTERS * file_counters;
+    size_t filename_len = strlen(filename);
+    int i;
+
+    if (filename_len >= sizeof(file_counters->name))
+        filename += filename_len - (sizeof(file_counters->name) - 1);
+
+    for (i = 0; i < counters->files_count; i++) {
+        if (strcmp(counters->files[i].name, filename) == 0)
+            return &counters->files[i];
+    }
+
+    if (counters->files_count >= VGMSTREAM_COUNTERS_MAX_FILES) {
+        strcpy(counters->other_files.name, "(other files)");
+        return &counters->other_files;
+    }
+
+    file_counters = &counters->files[counters->files_count];
+    counters->files_count++;
+    strcpy(file_counters->name, filename);
+    return file_counters;
+}
 
 static size_t read_stdio(STDIOSTREAMFILE *streamfile,uint8_t * dest, off_t offset, size_t length) {
     size_t length_read_total = 0;
+    VGMSTREAM_FILE_COUNTERS * counters = NULL;
 
     if (!streamfile || !dest || length <= 0 || offset < 0)
         return 0;
 
+    if (streamfile->sf.counters) {
+        if (!streamfile->file_counters) {
+            streamfile->file_counters = get_file_counters(streamfile->sf.counters, streamfile->name);
+            streamfile->file_counters->opens++;
+        }
+        counters = streamfile->file_counters;
+        counters->read_calls++;
+        counters->read_bytes += length;
+    }
+
     /* is the part of the requested length in the buffer? */
     if (offset >= streamfile->buffer_offset && offset < streamfile->buffer_offset + streamfile->validsize) {
         size_t length_to_read;
@@ -46,6 +247,9 @@ static size_t read_stdio(STDIOSTREAMFILE *streamfile,uint8_t * dest, off_t offse
     }
 
 
+    if (counters && length > 0)
+        counters->buffer_misses++;
+
     /* read the rest of the requested length */
     while (length > 0) {
         size_t length_to_read;
@@ -73,6 +277,10 @@ static size_t read_stdio(STDIOSTREAMFILE *streamfile,uint8_t * dest, off_t offse
         /* fill the buffer (offset now is beyond buffer_offset) */
         streamfile->buffer_offset = offset;
         streamfile->validsize = fread(streamfile->buffer,sizeof(uint8_t),streamfile->buffersize,streamfile->infile);
+        if (counters) {
+            counters->buffer_refills++;
+            counters->io_bytes += streamfile->validsize;
+        }
 
         /* decide how much must be read this time */
         if (length > streamfile->buffersize)
@@ -106,46 +314,82 @@ static off_t get_offset_stdio(STDIOSTREAMFILE *streamfile) {
     return streamfile->offset;
 }
 static void get_name_stdio(STDIOSTREAMFILE *streamfile,char *buffer,size_t length) {
-    strncpy(buffer,streamfile->name,length);
-    buffer[length-1]='\0';
+    copy_name(buffer,length,streamfile->name);
+}
+static const char * get_name_ref_stdio(STDIOSTREAMFILE *streamfile) {
+    return streamfile->name;
 }
 static void close_stdio(STDIOSTREAMFILE * streamfile) {
-    fclose(streamfile->infile);
-    free(streamfile->buffer);
+    STDIO_SESSION *session = streamfile->session;
+
+    if (streamfile->handle_index >= 0)
+        session->handles[streamfile->handle_index].refs--; /* FILE kept open for later reopens */
+    else
+        fclose(streamfile->infile);
+    stdio_session_put_buffer(session, streamfile->buffer, streamfile->buffersize);
     free(streamfile);
+
+    session->refs--;
+    if (session->refs == 0)
+        stdio_session_close(session);
 }
 
 static STREAMFILE *open_stdio(STDIOSTREAMFILE *streamFile,const char * const filename,size_t buffersize) {
-    int newfd;
-    FILE *newfile;
-    STREAMFILE *newstreamFile;
+    STREAMFILE *new_sf;
 
     if (!filename)
         return NULL;
-#if !defined (__ANDROID__)
-    // if same name, duplicate the file pointer we already have open
-    if (!strcmp(streamFile->name,filename)) {
-        if (((newfd = dup(fileno(streamFile->infile))) >= 0) &&
-            (newfile = fdopen( newfd, "rb" ))) 
-        {
-            newstreamFile = open_stdio_streamfile_buffer_by_file(newfile,filename,buffersize);
-            if (newstreamFile) { 
-                return newstreamFile;
-            }
-            // failure, close it and try the default path (which will probably fail a second time)
-            fclose(newfile);
-        }
-    }
-#endif    
-    // a normal open, open a new file
-    return open_stdio_streamfile_buffer(filename,buffersize);
+    new_sf = open_stdio_session(streamFile->session, NULL, filename, buffersize);
+    if (new_sf)
+        new_sf->counters = streamFile->sf.counters;
+    return new_sf;
 }
 
-static STREAMFILE * open_stdio_streamfile_buffer_by_file(FILE *infile,const char * const filename, size_t buffersize) {
+/* Opens a STREAMFILE in the session, using infile if passed or reusing/opening a FILE otherwise. */
+static STREAMFILE * open_stdio_session(STDIO_SESSION *session, FILE *infile, const char * const filename, size_t buffersize) {
     uint8_t * buffer = NULL;
     STDIOSTREAMFILE * streamfile = NULL;
+    int handle_index = -1;
+    int infile_opened = 0;
+    size_t filesize;
+
+    if (!infile) {
+        handle_index = stdio_session_find_handle(session, filename);
+        if (handle_index < 0) {
+            if (stdio_session_is_missing(session, filename))
+                return NULL;
 
-    buffer = calloc(buffersize,1);
+            infile = fopen(filename,"rb");
+            if (!infile) {
+                stdio_session_add_missing(session, filename);
+                return NULL;
+            }
+            infile_opened = 1;
+        }
+    }
+
+    if (handle_index >= 0) {
+        infile = session->handles[handle_index].infile;
+        filesize = session->handles[handle_index].filesize;
+    }
+    else {
+        /* cache filesize */
+        fseeko(infile,0,SEEK_END);
+        filesize = ftello(infile);
+
+        /* Typically fseek(o)/ftell(o) may only handle up to ~2.14GB, signed 32b = 0x7FFFFFFF
+         * (happens in banks like FSB, though rarely). Can be remedied with the
+         * preprocessor (-D_FILE_OFFSET_BITS=64 in GCC) but it's not well tested. */
+        if (filesize == 0xFFFFFFFF) { /* -1 on error */
+            VGM_LOG("STREAMFILE: ftell error\n");
+            goto fail; /* can be ignored but may result in strange/unexpected behaviors */
+        }
+
+        /* share it, or keep it for this STREAMFILE only if the session is full */
+        handle_index = stdio_session_add_handle(session, infile, filename, filesize);
+    }
+
+    buffer = stdio_session_get_buffer(session, buffersize);
     if (!buffer) goto fail;
 
     streamfile = calloc(1,sizeof(STDIOSTREAMFILE));
@@ -155,36 +399,52 @@ static STREAMFILE * open_stdio_streamfile_buffer_by_file(FILE *infile,const char
     streamfile->sf.get_size = (void*)get_size_stdio;
     streamfile->sf.get_offset = (void*)get_offset_stdio;
     streamfile->sf.get_name = (void*)get_name_stdio;
+    streamfile->sf.get_name_ref = (void*)get_name_ref_stdio;
     streamfile->sf.open = (void*)open_stdio;
     streamfile->sf.close = (void*)close_stdio;
 
     streamfile->infile = infile;
     streamfile->buffersize = buffersize;
     streamfile->buffer = buffer;
+    streamfile->filesize = filesize;
+    streamfile->session = session;
+    streamfile->handle_index = handle_index;
 
     strncpy(streamfile->name,filename,sizeof(streamfile->name));
     streamfile->name[sizeof(streamfile->name)-1] = '\0';
 
-    /* cache filesize */
-    fseeko(streamfile->infile,0,SEEK_END);
-    streamfile->filesize = ftello(streamfile->infile);
-
-    /* Typically fseek(o)/ftell(o) may only handle up to ~2.14GB, signed 32b = 0x7FFFFFFF
-     * (happens in banks like FSB, though rarely). Can be remedied with the
-     * preprocessor (-D_FILE_OFFSET_BITS=64 in GCC) but it's not well tested. */
-    if (streamfile->filesize == 0xFFFFFFFF) { /* -1 on error */
-        VGM_LOG("STREAMFILE: ftell error\n");
-        goto fail; /* can be ignored but may result in strange/unexpected behaviors */
-    }
+    if (handle_index >= 0)
+        session->handles[handle_index].refs++;
+    session->refs++;
 
     return &streamfile->sf;
 
 fail:
-    free(buffer);
-    free(streamfile);
+    if (buffer) stdio_session_put_buffer(session, buffer, buffersize);
+    if (handle_index < 0 && infile_opened) fclose(infile); /* shared handles are closed with the session */
     return NULL;
 }
 
+static STREAMFILE * open_stdio_streamfile_buffer_by_file(FILE *infile,const char * const filename, size_t buffersize) {
+    STDIO_SESSION *session;
+    STREAMFILE *streamFile;
+
+    session = stdio_session_init();
+    if (!session) return NULL;
+
+    streamFile = open_stdio_session(session, infile, filename, buffersize);
+    if (!streamFile) {
+        /* infile is owned by the caller on failure */
+        int handle_index = stdio_session_find_handle(session, filename);
+        if (handle_index >= 0)
+            session->handles[handle_index].infile = NULL;
+        stdio_session_close(session);
+        return NULL;
+    }
+
+    return streamFile;
+}
+
 static STREAMFILE * open_stdio_streamfile_buffer(const char * const filename, size_t buffersize) {
     FILE * infile;
     STREAMFILE *streamFile;
@@ -211,6 +471,236 @@ STREAMFILE * open_stdio_streamfile_by_file(FILE * file, const char * filename) {
 
 /* **************************************************** */
 
+/* Non-seekable input (stdin, pipes) is read forward only as needed, and all data read so far
+ * is kept so metas/decoders can still read any offset. Past some size data is moved to a temp
+ * file rather than keeping it all in memory. */
+#define PIPE_READ_SIZE      0x10000
+#define PIPE_SPILL_SIZE     0x2000000
+
+typedef struct {
+    FILE * infile;          /* non-seekable FILE (not owned) */
+    int eof;                /* infile was fully read */
+
+    uint8_t * buffer;       /* data read so far (unless spilled) */
+    size_t buffer_size;     /* max buffer size */
+    FILE * spill;           /* temp file with data read so far (once too big for the buffer) */
+    size_t data_size;       /* bytes read so far */
+
+    size_t filesize;        /* expected size, or 0 if unknown until EOF */
+    int refs;               /* STREAMFILEs using this data */
+} PIPE_DATA;
+
+typedef struct {
+    STREAMFILE sf;
+
+    PIPE_DATA * data;       /* shared between reopens */
+    char name[PATH_LIMIT];
+    off_t offset;           /* last read offset (info) */
+} PIPE_STREAMFILE;
+
+static STREAMFILE * open_pipe_data(PIPE_DATA * data, const char * filename);
+
+static int pipe_spill(PIPE_DATA * data) {
+    data->spill = tmpfile();
+    if (!data->spill) return 0;
+
+    if (fwrite(data->buffer, sizeof(uint8_t), data->data_size, data->spill) != data->data_size) {
+        fclose(data->spill);
+        data->spill = NULL;
+        return 0;
+    }
+
+    free(data->buffer);
+    data->buffer = NULL;
+    data->buffer_size = 0;
+    return 1;
+}
+
+/* reads from infile until data_size reaches max_size or EOF */
+static void pipe_fill(PIPE_DATA * data, size_t max_size) {
+    while (data->data_size < max_size && !data->eof) {
+        uint8_t chunk[PIPE_READ_SIZE];
+        size_t bytes;
+
+        bytes = fread(chunk, sizeof(uint8_t), sizeof(chunk), data->infile);
+        if (bytes < sizeof(chunk))
+            data->eof = 1; /* EOF or error, stop reading in either case */
+        if (bytes == 0)
+            break;
+
+        /* move to temp file once too big */
+        if (!data->spill && data->data_size + bytes > PIPE_SPILL_SIZE) {
+            if (!pipe_spill(data)) {
+                VGM_LOG("PIPE: can't create temp file, using memory\n");
+            }
+        }
+
+        if (data->spill) {
+            if (fseeko(data->spill, data->data_size, SEEK_SET) ||
+                fwrite(chunk, sizeof(uint8_t), bytes, data->spill) != bytes) {
+                data->eof = 1;
+                break;
+            }
+        }
+        else {
+            if (data->data_size + bytes > data->buffer_size) {
+                size_t new_size = data->buffer_size ? data->buffer_size * 2 : PIPE_READ_SIZE * 4;
+                uint8_t *new_buffer;
+
+                while (new_size < data->data_size + bytes)
+                    new_size *= 2;
+                new_buffer = realloc(data->buffer, new_size);
+                if (!new_buffer) {
+                    data->eof = 1;
+                    break;
+                }
+                data->buffer = new_buffer;
+                data->buffer_size = new_size;
+            }
+
+            memcpy(data->buffer + data->data_size, chunk, bytes);
+        }
+
+        data->data_size += bytes;
+    }
+}
+
+static size_t pipe_read(PIPE_STREAMFILE *streamfile, uint8_t * dest, off_t offset, size_t length) {
+    PIPE_DATA *data = streamfile->data;
+    size_t length_read = 0;
+
+    if (!dest || length <= 0 || offset < 0)
+        return 0;
+
+    /* data past the expected size isn't part of the file (metas rely on size and reads agreeing) */
+    if (data->filesize) {
+        if (offset >= data->filesize)
+            return 0;
+        if (offset + length > data->filesize)
+            length = data->filesize - offset;
+    }
+
+    /* read forward only as needed */
+    if (offset + length > data->data_size)
+        pipe_fill(data, offset + length);
+    VGM_ASSERT(data->filesize && offset + length > data->data_size,
+            "PIPE: data ended before expected size 0x%x at 0x%x\n", (uint32_t)data->filesize, (uint32_t)data->data_size);
+
+    if (offset < data->data_size) {
+        length_read = length;
+        if (offset + length_read > data->data_size)
+            length_read = data->data_size - offset;
+
+        if (data->spill) {
+            if (fseeko(data->spill, offset, SEEK_SET))
+                return 0;
+            length_read = fread(dest, sizeof(uint8_t), length_read, data->spill);
+        }
+        else {
+            memcpy(dest, data->buffer + offset, length_read);
+        }
+    }
+
+    streamfile->offset = offset + length_read;
+    return length_read;
+}
+static size_t pipe_get_size(PIPE_STREAMFILE * streamfile) {
+    PIPE_DATA *data = streamfile->data;
+
+    if (data->filesize)
+        return data->filesize;
+
+    /* size is only known once everything is read (no partial size is returned, as metas would use it
+     * to validate headers or calc data/samples, and fail or play cut streams) */
+    pipe_fill(data, (size_t)-1);
+    return data->data_size;
+}
+static off_t pipe_get_offset(PIPE_STREAMFILE * streamfile) {
+    return streamfile->offset;
+}
+static void pipe_get_name(PIPE_STREAMFILE *streamfile, char *buffer, size_t length) {
+    copy_name(buffer,length,streamfile->name);
+}
+static const char * pipe_get_name_ref(PIPE_STREAMFILE *streamfile) {
+    return streamfile->name;
+}
+static STREAMFILE *pipe_open(PIPE_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
+    STREAMFILE *new_sf;
+
+    if (!filename)
+        return NULL;
+
+    /* detect re-opening the file */
+    if (strcmp(filename, streamfile->name) == 0) {
+        new_sf = open_pipe_data(streamfile->data, filename);
+    }
+    else {
+        new_sf = open_stdio_streamfile_buffer(filename, buffersize); /* companion files are regular files */
+    }
+
+    if (new_sf)
+        new_sf->counters = streamfile->sf.counters;
+    return new_sf;
+}
+static void pipe_close(PIPE_STREAMFILE *streamfile) {
+    PIPE_DATA *data = streamfile->data;
+
+    data->refs--;
+    if (data->refs == 0) {
+        if (data->spill) fclose(data->spill);
+        free(data->buffer);
+        free(data);
+    }
+    free(streamfile);
+}
+
+static STREAMFILE * open_pipe_data(PIPE_DATA * data, const char * filename) {
+    PIPE_STREAMFILE *this_sf;
+
+    this_sf = calloc(1,sizeof(PIPE_STREAMFILE));
+    if (!this_sf) return NULL;
+
+    /* set callbacks and internals */
+    this_sf->sf.read = (void*)pipe_read;
+    this_sf->sf.get_size = (void*)pipe_get_size;
+    this_sf->sf.get_offset = (void*)pipe_get_offset;
+    this_sf->sf.get_name = (void*)pipe_get_name;
+    this_sf->sf.get_name_ref = (void*)pipe_get_name_ref;
+    this_sf->sf.open = (void*)pipe_open;
+    this_sf->sf.close = (void*)pipe_close;
+
+    this_sf->data = data;
+    strncpy(this_sf->name,filename,sizeof(this_sf->name));
+    this_sf->name[sizeof(this_sf->name)-1] = '\0';
+
+    data->refs++;
+
+    return &this_sf->sf;
+}
+
+STREAMFILE *open_pipe_streamfile(FILE * file, const char * filename, size_t filesize) {
+    PIPE_DATA *data;
+    STREAMFILE *this_sf;
+
+    if (!file || !filename) return NULL;
+
+    data = calloc(1,sizeof(PIPE_DATA));
+    if (!data) return NULL;
+
+    data->infile = file;
+    data->filesize = filesize;
+
+    this_sf = open_pipe_data(data, filename);
+    if (!this_sf) {
+        free(data);
+        return NULL;
+    }
+
+    return this_sf;
+}
+
+/* **************************************************** */
+
 typedef struct {
     STREAMFILE sf;
 
@@ -296,12 +786,15 @@ static size_t buffer_get_offset(BUFFER_STREAMFILE * streamfile) {
 static void buffer_get_name(BUFFER_STREAMFILE *streamfile, char *buffer, size_t length) {
     streamfile->inner_sf->get_name(streamfile->inner_sf, buffer, length); /* default */
 }
+static const char * buffer_get_name_ref(BUFFER_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->inner_sf); /* default */
+}
 static STREAMFILE *buffer_open(BUFFER_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
     STREAMFILE *new_inner_sf = streamfile->inner_sf->open(streamfile->inner_sf,filename,buffersize);
     return open_buffer_streamfile(new_inner_sf, buffersize); /* original buffer size is preferable? */
 }
 static void buffer_close(BUFFER_STREAMFILE *streamfile) {
-    streamfile->inner_sf->close(streamfile->inner_sf);
+    close_streamfile(streamfile->inner_sf);
     free(streamfile->buffer);
     free(streamfile);
 }
@@ -326,9 +819,11 @@ STREAMFILE *open_buffer_streamfile(STREAMFILE *streamfile, size_t buffer_size) {
     this_sf->sf.get_size = (void*)buffer_get_size;
     this_sf->sf.get_offset = (void*)buffer_get_offset;
     this_sf->sf.get_name = (void*)buffer_get_name;
+    this_sf->sf.get_name_ref = (void*)buffer_get_name_ref;
     this_sf->sf.open = (void*)buffer_open;
     this_sf->sf.close = (void*)buffer_close;
     this_sf->sf.stream_index = streamfile->stream_index;
+    this_sf->sf.counters = streamfile->counters;
 
     this_sf->inner_sf = streamfile;
 
@@ -344,6 +839,562 @@ fail:
 
 /* **************************************************** */
 
+/* Cursors: several STREAMFILEs reading the same file at different offsets (like one per channel)
+ * through a single inner STREAMFILE and a shared cache of pages, replacing the least recently used.
+ * Each cursor remembers its last page so most reads are a memcpy, while memory is set per file rather
+ * than a full buffer per reader, and data between readers' offsets is read from the file only once. */
+#define CURSOR_DEFAULT_PAGE_COUNT  8
+
+typedef struct {
+    uint8_t * data;
+    off_t offset;           /* file offset, or -1 if unused */
+    size_t validsize;       /* less than page size at EOF */
+    uint32_t last_use;      /* LRU */
+} CURSOR_PAGE;
+
+typedef struct {
+    STREAMFILE *inner_sf;
+    size_t filesize;        /* cached file size */
+    CURSOR_PAGE * pages;
+    int page_count;
+    size_t page_size;
+    uint32_t use_count;
+    int refs;               /* open cursors */
+} CURSOR_CACHE;
+
+typedef struct {
+    STREAMFILE sf;
+
+    CURSOR_CACHE * cache;
+    off_t offset;           /* last read offset (info) */
+    int page;               /* last page used */
+} CURSOR_STREAMFILE;
+
+
+/* returns the page with data at page_offset, loading it over the least recently used one if needed */
+static int cursor_get_page(CURSOR_CACHE * cache, off_t page_offset) {
+    CURSOR_PAGE * page;
+    int i, index = 0;
+
+    for (i = 0; i < cache->page_count; i++) {
+        if (cache->pages[i].offset == page_offset)
+            return i;
+        if (cache->pages[i].last_use < cache->pages[index].last_use)
+            index = i;
+    }
+
+    page = &cache->pages[index];
+    page->offset = page_offset;
+    page->validsize = cache->inner_sf->read(cache->inner_sf, page->data, page_offset, cache->page_size);
+    return index;
+}
+
+static size_t cursor_read(CURSOR_STREAMFILE *streamfile, uint8_t * dest, off_t offset, size_t length) {
+    CURSOR_CACHE * cache;
+    size_t length_read_total = 0;
+
+    if (!streamfile || !dest || length <= 0 || offset < 0)
+        return 0;
+    cache = streamfile->cache;
+
+    while (length > 0) {
+        CURSOR_PAGE * page = &cache->pages[streamfile->page];
+        size_t offset_into_page, length_to_read;
+
+        /* change page if not in the last one */
+        if (offset < page->offset || offset >= page->offset + (off_t)page->validsize) {
+            off_t page_offset = offset - (offset % cache->page_size);
+
+            /* ignore requests at EOF */
+            if (offset >= cache->filesize) {
+                VGM_ASSERT_ONCE(offset > cache->filesize, "CURSOR: reading over filesize 0x%x @ 0x%x + 0x%x\n", cache->filesize, (uint32_t)offset, length);
+                break;
+            }
+
+            streamfile->page = cursor_get_page(cache, page_offset);
+            page = &cache->pages[streamfile->page];
+
+            /* give up on partial reads (EOF) */
+            if (offset >= page->offset + (off_t)page->validsize)
+                break;
+        }
+        page->last_use = ++cache->use_count;
+        offset_into_page = offset - page->offset;
+
+        length_to_read = page->validsize - offset_into_page;
+        if (length_to_read > length)
+            length_to_read = length;
+
+        memcpy(dest, page->data + offset_into_page, length_to_read);
+        offset += length_to_read;
+        length_read_total += length_to_read;
+        length -= length_to_read;
+        dest += length_to_read;
+    }
+
+    streamfile->offset = offset; /* last read offset */
+    return length_read_total;
+}
+static size_t cursor_get_size(CURSOR_STREAMFILE * streamfile) {
+    return streamfile->cache->filesize; /* cache */
+}
+static off_t cursor_get_offset(CURSOR_STREAMFILE * streamfile) {
+    return streamfile->offset; /* cache */
+}
+static void cursor_get_name(CURSOR_STREAMFILE *streamfile, char *buffer, size_t length) {
+    streamfile->cache->inner_sf->get_name(streamfile->cache->inner_sf, buffer, length); /* default */
+}
+static const char * cursor_get_name_ref(CURSOR_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->cache->inner_sf); /* default */
+}
+static STREAMFILE *open_cursor(CURSOR_CACHE * cache);
+static STREAMFILE *cursor_open(CURSOR_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
+    STREAMFILE *inner_sf = streamfile->cache->inner_sf;
+    char name[PATH_LIMIT];
+
+    /* same file: another cursor, others: not shared */
+    get_streamfile_name(inner_sf, name, sizeof(name));
+    if (strcmp(name, filename) == 0)
+        return open_cursor(streamfile->cache);
+    return inner_sf->open(inner_sf, filename, buffersize);
+}
+static void cursor_close(CURSOR_STREAMFILE *streamfile) {
+    CURSOR_CACHE * cache = streamfile->cache;
+    int i;
+
+    free(streamfile);
+
+    cache->refs--;
+    if (cache->refs > 0)
+        return;
+    close_streamfile(cache->inner_sf);
+    for (i = 0; i < cache->page_count; i++) {
+        free(cache->pages[i].data);
+    }
+    free(cache->pages);
+    free(cache);
+}
+
+static STREAMFILE *open_cursor(CURSOR_CACHE * cache) {
+    CURSOR_STREAMFILE *this_sf = calloc(1,sizeof(CURSOR_STREAMFILE));
+    if (!this_sf) return NULL;
+
+    /* set callbacks and internals */
+    this_sf->sf.read = (void*)cursor_read;
+    this_sf->sf.get_size = (void*)cursor_get_size;
+    this_sf->sf.get_offset = (void*)cursor_get_offset;
+    this_sf->sf.get_name = (void*)cursor_get_name;
+    this_sf->sf.get_name_ref = (void*)cursor_get_name_ref;
+    this_sf->sf.open = (void*)cursor_open;
+    this_sf->sf.close = (void*)cursor_close;
+    this_sf->sf.stream_index = cache->inner_sf->stream_index;
+    this_sf->sf.counters = cache->inner_sf->counters;
+
+    this_sf->cache = cache;
+    cache->refs++;
+
+    return &this_sf->sf;
+}
+
+STREAMFILE *open_cursor_streamfile(STREAMFILE *streamfile, size_t page_size, int page_count) {
+    CURSOR_CACHE *cache = NULL;
+    STREAMFILE *this_sf = NULL;
+    int i;
+
+    if (!streamfile) goto fail;
+
+    cache = calloc(1,sizeof(CURSOR_CACHE));
+    if (!cache) goto fail;
+
+    cache->page_size = page_size;
+    if (cache->page_size == 0)
+        cache->page_size = STREAMFILE_CURSOR_PAGE_SIZE;
+    cache->page_count = page_count;
+    if (cache->page_count <= 0)
+        cache->page_count = CURSOR_DEFAULT_PAGE_COUNT;
+
+    cache->pages = calloc(cache->page_count, sizeof(CURSOR_PAGE));
+    if (!cache->pages) goto fail;
+    for (i = 0; i < cache->page_count; i++) {
+        cache->pages[i].offset = -1;
+        cache->pages[i].data = malloc(cache->page_size);
+        if (!cache->pages[i].data) goto fail;
+    }
+
+    cache->inner_sf = streamfile;
+    cache->filesize = streamfile->get_size(streamfile);
+
+    this_sf = open_cursor(cache);
+    if (!this_sf) goto fail;
+
+    return this_sf;
+
+fail:
+    if (cache) {
+        for (i = 0; cache->pages && i < cache->page_count; i++) {
+            free(cache->pages[i].data);
+        }
+        free(cache->pages);
+    }
+    free(cache);
+    return NULL;
+}
+
+/* **************************************************** */
+
+/* Read-ahead: once reads become sequential, the next buffer is loaded in a background thread while
+ * the current one is consumed (double buffering), so slow IO doesn't stall decoding. Random reads
+ * are done directly like a buffer STREAMFILE. STREAMFILEs opened from each other (like per-channel
+ * ones) form a group with one prefetch thread, and their inner SFs (which may share a file handle)
+ * are never read from two threads at once. The group lock is only held to change state, not while
+ * reading, so a slow prefetch doesn't block refills that find their data ready. */
+#define READAHEAD_DEFAULT_BUFFER_SIZE  0x40000
+#define READAHEAD_SEQUENTIAL_MIN       2 /* consecutive sequential refills before prefetching */
+
+#ifdef _WIN32
+typedef HANDLE ra_thread_t;
+#else
+typedef pthread_t ra_thread_t;
+#endif
+
+typedef enum { READAHEAD_IDLE, READAHEAD_PENDING, READAHEAD_READING, READAHEAD_READY } readahead_state_t;
+
+struct READAHEAD_STREAMFILE;
+
+typedef struct {
+    vgm_mutex_t mutex;      /* held to change shared state (not while reading) */
+    vgm_cond_t cond;        /* signaled on any state change */
+    int refs;
+    struct READAHEAD_STREAMFILE *members; /* open STREAMFILEs, for the thread to find pending prefetches */
+    int reading;            /* an inner SF is being read (by the thread or a reader) */
+
+    ra_thread_t thread;
+    int thread_started;
+    int thread_failed;
+    int thread_exit;
+} READAHEAD_GROUP;
+
+typedef struct READAHEAD_STREAMFILE {
+    STREAMFILE sf;
+
+    STREAMFILE *inner_sf;
+    off_t offset;           /* last read offset (info) */
+    size_t filesize;        /* cached file size */
+    size_t buffersize;      /* size of each buffer */
+
+    uint8_t * buffer;       /* current buffer (only used by the reader) */
+    off_t buffer_offset;    /* current buffer data start */
+    size_t validsize;       /* current buffer size */
+    int sequential;         /* consecutive refills right after the current buffer */
+
+    READAHEAD_GROUP *group;
+    struct READAHEAD_STREAMFILE *next; /* group members */
+    /* shared with the thread (group lock), ahead_* only used by the thread while READING */
+    readahead_state_t state;
+    uint8_t * ahead_buffer; /* next buffer */
+    off_t ahead_offset;     /* next buffer data start */
+    size_t ahead_size;      /* next buffer size */
+} READAHEAD_STREAMFILE;
+
+
+/* claims the group's inner SFs for a read (group lock must be held) */
+static void readahead_claim_io(READAHEAD_GROUP *group) {
+    while (group->reading)
+        vgm_cond_wait(&group->cond, &group->mutex);
+    group->reading = 1;
+}
+
+static void readahead_release_io(READAHEAD_GROUP *group) {
+    group->reading = 0;
+    vgm_cond_broadcast(&group->cond);
+}
+
+static void readahead_work(READAHEAD_GROUP *group) {
+    vgm_mutex_lock(&group->mutex);
+    while (1) {
+        READAHEAD_STREAMFILE *streamfile = NULL;
+
+        if (!group->reading) {
+            for (streamfile = group->members; streamfile != NULL; streamfile = streamfile->next) {
+                if (streamfile->state == READAHEAD_PENDING)
+                    break;
+            }
+        }
+        if (!streamfile) {
+            if (group->thread_exit)
+                break;
+            vgm_cond_wait(&group->cond, &group->mutex);
+            continue;
+        }
+
+        streamfile->state = READAHEAD_READING;
+        group->reading = 1;
+        vgm_mutex_unlock(&group->mutex);
+
+        streamfile->ahead_size = streamfile->inner_sf->read(streamfile->inner_sf, streamfile->ahead_buffer, streamfile->ahead_offset, streamfile->buffersize);
+
+        vgm_mutex_lock(&group->mutex);
+        streamfile->state = READAHEAD_READY;
+        readahead_release_io(group);
+    }
+    vgm_mutex_unlock(&group->mutex);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI readahead_thread(LPVOID arg) {
+    readahead_work(arg);
+    return 0;
+}
+#else
+static void *readahead_thread(void *arg) {
+    readahead_work(arg);
+    return NULL;
+}
+#endif
+
+static int readahead_start(READAHEAD_GROUP *group) {
+#ifdef _WIN32
+    group->thread = CreateThread(NULL, 0, readahead_thread, group, 0, NULL);
+    return group->thread != NULL;
+#else
+    return pthread_create(&group->thread, NULL, readahead_thread, group) == 0;
+#endif
+}
+
+static void readahead_stop(READAHEAD_GROUP *group) {
+    vgm_mutex_lock(&group->mutex);
+    group->thread_exit = 1;
+    vgm_cond_broadcast(&group->cond);
+    vgm_mutex_unlock(&group->mutex);
+
+#ifdef _WIN32
+    WaitForSingleObject(group->thread, INFINITE);
+    CloseHandle(group->thread);
+#else
+    pthread_join(group->thread, NULL);
+#endif
+}
+
+/* loads the current buffer at offset, taking the prefetched buffer if it has it */
+static void readahead_refill(READAHEAD_STREAMFILE *streamfile, off_t offset) {
+    READAHEAD_GROUP *group = streamfile->group;
+
+    if (offset == streamfile->buffer_offset + streamfile->validsize)
+        streamfile->sequential++;
+    else
+        streamfile->sequential = 0;
+
+    vgm_mutex_lock(&group->mutex);
+
+    /* a prefetch being read is probably the requested data */
+    while (streamfile->state == READAHEAD_READING)
+        vgm_cond_wait(&group->cond, &group->mutex);
+
+    if (streamfile->state == READAHEAD_READY
+            && offset >= streamfile->ahead_offset && offset < streamfile->ahead_offset + streamfile->ahead_size) {
+        uint8_t *buffer = streamfile->buffer;
+        streamfile->buffer = streamfile->ahead_buffer;
+        streamfile->ahead_buffer = buffer;
+        streamfile->buffer_offset = streamfile->ahead_offset;
+        streamfile->validsize = streamfile->ahead_size;
+        streamfile->state = READAHEAD_IDLE;
+    }
+    else {
+        /* not prefetched (or not yet started, so it's dropped): read directly */
+        streamfile->state = READAHEAD_IDLE;
+        readahead_claim_io(group);
+        vgm_mutex_unlock(&group->mutex);
+
+        streamfile->buffer_offset = offset;
+        streamfile->validsize = streamfile->inner_sf->read(streamfile->inner_sf, streamfile->buffer, streamfile->buffer_offset, streamfile->buffersize);
+
+        vgm_mutex_lock(&group->mutex);
+        readahead_release_io(group);
+    }
+
+    /* prefetch the next buffer while this one is used (not while opening and reading headers) */
+    if (streamfile->sequential >= READAHEAD_SEQUENTIAL_MIN && !group->thread_failed
+            && streamfile->validsize == streamfile->buffersize
+            && streamfile->buffer_offset + streamfile->validsize < streamfile->filesize) {
+
+        if (!group->thread_started) {
+            group->thread_started = readahead_start(group);
+            group->thread_failed = !group->thread_started;
+        }
+
+        if (group->thread_started) {
+            streamfile->ahead_offset = streamfile->buffer_offset + streamfile->validsize;
+            streamfile->state = READAHEAD_PENDING;
+            vgm_cond_broadcast(&group->cond);
+        }
+    }
+
+    vgm_mutex_unlock(&group->mutex);
+}
+
+static size_t readahead_read(READAHEAD_STREAMFILE *streamfile, uint8_t * dest, off_t offset, size_t length) {
+    size_t length_read_total = 0;
+
+    if (!streamfile || !dest || length <= 0 || offset < 0)
+        return 0;
+
+    while (length > 0) {
+        size_t length_to_read;
+        off_t offset_into_buffer;
+
+        /* refill if the offset isn't in the buffer */
+        if (offset < streamfile->buffer_offset || offset >= streamfile->buffer_offset + streamfile->validsize) {
+            /* ignore requests at EOF */
+            if (offset >= streamfile->filesize)
+                break;
+
+            readahead_refill(streamfile, offset);
+
+            /* give up on partial reads (EOF) */
+            if (offset >= streamfile->buffer_offset + streamfile->validsize)
+                break;
+        }
+
+        offset_into_buffer = offset - streamfile->buffer_offset;
+        length_to_read = streamfile->validsize - offset_into_buffer;
+        if (length_to_read > length)
+            length_to_read = length;
+
+        memcpy(dest,streamfile->buffer + offset_into_buffer,length_to_read);
+        length_read_total += length_to_read;
+        length -= length_to_read;
+        offset += length_to_read;
+        dest += length_to_read;
+    }
+
+    streamfile->offset = offset; /* last read offset */
+    return length_read_total;
+}
+static size_t readahead_get_size(READAHEAD_STREAMFILE * streamfile) {
+    return streamfile->filesize; /* cache */
+}
+static size_t readahead_get_offset(READAHEAD_STREAMFILE * streamfile) {
+    return streamfile->offset; /* cache */
+}
+static void readahead_get_name(READAHEAD_STREAMFILE *streamfile, char *buffer, size_t length) {
+    streamfile->inner_sf->get_name(streamfile->inner_sf, buffer, length); /* default */
+}
+static const char * readahead_get_name_ref(READAHEAD_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->inner_sf); /* default */
+}
+static STREAMFILE *open_readahead_group(STREAMFILE *streamfile, size_t buffer_size, READAHEAD_GROUP *group);
+static STREAMFILE *readahead_open(READAHEAD_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
+    STREAMFILE *new_inner_sf = streamfile->inner_sf->open(streamfile->inner_sf,filename,buffersize);
+    return open_readahead_group(new_inner_sf, streamfile->buffersize, streamfile->group); /* keep read-ahead size */
+}
+static void readahead_close(READAHEAD_STREAMFILE *streamfile) {
+    READAHEAD_GROUP *group = streamfile->group;
+    READAHEAD_STREAMFILE **member;
+    int refs;
+
+    /* leave the group once the thread is done with this STREAMFILE */
+    vgm_mutex_lock(&group->mutex);
+    while (streamfile->state == READAHEAD_READING)
+        vgm_cond_wait(&group->cond, &group->mutex);
+    streamfile->state = READAHEAD_IDLE;
+    for (member = &group->members; *member != NULL; member = &(*member)->next) {
+        if (*member == streamfile) {
+            *member = streamfile->next;
+            break;
+        }
+    }
+    refs = --group->refs;
+    vgm_mutex_unlock(&group->mutex);
+
+    close_streamfile(streamfile->inner_sf);
+    free(streamfile->buffer);
+    free(streamfile->ahead_buffer);
+    free(streamfile);
+
+    if (refs == 0) {
+        if (group->thread_started)
+            readahead_stop(group);
+        vgm_mutex_destroy(&group->mutex);
+        vgm_cond_destroy(&group->cond);
+        free(group);
+    }
+}
+
+static STREAMFILE *open_readahead_group(STREAMFILE *streamfile, size_t buffer_size, READAHEAD_GROUP *group) {
+    READAHEAD_STREAMFILE *this_sf = NULL;
+
+    if (!streamfile) goto fail;
+
+    this_sf = calloc(1,sizeof(READAHEAD_STREAMFILE));
+    if (!this_sf) goto fail;
+
+    this_sf->buffersize = buffer_size;
+    if (this_sf->buffersize == 0)
+        this_sf->buffersize = READAHEAD_DEFAULT_BUFFER_SIZE;
+
+    this_sf->buffer = calloc(this_sf->buffersize,1);
+    if (!this_sf->buffer) goto fail;
+    this_sf->ahead_buffer = calloc(this_sf->buffersize,1);
+    if (!this_sf->ahead_buffer) goto fail;
+
+    /* set callbacks and internals */
+    this_sf->sf.read = (void*)readahead_read;
+    this_sf->sf.get_size = (void*)readahead_get_size;
+    this_sf->sf.get_offset = (void*)readahead_get_offset;
+    this_sf->sf.get_name = (void*)readahead_get_name;
+    this_sf->sf.get_name_ref = (void*)readahead_get_name_ref;
+    this_sf->sf.open = (void*)readahead_open;
+    this_sf->sf.close = (void*)readahead_close;
+    this_sf->sf.stream_index = streamfile->stream_index;
+    this_sf->sf.counters = streamfile->counters;
+
+    this_sf->inner_sf = streamfile;
+
+    this_sf->filesize = streamfile->get_size(streamfile);
+
+    this_sf->group = group;
+    vgm_mutex_lock(&group->mutex);
+    this_sf->next = group->members;
+    group->members = this_sf;
+    group->refs++;
+    vgm_mutex_unlock(&group->mutex);
+
+    return &this_sf->sf;
+
+fail:
+    if (this_sf) {
+        free(this_sf->buffer);
+        free(this_sf->ahead_buffer);
+    }
+    free(this_sf);
+    return NULL;
+}
+
+STREAMFILE *open_readahead_streamfile(STREAMFILE *streamfile, size_t buffer_size) {
+    READAHEAD_GROUP *group = NULL;
+    STREAMFILE *this_sf;
+
+    if (!streamfile) return NULL;
+
+    group = calloc(1,sizeof(READAHEAD_GROUP));
+    if (!group) return NULL;
+
+    vgm_mutex_init(&group->mutex);
+    vgm_cond_init(&group->cond);
+
+    this_sf = open_readahead_group(streamfile, buffer_size, group);
+    if (!this_sf) {
+        vgm_mutex_destroy(&group->mutex);
+        vgm_cond_destroy(&group->cond);
+        free(group);
+        return NULL;
+    }
+
+    return this_sf;
+}
+
+/* **************************************************** */
+
 //todo stream_index: copy? pass? funtion? external?
 //todo use realnames on reopen? simplify?
 //todo use safe string ops, this ain't easy
@@ -366,6 +1417,9 @@ static size_t wrap_get_offset(WRAP_STREAMFILE * streamfile) {
 static void wrap_get_name(WRAP_STREAMFILE *streamfile, char *buffer, size_t length) {
     streamfile->inner_sf->get_name(streamfile->inner_sf, buffer, length); /* default */
 }
+static const char * wrap_get_name_ref(WRAP_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->inner_sf); /* default */
+}
 static void wrap_open(WRAP_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
     streamfile->inner_sf->open(streamfile->inner_sf, filename, buffersize); /* default (don't wrap) */
 }
@@ -387,9 +1441,11 @@ STREAMFILE *open_wrap_streamfile(STREAMFILE *streamfile) {
     this_sf->sf.get_size = (void*)wrap_get_size;
     this_sf->sf.get_offset = (void*)wrap_get_offset;
     this_sf->sf.get_name = (void*)wrap_get_name;
+    this_sf->sf.get_name_ref = (void*)wrap_get_name_ref;
     this_sf->sf.open = (void*)wrap_open;
     this_sf->sf.close = (void*)wrap_close;
     this_sf->sf.stream_index = streamfile->stream_index;
+    this_sf->sf.counters = streamfile->counters;
 
     this_sf->inner_sf = streamfile;
 
@@ -420,6 +1476,9 @@ static off_t clamp_get_offset(CLAMP_STREAMFILE *streamfile) {
 static void clamp_get_name(CLAMP_STREAMFILE *streamfile, char *buffer, size_t length) {
     streamfile->inner_sf->get_name(streamfile->inner_sf, buffer, length); /* default */
 }
+static const char * clamp_get_name_ref(CLAMP_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->inner_sf); /* default */
+}
 static STREAMFILE *clamp_open(CLAMP_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
     char original_filename[PATH_LIMIT];
     STREAMFILE *new_inner_sf;
@@ -435,7 +1494,7 @@ static STREAMFILE *clamp_open(CLAMP_STREAMFILE *streamfile, const char * const f
     }
 }
 static void clamp_close(CLAMP_STREAMFILE *streamfile) {
-    streamfile->inner_sf->close(streamfile->inner_sf);
+    close_streamfile(streamfile->inner_sf);
     free(streamfile);
 }
 
@@ -453,9 +1512,11 @@ STREAMFILE *open_clamp_streamfile(STREAMFILE *streamfile, off_t start, size_t si
     this_sf->sf.get_size = (void*)clamp_get_size;
     this_sf->sf.get_offset = (void*)clamp_get_offset;
     this_sf->sf.get_name = (void*)clamp_get_name;
+    this_sf->sf.get_name_ref = (void*)clamp_get_name_ref;
     this_sf->sf.open = (void*)clamp_open;
     this_sf->sf.close = (void*)clamp_close;
     this_sf->sf.stream_index = streamfile->stream_index;
+    this_sf->sf.counters = streamfile->counters;
 
     this_sf->inner_sf = streamfile;
     this_sf->start = start;
@@ -493,13 +1554,16 @@ static off_t io_get_offset(IO_STREAMFILE *streamfile) {
 static void io_get_name(IO_STREAMFILE *streamfile, char *buffer, size_t length) {
     streamfile->inner_sf->get_name(streamfile->inner_sf, buffer, length); /* default */
 }
+static const char * io_get_name_ref(IO_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->inner_sf); /* default */
+}
 static STREAMFILE *io_open(IO_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
     //todo should have some flag to decide if opening other files with IO
     STREAMFILE *new_inner_sf = streamfile->inner_sf->open(streamfile->inner_sf,filename,buffersize);
     return open_io_streamfile(new_inner_sf, streamfile->data, streamfile->data_size, streamfile->read_callback, streamfile->size_callback);
 }
 static void io_close(IO_STREAMFILE *streamfile) {
-    streamfile->inner_sf->close(streamfile->inner_sf);
+    close_streamfile(streamfile->inner_sf);
     free(streamfile->data);
     free(streamfile);
 }
@@ -518,9 +1582,11 @@ STREAMFILE *open_io_streamfile(STREAMFILE *streamfile, void* data, size_t data_s
     this_sf->sf.get_size = (void*)io_get_size;
     this_sf->sf.get_offset = (void*)io_get_offset;
     this_sf->sf.get_name = (void*)io_get_name;
+    this_sf->sf.get_name_ref = (void*)io_get_name_ref;
     this_sf->sf.open = (void*)io_open;
     this_sf->sf.close = (void*)io_close;
     this_sf->sf.stream_index = streamfile->stream_index;
+    this_sf->sf.counters = streamfile->counters;
 
     this_sf->inner_sf = streamfile;
     if (data) {
@@ -557,8 +1623,10 @@ static size_t fakename_get_offset(FAKENAME_STREAMFILE * streamfile) {
     return streamfile->inner_sf->get_offset(streamfile->inner_sf); /* default */
 }
 static void fakename_get_name(FAKENAME_STREAMFILE *streamfile, char *buffer, size_t length) {
-    strncpy(buffer,streamfile->fakename,length);
-    buffer[length-1]='\0';
+    copy_name(buffer,length,streamfile->fakename);
+}
+static const char * fakename_get_name_ref(FAKENAME_STREAMFILE *streamfile) {
+    return streamfile->fakename;
 }
 static STREAMFILE *fakename_open(FAKENAME_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
     /* detect re-opening the file */
@@ -575,7 +1643,7 @@ static STREAMFILE *fakename_open(FAKENAME_STREAMFILE *streamfile, const char * c
     }
 }
 static void fakename_close(FAKENAME_STREAMFILE *streamfile) {
-    streamfile->inner_sf->close(streamfile->inner_sf);
+    close_streamfile(streamfile->inner_sf);
     free(streamfile);
 }
 
@@ -592,9 +1660,11 @@ STREAMFILE *open_fakename_streamfile(STREAMFILE *streamfile, const char * fakena
     this_sf->sf.get_size = (void*)fakename_get_size;
     this_sf->sf.get_offset = (void*)fakename_get_offset;
     this_sf->sf.get_name = (void*)fakename_get_name;
+    this_sf->sf.get_name_ref = (void*)fakename_get_name_ref;
     this_sf->sf.open = (void*)fakename_open;
     this_sf->sf.close = (void*)fakename_close;
     this_sf->sf.stream_index = streamfile->stream_index;
+    this_sf->sf.counters = streamfile->counters;
 
     this_sf->inner_sf = streamfile;
 
@@ -672,6 +1742,9 @@ static size_t multifile_get_offset(MULTIFILE_STREAMFILE * streamfile) {
 static void multifile_get_name(MULTIFILE_STREAMFILE *streamfile, char *buffer, size_t length) {
     streamfile->inner_sfs[0]->get_name(streamfile->inner_sfs[0], buffer, length);
 }
+static const char * multifile_get_name_ref(MULTIFILE_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->inner_sfs[0]);
+}
 static STREAMFILE *multifile_open(MULTIFILE_STREAMFILE *streamfile, const char * const filename, size_t buffersize) {
     char original_filename[PATH_LIMIT];
     STREAMFILE *new_sf = NULL;
@@ -737,9 +1810,11 @@ STREAMFILE *open_multifile_streamfile(STREAMFILE **streamfiles, size_t streamfil
     this_sf->sf.get_size = (void*)multifile_get_size;
     this_sf->sf.get_offset = (void*)multifile_get_offset;
     this_sf->sf.get_name = (void*)multifile_get_name;
+    this_sf->sf.get_name_ref = (void*)multifile_get_name_ref;
     this_sf->sf.open = (void*)multifile_open;
     this_sf->sf.close = (void*)multifile_close;
     this_sf->sf.stream_index = streamfiles[0]->stream_index;
+    this_sf->sf.counters = streamfiles[0]->counters;
 
     this_sf->inner_sfs_size = streamfiles_size;
     this_sf->inner_sfs = calloc(streamfiles_size, sizeof(STREAMFILE*));
@@ -801,12 +1876,9 @@ STREAMFILE * open_streamfile_by_filename(STREAMFILE *streamFile, const char * na
 }
 
 STREAMFILE * reopen_streamfile(STREAMFILE *streamFile, size_t buffer_size) {
-    char pathname[PATH_LIMIT];
-
     if (buffer_size == 0)
         buffer_size = STREAMFILE_DEFAULT_BUFFER_SIZE;
-    streamFile->get_name(streamFile,pathname,sizeof(pathname));
-    return streamFile->open(streamFile,pathname,buffer_size);
+    return streamFile->open(streamFile,get_streamfile_name_ref(streamFile),buffer_size);
 }
 
 
@@ -981,31 +2053,20 @@ void fix_dir_separators(char * filename) {
  * Empty is ok to accept files without extension ("", "adx,,aix"). Returns 0 on failure
  */
 int check_extensions(STREAMFILE *streamFile, const char * cmp_exts) {
-    char filename[PATH_LIMIT];
-    const char * ext = NULL;
-    const char * cmp_ext = NULL;
-    const char * ststr_res = NULL;
-    size_t ext_len, cmp_len;
-
-    streamFile->get_name(streamFile,filename,sizeof(filename));
-    ext = filename_extension(filename);
-    ext_len = strlen(ext);
+    const char * ext = get_streamfile_ext_ref(streamFile);
+    const char * cmp_ext = cmp_exts;
+    size_t ext_len = strlen(ext);
 
-    cmp_ext = cmp_exts;
     do {
-        ststr_res = strstr(cmp_ext, ",");
-        cmp_len = ststr_res == NULL
-                  ? strlen(cmp_ext) /* total length if more not found */
-                  : (intptr_t)ststr_res - (intptr_t)cmp_ext; /* find next ext; ststr_res should always be greater than cmp_ext, resulting in a positive cmp_len */
+        const char * cmp_end = cmp_ext;
+        while (*cmp_end != ',' && *cmp_end != '\0')
+            cmp_end++;
 
-        if (ext_len == cmp_len && strncasecmp(ext,cmp_ext, ext_len) == 0)
+        if (ext_len == (size_t)(cmp_end - cmp_ext) && strncasecmp(ext, cmp_ext, ext_len) == 0)
             return 1;
 
-        cmp_ext = ststr_res;
-        if (cmp_ext != NULL)
-            cmp_ext = cmp_ext + 1; /* skip comma */
-
-    } while (cmp_ext != NULL);
+        cmp_ext = cmp_end + 1; /* skip comma */
+    } while (cmp_ext[-1] != '\0');
 
     return 0;
 }
@@ -1053,31 +2114,74 @@ int find_chunk(STREAMFILE *streamFile, uint32_t chunk_id, off_t start_offset, in
     return 0;
 }
 
-/* copies name as-is (may include full path included) */
-void get_streamfile_name(STREAMFILE *streamFile, char * buffer, size_t size) {
-    streamFile->get_name(streamFile,buffer,size);
-}
-/* copies the filename without path */
-void get_streamfile_filename(STREAMFILE *streamFile, char * buffer, size_t size) {
-    char foldername[PATH_LIMIT];
-    const char *path;
+/* sets the name parts once, as metas check them often */
+static void init_streamfile_name_ref(STREAMFILE *streamFile) {
+    const char * name = NULL;
+    const char * filename;
+    const char * ext;
+    size_t ext_len;
+    int i;
 
+    if (streamFile->get_name_ref) {
+        name = streamFile->get_name_ref(streamFile);
+    }
+    else {
+        char buffer[PATH_LIMIT];
 
-    streamFile->get_name(streamFile,foldername,sizeof(foldername));
+        streamFile->get_name(streamFile,buffer,sizeof(buffer));
+        streamFile->name_alloc = malloc(strlen(buffer) + 1);
+        if (streamFile->name_alloc) {
+            strcpy(streamFile->name_alloc, buffer);
+            name = streamFile->name_alloc;
+        }
+    }
+    if (!name)
+        name = "";
 
     //todo Windows CMD accepts both \\ and /, better way to handle this?
-    path = strrchr(foldername,'\\');
-    if (!path)
-        path = strrchr(foldername,'/');
-    if (path != NULL)
-        path = path+1;
+    filename = strrchr(name,'\\');
+    if (!filename)
+        filename = strrchr(name,'/');
+    filename = filename ? filename + 1 : name;
 
-    //todo validate sizes and copy sensible max
-    if (path) {
-        strcpy(buffer, path);
-    } else {
-        strcpy(buffer, foldername);
+    ext = filename_extension(name);
+    ext_len = strlen(ext);
+    if (ext_len < sizeof(streamFile->ext_lower)) {
+        for (i = 0; i < ext_len; i++) {
+            streamFile->ext_lower[i] = tolower((unsigned char)ext[i]);
+        }
+        streamFile->ext_lower[ext_len] = '\0';
+        ext = streamFile->ext_lower;
     }
+
+    streamFile->filename_ref = filename;
+    streamFile->ext_ref = ext;
+    streamFile->name_ref = name;
+}
+
+const char * get_streamfile_name_ref(STREAMFILE *streamFile) {
+    if (!streamFile->name_ref)
+        init_streamfile_name_ref(streamFile);
+    return streamFile->name_ref;
+}
+const char * get_streamfile_filename_ref(STREAMFILE *streamFile) {
+    if (!streamFile->name_ref)
+        init_streamfile_name_ref(streamFile);
+    return streamFile->filename_ref;
+}
+const char * get_streamfile_ext_ref(STREAMFILE *streamFile) {
+    if (!streamFile->name_ref)
+        init_streamfile_name_ref(streamFile);
+    return streamFile->ext_ref;
+}
+
+/* copies name as-is (may include full path included) */
+void get_streamfile_name(STREAMFILE *streamFile, char * buffer, size_t size) {
+    copy_name(buffer, size, get_streamfile_name_ref(streamFile));
+}
+/* copies the filename without path */
+void get_streamfile_filename(STREAMFILE *streamFile, char * buffer, size_t size) {
+    copy_name(buffer, size, get_streamfile_filename_ref(streamFile));
 }
 /* copies the filename without path or extension */
 void get_streamfile_basename(STREAMFILE *streamFile, char * buffer, size_t size) {
@@ -1094,7 +2198,7 @@ void get_streamfile_basename(STREAMFILE *streamFile, char * buffer, size_t size)
 void get_streamfile_path(STREAMFILE *streamFile, char * buffer, size_t size) {
     const char *path;
 
-    streamFile->get_name(streamFile,buffer,size);
+    get_streamfile_name(streamFile,buffer,size);
 
     path = strrchr(buffer,DIR_SEPARATOR);
     if (path!=NULL) path = path+1; /* includes "/" */
@@ -1106,8 +2210,7 @@ void get_streamfile_path(STREAMFILE *streamFile, char * buffer, size_t size) {
     }
 }
 void get_streamfile_ext(STREAMFILE *streamFile, char * filename, size_t size) {
-    streamFile->get_name(streamFile,filename,size);
-    strcpy(filename, filename_extension(filename));
+    copy_name(filename, size, filename_extension(get_streamfile_name_ref(streamFile)));
 }
 
 /* debug util, mainly for custom IO testing */
@@ -46,6 +46,7 @@
 #endif
 
 #define STREAMFILE_DEFAULT_BUFFER_SIZE 0x8000
+#define STREAMFILE_CURSOR_PAGE_SIZE 0x1000
 
 #ifndef DIR_SEPARATOR
 #if defined (_WIN32) || defined (WIN32)
@@ -55,6 +56,37 @@
 #endif
 #endif
 
+/* IO counters for one file (see VGMSTREAM_COUNTERS) */
+typedef struct {
+    char name[0x100];           /* filename (end part if too long) */
+    uint64_t opens;             /* STREAMFILEs reading this file */
+    uint64_t read_calls;        /* read callbacks */
+    uint64_t read_bytes;        /* bytes requested */
+    uint64_t buffer_misses;     /* reads not fully served from the buffer */
+    uint64_t buffer_refills;    /* buffer loads from the file */
+    uint64_t io_bytes;          /* bytes loaded from the file */
+} VGMSTREAM_FILE_COUNTERS;
+
+#define VGMSTREAM_COUNTERS_MAX_FILES 16
+
+/* Optional performance counters, for debugging where time and IO go in a stream. Set in the STREAMFILE
+ * passed to init_vgmstream_from_STREAMFILE, they are shared with files reopened from it and with the
+ * VGMSTREAM. Costs a NULL check per read/decode call when not set. Not thread-safe. */
+typedef struct {
+    /* IO (stdio STREAMFILEs only ATM) */
+    VGMSTREAM_FILE_COUNTERS files[VGMSTREAM_COUNTERS_MAX_FILES];
+    int files_count;
+    VGMSTREAM_FILE_COUNTERS other_files; /* files past the max */
+
+    /* decoding */
+    uint64_t decode_calls;      /* codec calls */
+    uint64_t decode_samples;    /* samples decoded by codec calls */
+    uint64_t decode_time;       /* time spent in codec calls, in nanoseconds */
+    uint64_t samples_discarded; /* samples decoded but skipped by codecs to seek/loop */
+    uint64_t loops;             /* loop transitions */
+    uint64_t resets;            /* reset_vgmstream calls */
+} VGMSTREAM_COUNTERS;
+
 /* struct representing a file with callbacks. Code should use STREAMFILEs and not std C functions
  * to do file operations, as plugins may need to provide their own callbacks.
  * Reads from arbitrary offsets, meaning internally may need fseek equivalents during reads. */
@@ -66,26 +98,58 @@ typedef struct _STREAMFILE {
     void (*get_name)(struct _STREAMFILE *,char *name,size_t length);
     struct _STREAMFILE * (*open)(struct _STREAMFILE *,const char * const filename,size_t buffersize);
     void (*close)(struct _STREAMFILE *);
+    /* Optional: returns the name kept by the STREAMFILE, same as get_name but without copying */
+    const char * (*get_name_ref)(struct _STREAMFILE *);
 
 
     /* Substream selection for files with subsongs. Manually used in metas if supported.
      * Not ideal here, but it's the simplest way to pass to all init_vgmstream_x functions. */
     int stream_index; /* 0=default/auto (first), 1=first, N=Nth */
 
+    /* Optional performance counters (see above), passed to reopened STREAMFILEs like stream_index. */
+    VGMSTREAM_COUNTERS * counters;
+
+    /* Name parts, set on first use by the get_streamfile_*_ref functions (a STREAMFILE's name doesn't
+     * change once opened). Must start zeroed, like the rest of the struct. */
+    const char * name_ref;      /* full name (may include path) */
+    const char * filename_ref;  /* name without path, points into name_ref */
+    const char * ext_ref;       /* extension without dot, lowercase if it fits ext_lower */
+    char ext_lower[0x20];
+    char * name_alloc;          /* name copy if get_name_ref isn't implemented, freed by close_streamfile */
+
 } STREAMFILE;
 
 /* Opens a standard STREAMFILE, opening from path.
- * Uses stdio (FILE) for operations, thus plugins may not want to use it. */
+ * Uses stdio (FILE) for operations, thus plugins may not want to use it.
+ * Files reopened from it (companion files, per-channel streamfiles) share FILE handles, buffers
+ * and failed lookups with it, until all of them are closed. */
 STREAMFILE *open_stdio_streamfile(const char * filename);
 
 /* Opens a standard STREAMFILE from a pre-opened FILE. */
 STREAMFILE *open_stdio_streamfile_by_file(FILE * file, const char * filename);
 
+/* Opens a STREAMFILE from a non-seekable FILE (stdin, pipes), which isn't closed with the STREAMFILE.
+ * Data is read forward as needed and kept (in memory or a temp file) so any offset can be read back.
+ * Filesize is optional (0 if unknown), but if not set asking for the size will read the whole FILE
+ * (and most formats ask when opening, so decoding can't start until then).
+ * The filename is used for extension checks, and its path to open companion files. */
+STREAMFILE *open_pipe_streamfile(FILE * file, const char * filename, size_t filesize);
+
 /* Opens a STREAMFILE that does buffered IO.
  * Can be used when the underlying IO may be slow (like when using custom IO).
  * Buffer size is optional. */
 STREAMFILE *open_buffer_streamfile(STREAMFILE *streamfile, size_t buffer_size);
 
+/* Opens a STREAMFILE that reads through a cache of pages, shared with STREAMFILEs opened from it for the
+ * same file (each with its own offset). Can be used when many readers jump around one file (like one
+ * per channel), instead of reopening it with a full buffer each. Page size and count are optional. */
+STREAMFILE *open_cursor_streamfile(STREAMFILE *streamfile, size_t page_size, int page_count);
+
+/* Opens a STREAMFILE that does buffered IO, and once reads are sequential loads the next buffer
+ * in a background thread. Can be used when the underlying IO is slow (like network files),
+ * to avoid stalls during playback. Buffer size (of each of its two buffers) is optional. */
+STREAMFILE *open_readahead_streamfile(STREAMFILE *streamfile, size_t buffer_size);
+
 /* Opens a STREAMFILE that doesn't close the underlying streamfile.
  * Calls to open won't wrap the new SF (assumes it needs to be closed).
  * Can be used in metas to test custom IO without closing the external SF. */
@@ -130,8 +194,10 @@ STREAMFILE * reopen_streamfile(STREAMFILE *streamFile, size_t buffer_size);
 
 /* close a file, destroy the STREAMFILE object */
 static inline void close_streamfile(STREAMFILE * streamfile) {
-    if (streamfile!=NULL)
+    if (streamfile!=NULL) {
+        free(streamfile->name_alloc);
         streamfile->close(streamfile);
+    }
 }
 
 /* read from a file, returns number of bytes read */
@@ -230,5 +296,12 @@ void get_streamfile_basename(STREAMFILE *streamFile, char * buffer, size_t size)
 void get_streamfile_path(STREAMFILE *streamFile, char * buffer, size_t size);
 void get_streamfile_ext(STREAMFILE *streamFile, char * filename, size_t size);
 
+/* Same as above but return the name parts kept in the STREAMFILE (valid until it's closed), found once
+ * on first call. Preferable for frequent checks, as they avoid copying names. The extension doesn't
+ * include the dot and is lowercase (unless unusually long). */
+const char * get_streamfile_name_ref(STREAMFILE *streamFile);
+const char * get_streamfile_filename_ref(STREAMFILE *streamFile);
+const char * get_streamfile_ext_ref(STREAMFILE *streamFile);
+
 void dump_streamfile(STREAMFILE *streamFile, const char* out);
 #endif
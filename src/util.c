@@ -1,4 +1,10 @@
 #include <string.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 #include "util.h"
 #include "streamtypes.h"
 
@@ -117,3 +123,63 @@ void concatn(int length, char * dst, const char * src) {
         dst[i]=src[j];
     dst[i]='\0';
 }
+
+uint64_t get_time_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+#ifdef _WIN32
+void vgm_mutex_init(vgm_mutex_t * mutex) { InitializeSRWLock((PSRWLOCK)mutex); }
+void vgm_mutex_destroy(vgm_mutex_t * mutex) { /* nothing */ }
+void vgm_mutex_lock(vgm_mutex_t * mutex) { AcquireSRWLockExclusive((PSRWLOCK)mutex); }
+void vgm_mutex_unlock(vgm_mutex_t * mutex) { ReleaseSRWLockExclusive((PSRWLOCK)mutex); }
+
+void vgm_cond_init(vgm_cond_t * cond) { InitializeConditionVariable((PCONDITION_VARIABLE)cond); }
+void vgm_cond_destroy(vgm_cond_t * cond) { /* nothing */ }
+void vgm_cond_wait(vgm_cond_t * cond, vgm_mutex_t * mutex) { SleepConditionVariableSRW((PCONDITION_VARIABLE)cond, (PSRWLOCK)mutex, INFINITE, 0); }
+void vgm_cond_broadcast(vgm_cond_t * cond) { WakeAllConditionVariable((PCONDITION_VARIABLE)cond); }
+
+static BOOL CALLBACK vgm_once_callback(PINIT_ONCE once, PVOID param, PVOID * context) {
+    void (*init)(void) = *(void (**)(void))param;
+    init();
+    return TRUE;
+}
+void vgm_once(vgm_once_t * once, void (*init)(void)) {
+    InitOnceExecuteOnce((PINIT_ONCE)once, vgm_once_callback, &init, NULL);
+}
+#else
+void vgm_mutex_init(vgm_mutex_t * mutex) { pthread_mutex_init(mutex, NULL); }
+void vgm_mutex_destroy(vgm_mutex_t * mutex) { pthread_mutex_destroy(mutex); }
+void vgm_mutex_lock(vgm_mutex_t * mutex) { pthread_mutex_lock(mutex); }
+void vgm_mutex_unlock(vgm_mutex_t * mutex) { pthread_mutex_unlock(mutex); }
+
+void vgm_cond_init(vgm_cond_t * cond) { pthread_cond_init(cond, NULL); }
+void vgm_cond_destroy(vgm_cond_t * cond) { pthread_cond_destroy(cond); }
+void vgm_cond_wait(vgm_cond_t * cond, vgm_mutex_t * mutex) { pthread_cond_wait(cond, mutex); }
+void vgm_cond_broadcast(vgm_cond_t * cond) { pthread_cond_broadcast(cond); }
+
+void vgm_once(vgm_once_t * once, void (*init)(void)) { pthread_once(once, init); }
+#endif
+
+#ifdef VGM_DEBUG_OUTPUT
+static vgm_mutex_t log_once_lock = VGM_MUTEX_INIT;
+
+int vgm_log_once(int * written) {
+    int first;
+
+    vgm_mutex_lock(&log_once_lock);
+    first = !*written;
+    *written = 1;
+    vgm_mutex_unlock(&log_once_lock);
+    return first;
+}
+#endif
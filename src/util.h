@@ -44,7 +44,7 @@ void put_16bitBE(uint8_t * buf, int16_t i);
 void put_32bitBE(uint8_t * buf, int32_t i);
 
 /* signed nibbles come up a lot */
-static int nibble_to_int[16] = {0,1,2,3,4,5,6,7,-8,-7,-6,-5,-4,-3,-2,-1};
+static const int nibble_to_int[16] = {0,1,2,3,4,5,6,7,-8,-7,-6,-5,-4,-3,-2,-1};
 
 static inline int get_nibble_signed(uint8_t n, int upper) {
     /*return ((n&0x70)-(n&0x80))>>4;*/
@@ -83,21 +83,59 @@ void swap_samples_le(sample *buf, int count);
 
 void concatn(int length, char * dst, const char * src);
 
+/* monotonic time in nanoseconds, for performance counters */
+uint64_t get_time_ns(void);
+
+
+/* Locks for state shared between threads (pthreads or Win32). Win32 types hold the one pointer of
+ * SRWLOCK/CONDITION_VARIABLE/INIT_ONCE, so windows.h is only needed in util.c. Mutexes can be
+ * initialized statically (VGM_MUTEX_INIT) or with vgm_mutex_init, and aren't recursive. */
+#ifdef _WIN32
+typedef struct { void * ptr; } vgm_mutex_t;
+typedef struct { void * ptr; } vgm_cond_t;
+typedef struct { void * ptr; } vgm_once_t;
+#define VGM_MUTEX_INIT  {0}
+#define VGM_ONCE_INIT   {0}
+#else
+#include <pthread.h>
+typedef pthread_mutex_t vgm_mutex_t;
+typedef pthread_cond_t vgm_cond_t;
+typedef pthread_once_t vgm_once_t;
+#define VGM_MUTEX_INIT  PTHREAD_MUTEX_INITIALIZER
+#define VGM_ONCE_INIT   PTHREAD_ONCE_INIT
+#endif
+
+void vgm_mutex_init(vgm_mutex_t * mutex);
+void vgm_mutex_destroy(vgm_mutex_t * mutex);
+void vgm_mutex_lock(vgm_mutex_t * mutex);
+void vgm_mutex_unlock(vgm_mutex_t * mutex);
+
+void vgm_cond_init(vgm_cond_t * cond);
+void vgm_cond_destroy(vgm_cond_t * cond);
+void vgm_cond_wait(vgm_cond_t * cond, vgm_mutex_t * mutex);
+void vgm_cond_broadcast(vgm_cond_t * cond);
+
+/* calls init once per process, other callers wait until it's done */
+void vgm_once(vgm_once_t * once, void (*init)(void));
+
 
 /* Simple stdout logging for debugging and regression testing purposes.
  * Needs C99 variadic macros, uses do..while to force ";" as statement */
 #ifdef VGM_DEBUG_OUTPUT
 
+/* returns 1 the first time it's called with a flag (locked, as streams may log from several threads) */
+int vgm_log_once(int * written);
+
 /* equivalent to printf when condition is true */
 #define VGM_ASSERT(condition, ...) \
     do { if (condition) {printf(__VA_ARGS__);} } while (0)
 #define VGM_ASSERT_ONCE(condition, ...) \
-    do { static int written; if (!written) { if (condition) {printf(__VA_ARGS__); written = 1;} }  } while (0)
+    do { static int written; if (condition) { if (vgm_log_once(&written)) {printf(__VA_ARGS__);} }  } while (0)
 /* equivalent to printf */
 #define VGM_LOG(...) \
     do { printf(__VA_ARGS__); } while (0)
 #define VGM_LOG_ONCE(...) \
-    do { static int written; if (!written) { printf(__VA_ARGS__); written = 1; } } while (0)
+    do { static int written; if (vgm_log_once(&written)) { printf(__VA_ARGS__); } } while (0)
 /* prints file/line/func */
 #define VGM_LOGF() \
     do { printf("%s:%i '%s'\n",  __FILE__, __LINE__, __func__); } while (0)
@@ -9,6 +9,8 @@
 #include "meta/meta.h"
 #include "layout/layout.h"
 #include "coding/coding.h"
+#include "mixing.h"
+#include "loop_cache.h"
 
 static void try_dual_file_stereo(VGMSTREAM * opened_vgmstream, STREAMFILE *streamFile, VGMSTREAM* (*init_vgmstream_function)(STREAMFILE*));
 
@@ -475,6 +477,31 @@ VGMSTREAM * (*init_vgmstream_functions[])(STREAMFILE *streamFile) = {
 };
 
 
+/* sets counters in sub-VGMSTREAMs (and their reset copies), as they decode on their own */
+static void set_vgmstream_counters(VGMSTREAM * vgmstream, VGMSTREAM_COUNTERS * counters) {
+    VGMSTREAM **subs = NULL;
+    int subs_count = 0, i;
+
+    if (vgmstream->layout_type == layout_layered) {
+        layered_layout_data *data = vgmstream->layout_data;
+        subs = data->layers;
+        subs_count = data->layer_count;
+    }
+    else if (vgmstream->layout_type == layout_segmented) {
+        segmented_layout_data *data = vgmstream->layout_data;
+        subs = data->segments;
+        subs_count = data->segment_count;
+    }
+
+    for (i = 0; i < subs_count; i++) {
+        VGMSTREAM *start_vgmstream = subs[i]->start_vgmstream;
+        subs[i]->counters = counters;
+        if (start_vgmstream)
+            start_vgmstream->counters = counters;
+        set_vgmstream_counters(subs[i], counters);
+    }
+}
+
 /* internal version with all parameters */
 static VGMSTREAM * init_vgmstream_internal(STREAMFILE *streamFile) {
     int i, fcns_size;
@@ -543,6 +570,12 @@ static VGMSTREAM * init_vgmstream_internal(STREAMFILE *streamFile) {
         if (!vgmstream->stream_index)
             vgmstream->stream_index = streamFile->stream_index;
 
+        /* performance counters, also for layers/segments as they decode by themselves */
+        if (streamFile->counters) {
+            vgmstream->counters = streamFile->counters;
+            set_vgmstream_counters(vgmstream, streamFile->counters);
+        }
+
         /* save start things so we can restart for seeking */
         memcpy(vgmstream->start_ch,vgmstream->ch,sizeof(VGMSTREAMCHANNEL)*vgmstream->channels);
         memcpy(vgmstream->start_vgmstream,vgmstream,sizeof(VGMSTREAM));
@@ -576,6 +609,8 @@ void reset_vgmstream(VGMSTREAM * vgmstream) {
     /* copy the vgmstream back into itself */
     memcpy(vgmstream,vgmstream->start_vgmstream,sizeof(VGMSTREAM));
 
+    VGM_COUNT(vgmstream, resets, 1);
+
     /* copy the initial channels */
     memcpy(vgmstream->ch,vgmstream->start_ch,sizeof(VGMSTREAMCHANNEL)*vgmstream->channels);
 
@@ -685,12 +720,59 @@ void reset_vgmstream(VGMSTREAM * vgmstream) {
 }
 
 /* Allocate memory and setup a VGMSTREAM */
+/* VGMSTREAM memory pool. The VGMSTREAM, its start copy and channels are carved from a single block,
+ * with some spare room for later allocations (loop_ch, small codec buffers). Bigger allocations
+ * get their own chunk. All is released at once on close, as opening/closing is frequent when
+ * scanning files or subsongs. */
+#define ARENA_ALIGN(size)   (((size) + 0x0F) & ~(size_t)0x0F)
+#define ARENA_SPARE_SIZE    0x400
+
+typedef struct vgmstream_arena_chunk {
+    struct vgmstream_arena_chunk * next;
+} vgmstream_arena_chunk;
+
+typedef struct vgmstream_arena {
+    uint8_t * spare;                /* unused part of the main block */
+    size_t spare_size;
+    vgmstream_arena_chunk * chunks; /* extra allocations */
+} vgmstream_arena;
+
+void * vgmstream_arena_alloc(VGMSTREAM * vgmstream, size_t size) {
+    vgmstream_arena * arena = vgmstream->arena;
+    vgmstream_arena_chunk * chunk;
+
+    size = ARENA_ALIGN(size);
+    if (size <= arena->spare_size) {
+        void * buf = arena->spare; /* never handed out before, so still zeroed */
+        arena->spare += size;
+        arena->spare_size -= size;
+        return buf;
+    }
+
+    chunk = calloc(1, ARENA_ALIGN(sizeof(vgmstream_arena_chunk)) + size);
+    if (!chunk) return NULL;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    return (uint8_t*)chunk + ARENA_ALIGN(sizeof(vgmstream_arena_chunk));
+}
+
+static void free_vgmstream_arena(vgmstream_arena * arena) {
+    vgmstream_arena_chunk * chunk = arena->chunks;
+
+    while (chunk) {
+        vgmstream_arena_chunk * next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena); /* main block, includes the VGMSTREAM */
+}
+
 VGMSTREAM * allocate_vgmstream(int channel_count, int looped) {
     VGMSTREAM * vgmstream;
     VGMSTREAM * start_vgmstream;
-    VGMSTREAMCHANNEL * channels;
-    VGMSTREAMCHANNEL * start_channels;
-    VGMSTREAMCHANNEL * loop_channels;
+    vgmstream_arena * arena;
+    uint8_t * block;
+    size_t arena_size, vgmstream_size, channels_size;
 
     /* up to ~16 aren't too rare for multilayered files, more is probably a bug */
     if (channel_count <= 0 || channel_count > 64) {
@@ -698,51 +780,34 @@ VGMSTREAM * allocate_vgmstream(int channel_count, int looped) {
         return NULL;
     }
 
-    vgmstream = calloc(1,sizeof(VGMSTREAM));
-    if (!vgmstream) return NULL;
-    
-    vgmstream->ch = NULL;
-    vgmstream->start_ch = NULL;
-    vgmstream->loop_ch = NULL;
-    vgmstream->start_vgmstream = NULL;
-    vgmstream->codec_data = NULL;
-
-    start_vgmstream = calloc(1,sizeof(VGMSTREAM));
-    if (!start_vgmstream) {
-        free(vgmstream);
-        return NULL;
-    }
+    /* main block: arena + VGMSTREAM + start VGMSTREAM + ch + start_ch + spare (loop_ch too) */
+    arena_size = ARENA_ALIGN(sizeof(vgmstream_arena));
+    vgmstream_size = ARENA_ALIGN(sizeof(VGMSTREAM));
+    channels_size = ARENA_ALIGN(channel_count * sizeof(VGMSTREAMCHANNEL));
+
+    block = calloc(1, arena_size + vgmstream_size * 2 + channels_size * 3 + ARENA_SPARE_SIZE);
+    if (!block) return NULL;
+
+    arena = (vgmstream_arena*)block;
+    block += arena_size;
+    vgmstream = (VGMSTREAM*)block;
+    block += vgmstream_size;
+    start_vgmstream = (VGMSTREAM*)block;
+    block += vgmstream_size;
+    vgmstream->ch = (VGMSTREAMCHANNEL*)block;
+    block += channels_size;
+    vgmstream->start_ch = (VGMSTREAMCHANNEL*)block;
+    block += channels_size;
+    arena->spare = block;
+    arena->spare_size = channels_size + ARENA_SPARE_SIZE;
+
+    vgmstream->arena = arena;
     vgmstream->start_vgmstream = start_vgmstream;
     start_vgmstream->start_vgmstream = start_vgmstream;
-
-    channels = calloc(channel_count,sizeof(VGMSTREAMCHANNEL));
-    if (!channels) {
-        free(vgmstream);
-        free(start_vgmstream);
-        return NULL;
-    }
-    vgmstream->ch = channels;
     vgmstream->channels = channel_count;
 
-    start_channels = calloc(channel_count,sizeof(VGMSTREAMCHANNEL));
-    if (!start_channels) {
-        free(vgmstream);
-        free(start_vgmstream);
-        free(channels);
-        return NULL;
-    }
-    vgmstream->start_ch = start_channels;
-
     if (looped) {
-        loop_channels = calloc(channel_count,sizeof(VGMSTREAMCHANNEL));
-        if (!loop_channels) {
-            free(vgmstream);
-            free(start_vgmstream);
-            free(channels);
-            free(start_channels);
-            return NULL;
-        }
-        vgmstream->loop_ch = loop_channels;
+        vgmstream->loop_ch = vgmstream_arena_alloc(vgmstream, channel_count * sizeof(VGMSTREAMCHANNEL));
     }
 
     vgmstream->loop_flag = looped;
@@ -906,13 +971,10 @@ void close_vgmstream(VGMSTREAM * vgmstream) {
         }
     }
 
-    if (vgmstream->loop_ch) free(vgmstream->loop_ch);
-    if (vgmstream->start_ch) free(vgmstream->start_ch);
-    if (vgmstream->ch) free(vgmstream->ch);
-    /* the start_vgmstream is considered just data */
-    if (vgmstream->start_vgmstream) free(vgmstream->start_vgmstream);
+    loop_cache_free(vgmstream);
 
-    free(vgmstream);
+    /* channels, start_vgmstream and the VGMSTREAM itself are in the arena */
+    free_vgmstream_arena(vgmstream->arena);
 }
 
 /* calculate samples based on player's config */
@@ -943,12 +1005,11 @@ void vgmstream_force_loop(VGMSTREAM* vgmstream, int loop_flag, int loop_start_sa
 
     /* this requires a bit more messing with the VGMSTREAM than I'm comfortable with... */
     if (loop_flag && !vgmstream->loop_flag && !vgmstream->loop_ch) {
-        vgmstream->loop_ch = calloc(vgmstream->channels,sizeof(VGMSTREAMCHANNEL));
+        vgmstream->loop_ch = vgmstream_arena_alloc(vgmstream, vgmstream->channels * sizeof(VGMSTREAMCHANNEL));
         /* loop_ch will be populated when decoded samples reach loop start */
     }
     else if (!loop_flag && vgmstream->loop_flag) {
-        /* not important though */
-        free(vgmstream->loop_ch);
+        /* not important though (memory is released on close) */
         vgmstream->loop_ch = NULL;
     }
 
@@ -961,6 +1022,15 @@ void vgmstream_force_loop(VGMSTREAM* vgmstream, int loop_flag, int loop_start_sa
         vgmstream->loop_end_sample = 0;
     }
 
+    /* keep the reset copy in sync, or a reset would restore old loops (and a freed loop_ch) */
+    if (vgmstream->start_vgmstream) {
+        VGMSTREAM *start_vgmstream = vgmstream->start_vgmstream;
+        start_vgmstream->loop_ch = vgmstream->loop_ch;
+        start_vgmstream->loop_flag = vgmstream->loop_flag;
+        start_vgmstream->loop_start_sample = vgmstream->loop_start_sample;
+        start_vgmstream->loop_end_sample = vgmstream->loop_end_sample;
+    }
+
     /* propagate changes to layouts that need them */
     if (vgmstream->layout_type == layout_layered) {
         int i;
@@ -989,7 +1059,7 @@ void vgmstream_set_loop_target(VGMSTREAM* vgmstream, int loop_target) {
 
 
 /* Decode data into sample buffer */
-void render_vgmstream(sample * buffer, int32_t sample_count, VGMSTREAM * vgmstream) {
+static void render_layout(sample * buffer, int32_t sample_count, VGMSTREAM * vgmstream) {
     switch (vgmstream->layout_type) {
         case layout_interleave:
             render_vgmstream_interleave(buffer,sample_count,vgmstream);
@@ -1051,37 +1121,76 @@ void render_vgmstream(sample * buffer, int32_t sample_count, VGMSTREAM * vgmstre
     }
 
 
-    /* swap channels if set, to create custom channel mappings */
-    if (vgmstream->channel_mappings_on) {
-        int ch_from,ch_to,s;
-        sample temp;
-        for (s = 0; s < sample_count; s++) {
-            for (ch_from = 0; ch_from < vgmstream->channels; ch_from++) {
-                if (ch_from > 32)
-                    continue;
+    /* swap/silence channels if set, to create custom channel mappings */
+    if (vgmstream->channel_mappings_on || vgmstream->channel_mask) {
+        mixing_apply_channel_mappings(vgmstream, buffer, sample_count);
+    }
+}
 
-                ch_to = vgmstream->channel_mappings[ch_from];
-                if (ch_to < 1 || ch_to > 32 || ch_to > vgmstream->channels-1 || ch_from == ch_to)
-                    continue;
+/* Decode data, copying repeated loops from the loop cache when enabled */
+static void render_layout_cached(sample * buffer, int32_t sample_count, VGMSTREAM * vgmstream) {
+    int samples_done = 0;
 
-                temp = buffer[s*vgmstream->channels + ch_from];
-                buffer[s*vgmstream->channels + ch_from] = buffer[s*vgmstream->channels + ch_to];
-                buffer[s*vgmstream->channels + ch_to] = temp;
-            }
+    while (samples_done < sample_count) {
+        sample * buf = buffer + samples_done * vgmstream->channels;
+        int32_t samples_to_do = sample_count - samples_done;
+        int32_t start_sample = vgmstream->current_sample;
+
+        if (!loop_cache_is_active(vgmstream)) {
+            render_layout(buf, samples_to_do, vgmstream);
+            break;
         }
-    }
 
-    /* channel bitmask to silence non-set channels (up to 32)
-     * can be used for 'crossfading subsongs' or layered channels, where a set of channels make a song section */
-    if (vgmstream->channel_mask) {
-        int ch,s;
-        for (s = 0; s < sample_count; s++) {
-            for (ch = 0; ch < vgmstream->channels; ch++) {
-                if ((vgmstream->channel_mask >> ch) & 1)
-                    continue;
-                buffer[s*vgmstream->channels + ch] = 0;
-            }
+        /* loop here rather than in the layout, so each pass is seen from its start (counted once
+         * playback continues past loop end, like layouts do) */
+        if (start_sample == vgmstream->loop_end_sample) {
+            if (!loop_cache_do_loop(vgmstream))
+                vgmstream_do_loop(vgmstream);
+            continue;
         }
+
+        samples_to_do = loop_cache_read(vgmstream, buf, samples_to_do);
+        if (samples_to_do > 0) {
+            samples_done += samples_to_do;
+            continue;
+        }
+
+        samples_to_do = sample_count - samples_done;
+        if (start_sample < vgmstream->loop_end_sample && samples_to_do > vgmstream->loop_end_sample - start_sample)
+            samples_to_do = vgmstream->loop_end_sample - start_sample;
+
+        render_layout(buf, samples_to_do, vgmstream);
+        loop_cache_write(vgmstream, buf, start_sample, samples_to_do);
+        samples_done += samples_to_do;
+    }
+}
+
+void render_vgmstream(sample * buffer, int32_t sample_count, VGMSTREAM * vgmstream) {
+    sample * mix_buffer = mixing_get_buffer(vgmstream);
+    int output_channels, samples_done = 0;
+
+    if (!mix_buffer) {
+        if (vgmstream->loop_cache_data)
+            render_layout_cached(buffer, sample_count, vgmstream);
+        else
+            render_layout(buffer, sample_count, vgmstream);
+        return;
+    }
+
+    /* decode all channels in small chunks, and mix them into the (output channels) buffer */
+    output_channels = get_vgmstream_output_channels(vgmstream);
+    while (samples_done < sample_count) {
+        int samples_to_do = sample_count - samples_done;
+        if (samples_to_do > MIXING_BUFFER_SAMPLES)
+            samples_to_do = MIXING_BUFFER_SAMPLES;
+
+        if (vgmstream->loop_cache_data)
+            render_layout_cached(mix_buffer, samples_to_do, vgmstream);
+        else
+            render_layout(mix_buffer, samples_to_do, vgmstream);
+        mixing_apply(vgmstream, buffer + samples_done * output_channels, samples_to_do);
+
+        samples_done += samples_to_do;
     }
 }
 
@@ -1458,9 +1567,30 @@ int get_vgmstream_shortframe_size(VGMSTREAM * vgmstream) {
     }
 }
 
+static void decode_vgmstream_codec(VGMSTREAM * vgmstream, int samples_written, int samples_to_do, sample * buffer);
+
 /* Decode samples into the buffer. Assume that we have written samples_written into the
  * buffer already, and we have samples_to_do consecutive samples ahead of us. */
 void decode_vgmstream(VGMSTREAM * vgmstream, int samples_written, int samples_to_do, sample * buffer) {
+    VGMSTREAM_COUNTERS *counters = vgmstream->counters;
+    uint64_t start;
+
+    if (vgmstream->skip_decode)
+        return;
+
+    if (!counters) {
+        decode_vgmstream_codec(vgmstream, samples_written, samples_to_do, buffer);
+        return;
+    }
+
+    start = get_time_ns();
+    decode_vgmstream_codec(vgmstream, samples_written, samples_to_do, buffer);
+    counters->decode_time += get_time_ns() - start;
+    counters->decode_calls++;
+    counters->decode_samples += samples_to_do;
+}
+
+static void decode_vgmstream_codec(VGMSTREAM * vgmstream, int samples_written, int samples_to_do, sample * buffer) {
     int ch;
 
     switch (vgmstream->coding_type) {
@@ -2119,6 +2249,7 @@ int vgmstream_do_loop(VGMSTREAM * vgmstream) {
         /* disable looping if target count reached and continue normally
          * (only needed with the "play stream end after looping N times" option enabled) */
         vgmstream->loop_count++;
+        VGM_COUNT(vgmstream, loops, 1);
         if (vgmstream->loop_target && vgmstream->loop_target == vgmstream->loop_count) {
             vgmstream->loop_flag = 0; /* could be improved but works ok */
             return 0;
@@ -2529,40 +2660,20 @@ static void try_dual_file_stereo(VGMSTREAM * opened_vgmstream, STREAMFILE *strea
         VGMSTREAMCHANNEL * new_loop_chans = NULL;
         VGMSTREAMCHANNEL * new_start_chans = NULL;
 
-        /* build the channels */
-        new_chans = calloc(2,sizeof(VGMSTREAMCHANNEL));
+        /* build the channels (old ones are left in the arenas, released on close) */
+        new_chans = vgmstream_arena_alloc(opened_vgmstream, 2*sizeof(VGMSTREAMCHANNEL));
         if (!new_chans) goto fail;
 
         memcpy(&new_chans[dfs_pair],&opened_vgmstream->ch[0],sizeof(VGMSTREAMCHANNEL));
         memcpy(&new_chans[dfs_pair^1],&new_vgmstream->ch[0],sizeof(VGMSTREAMCHANNEL));
 
         /* loop and start will be initialized later, we just need to allocate them here */
-        new_start_chans = calloc(2,sizeof(VGMSTREAMCHANNEL));
-        if (!new_start_chans) {
-            free(new_chans);
-            goto fail;
-        }
+        new_start_chans = vgmstream_arena_alloc(opened_vgmstream, 2*sizeof(VGMSTREAMCHANNEL));
+        if (!new_start_chans) goto fail;
 
         if (opened_vgmstream->loop_ch) {
-            new_loop_chans = calloc(2,sizeof(VGMSTREAMCHANNEL));
-            if (!new_loop_chans) {
-                free(new_chans);
-                free(new_start_chans);
-                goto fail;
-            }
-        }
-
-        /* remove the existing structures */
-        /* not using close_vgmstream as that would close the file */
-        free(opened_vgmstream->ch);
-        free(new_vgmstream->ch);
-
-        free(opened_vgmstream->start_ch);
-        free(new_vgmstream->start_ch);
-
-        if (opened_vgmstream->loop_ch) {
-            free(opened_vgmstream->loop_ch);
-            free(new_vgmstream->loop_ch);
+            new_loop_chans = vgmstream_arena_alloc(opened_vgmstream, 2*sizeof(VGMSTREAMCHANNEL));
+            if (!new_loop_chans) goto fail;
         }
 
         /* fill in the new structures */
@@ -2574,7 +2685,8 @@ static void try_dual_file_stereo(VGMSTREAM * opened_vgmstream, STREAMFILE *strea
         opened_vgmstream->channels = 2;
 
         /* discard the second VGMSTREAM */
-        free(new_vgmstream);
+        /* not using close_vgmstream as that would close the file */
+        free_vgmstream_arena(new_vgmstream->arena);
     }
 
 fail:
@@ -2725,6 +2837,7 @@ int get_vgmstream_average_bitrate(VGMSTREAM * vgmstream) {
  */
 int vgmstream_open_stream(VGMSTREAM * vgmstream, STREAMFILE *streamFile, off_t start_offset) {
     STREAMFILE * file = NULL;
+    STREAMFILE * cursor_file = NULL;
     char filename[PATH_LIMIT];
     int ch;
     int use_streamfile_per_channel = 0;
@@ -2750,12 +2863,12 @@ int vgmstream_open_stream(VGMSTREAM * vgmstream, STREAMFILE *streamFile, off_t s
         return 1;
 #endif
 
-    /* if interleave is big enough keep a buffer per channel */
+    /* if interleave is big enough keep a position per channel */
     if (vgmstream->interleave_block_size * vgmstream->channels >= STREAMFILE_DEFAULT_BUFFER_SIZE) {
         use_streamfile_per_channel = 1;
     }
 
-    /* if blocked layout (implicit) use multiple streamfiles; using only one leads to
+    /* if blocked layout (implicit) use multiple streamfiles; using only one buffer leads to
      * lots of buffer-trashing, with all the jumping around in the block layout */
     if (vgmstream->layout_type != layout_none && vgmstream->layout_type != layout_interleave) {
         use_streamfile_per_channel = 1;
@@ -2778,6 +2891,17 @@ int vgmstream_open_stream(VGMSTREAM * vgmstream, STREAMFILE *streamFile, off_t s
             file = streamFile->open(streamFile,filename, STREAMFILE_DEFAULT_BUFFER_SIZE);
             if (!file) goto fail;
         }
+        else {
+            /* channels read apart, so each gets a cursor over one handle and a page cache for the file
+             * (a few pages per channel), rather than its own full buffer */
+            STREAMFILE * inner_file = streamFile->open(streamFile,filename, STREAMFILE_CURSOR_PAGE_SIZE);
+            if (!inner_file) goto fail;
+            cursor_file = open_cursor_streamfile(inner_file, STREAMFILE_CURSOR_PAGE_SIZE, vgmstream->channels < 4 ? 8 : vgmstream->channels * 2);
+            if (!cursor_file) {
+                close_streamfile(inner_file);
+                goto fail;
+            }
+        }
 
         for (ch = 0; ch < vgmstream->channels; ch++) {
             off_t offset;
@@ -2790,9 +2914,9 @@ int vgmstream_open_stream(VGMSTREAM * vgmstream, STREAMFILE *streamFile, off_t s
                 offset = start_offset + vgmstream->interleave_block_size*ch;
             }
 
-            /* open new one if needed */
+            /* open new cursor if needed */
             if (use_streamfile_per_channel) {
-                file = streamFile->open(streamFile,filename, STREAMFILE_DEFAULT_BUFFER_SIZE);
+                file = (ch == 0) ? cursor_file : cursor_file->open(cursor_file,filename, STREAMFILE_DEFAULT_BUFFER_SIZE);
                 if (!file) goto fail;
             }
 
@@ -837,6 +837,7 @@ typedef struct {
     int codec_config;               /* flags for codecs or layouts with minor variations; meaning is up to the codec */
 
     int32_t ws_output_size;         /* WS ADPCM: output bytes for this block */
+    int skip_decode;                /* layouts move as usual but nothing is decoded (only for codecs with self-contained frames) */
 
     void * start_vgmstream;         /* a copy of the VGMSTREAM as it was at the beginning of the stream (for custom layouts) */
 
@@ -848,8 +849,22 @@ typedef struct {
     void * codec_data;
     /* Same, for special layouts. layout_data + codec_data may exist at the same time. */
     void * layout_data;
+    /* output mixing config (see mixing.c), NULL if disabled */
+    void * mixing_data;
+    /* decoded loop body (see loop_cache.c), NULL if disabled */
+    void * loop_cache_data;
+
+    /* optional performance counters, from the STREAMFILE used to open this (not owned) */
+    VGMSTREAM_COUNTERS * counters;
+
+    /* memory pool that owns this VGMSTREAM, its channels and vgmstream_arena_alloc'd buffers */
+    struct vgmstream_arena * arena;
 } VGMSTREAM;
 
+/* adds to a performance counter, if enabled */
+#define VGM_COUNT(vgmstream, counter, value) \
+    do { if ((vgmstream)->counters) { (vgmstream)->counters->counter += (value); } } while (0)
+
 #ifdef VGM_USE_VORBIS
 /* Ogg with Vorbis */
 typedef struct {
@@ -937,6 +952,11 @@ typedef struct {
 
     int prev_block_samples;     /* count for optimization */
 
+    /* setup (codebooks) shared with other streams using the same headers */
+    uint8_t id_packet[0x40];    /* identification header copy, part of the setup key */
+    size_t id_packet_size;
+    struct vorbis_setup_entry * setup_entry;
+
 } vorbis_custom_codec_data;
 #endif
 
@@ -1124,6 +1144,11 @@ typedef struct {
 } hca_codec_data;
 
 #ifdef VGM_USE_FFMPEG
+typedef struct {
+    int64_t pos;                // packet offset FFmpeg sees
+    int64_t sample;             // decoded samples before the packet
+} ffmpeg_index_entry;
+
 typedef struct {
     /*** IO internals ***/
     STREAMFILE *streamfile;
@@ -1177,6 +1202,12 @@ typedef struct {
     // Seeking is not ideal, so rollback is necessary
     int samplesToDiscard;
 
+    // Packet index filled while decoding, to seek near the target (only for codecs that allow it)
+    int indexable;
+    ffmpeg_index_entry *index;
+    int indexCount;
+    int indexMax;
+    int64_t samplesDecoded;     // decoded samples since start, as they come from the decoder
 
 } ffmpeg_codec_data;
 #endif
@@ -1249,6 +1280,11 @@ int vgmstream_get_current_sample(VGMSTREAM* vgmstream);
 /* vgmstream "public" API                                                   */
 /* -------------------------------------------------------------------------*/
 
+/* Threads: each VGMSTREAM (and the STREAMFILEs it was opened from) must be used by one thread at a time,
+ * but different streams can be opened, decoded and closed from any number of threads at once. Shared
+ * state (codec tables and library inits, parsed setup and scan caches) is constant, once-initialized
+ * or locked. */
+
 /* do format detection, return pointer to a usable VGMSTREAM, or NULL on failure */
 VGMSTREAM * init_vgmstream(const char * const filename);
 
@@ -1285,6 +1321,43 @@ void vgmstream_force_loop(VGMSTREAM* vgmstream, int loop_flag, int loop_start_sa
 /* Set number of max loops to do, then play up to stream end (for songs with proper endings) */
 void vgmstream_set_loop_target(VGMSTREAM* vgmstream, int loop_target);
 
+/* Enables caching results of slow open-time scans (formats that must read the whole stream to find
+ * samples) as small files in dir, reused when the same file is opened again. NULL disables it (default).
+ * Global setting shared by all streams (can be changed from any thread), applies to files opened later. */
+void vgmstream_set_scan_cache(const char* dir);
+
+/* Keeps the decoded loop body in memory (if it takes up to max_bytes) after the first loop, so later
+ * loops are copied rather than decoded again, for long or endless plays. Output is unchanged.
+ * 0 disables it and releases the memory. Should be set after init and is kept on reset.
+ * Returns 0 if the stream can't use it (layouts or formats with special looping). */
+int vgmstream_set_loop_cache(VGMSTREAM* vgmstream, size_t max_bytes);
+
+/* Parallel rendering of a single stream (for faster conversions): decodes time slices with up to 'threads'
+ * copies of the stream, each reopening streamFile's file with stdio (so it must be a local file; subsong is
+ * taken from streamFile too), and outputs them in order like render_vgmstream from the start
+ * up to play_samples (silence after that). Uses vgmstream's loop and mixing config, which shouldn't change
+ * while rendering, but vgmstream itself isn't moved. Only for codecs whose frames don't depend on previous
+ * ones (PCM, MS-ADPCM, some IMA) so output is the same; returns NULL for others. */
+typedef struct VGMSTREAM_PARALLEL VGMSTREAM_PARALLEL;
+VGMSTREAM_PARALLEL * vgmstream_parallel_open(VGMSTREAM* vgmstream, STREAMFILE* streamFile, int threads, int32_t play_samples);
+void vgmstream_parallel_render(VGMSTREAM_PARALLEL* parallel, sample* buffer, int32_t sample_count);
+void vgmstream_parallel_close(VGMSTREAM_PARALLEL* parallel);
+
+/* Output mixing, applied by render_vgmstream after decoding. Once set, render_vgmstream's buffer holds
+ * get_vgmstream_output_channels channels rather than vgmstream->channels. Should be set after
+ * init and is kept on reset. Functions return 0 on bad config. */
+/* output channels as a weighted sum of input channels, with matrix[output * input_channels + input] */
+int vgmstream_mixing_matrix(VGMSTREAM* vgmstream, int output_channels, const float* matrix);
+/* output only channel_count channels, starting from start_channel */
+int vgmstream_mixing_select(VGMSTREAM* vgmstream, int start_channel, int channel_count);
+/* downmix (or upmix mono) to 1 or 2 channels */
+int vgmstream_mixing_downmix(VGMSTREAM* vgmstream, int output_channels);
+/* volume for all output channels, applied over the matrix (1.0 = unchanged) */
+int vgmstream_mixing_gain(VGMSTREAM* vgmstream, float gain);
+void vgmstream_mixing_disable(VGMSTREAM* vgmstream);
+/* channels in render_vgmstream's buffer */
+int get_vgmstream_output_channels(VGMSTREAM* vgmstream);
+
 /* -------------------------------------------------------------------------*/
 /* vgmstream "private" API                                                  */
 /* -------------------------------------------------------------------------*/
@@ -1292,6 +1365,10 @@ void vgmstream_set_loop_target(VGMSTREAM* vgmstream, int loop_target);
 /* Allocate memory and setup a VGMSTREAM */
 VGMSTREAM * allocate_vgmstream(int channel_count, int looped);
 
+/* Allocates zeroed memory owned by the VGMSTREAM, released by close_vgmstream (don't free it).
+ * Meant for buffers that live as long as the VGMSTREAM, as there is no reuse. */
+void * vgmstream_arena_alloc(VGMSTREAM * vgmstream, size_t size);
+
 /* Get the number of samples of a single frame (smallest self-contained sample group, 1/N channels) */
 int get_vgmstream_samples_per_frame(VGMSTREAM * vgmstream);
 /* Get the number of bytes of a single frame (smallest self-contained byte group, 1/N channels) */
@@ -94,6 +94,7 @@ int fade_samples = 0;
 int output_channels = 0;
 
 const char* tagfile_name = "!tags.m3u"; //todo make configurable
+static VGMSTREAM_TAGS_DB* tags_db = NULL; /* parsed tagfile, reused between files in the same folder */
 
 in_char lastfn[PATH_LIMIT] = {0}; /* name of the currently playing file */
 
@@ -115,6 +116,7 @@ in_char lastfn[PATH_LIMIT] = {0}; /* name of the currently playing file */
 #define wa_strrchr wcsrchr
 #define wa_fileinfo fileinfoW
 #define wa_IPC_PE_INSERTFILENAME IPC_PE_INSERTFILENAMEW
+#define wa_GetFileAttributesEx GetFileAttributesExW
 #define wa_L(x) L ##x
 #else
 #define wa_strcmp strcmp
@@ -128,6 +130,7 @@ in_char lastfn[PATH_LIMIT] = {0}; /* name of the currently playing file */
 #define wa_strrchr strrchr
 #define wa_fileinfo fileinfo
 #define wa_IPC_PE_INSERTFILENAME IPC_PE_INSERTFILENAME
+#define wa_GetFileAttributesEx GetFileAttributesExA
 #define wa_L(x) x
 #endif
 
@@ -218,19 +221,21 @@ static void wasf_get_name(WINAMP_STREAMFILE *streamfile, char *buffer, size_t le
     streamfile->stdiosf->get_name(streamfile->stdiosf, buffer, length);
 }
 
+static const char * wasf_get_name_ref(WINAMP_STREAMFILE *streamfile) {
+    return get_streamfile_name_ref(streamfile->stdiosf);
+}
+
 static STREAMFILE *wasf_open(WINAMP_STREAMFILE *streamFile, const char *const filename, size_t buffersize) {
     int newfd;
     FILE *newfile;
     STREAMFILE *newstreamFile;
     in_char wpath[PATH_LIMIT];
-    char name[PATH_LIMIT];
 
     if (!filename)
         return NULL;
 
     /* if same name, duplicate the file pointer we already have open */ //unsure if all this is needed
-    streamFile->stdiosf->get_name(streamFile->stdiosf, name, PATH_LIMIT);
-    if (!strcmp(name,filename)) {
+    if (!strcmp(get_streamfile_name_ref(streamFile->stdiosf),filename)) {
         if (((newfd = dup(fileno(streamFile->infile_ref))) >= 0) &&
             (newfile = wa_fdopen(newfd)))
         {
@@ -250,7 +255,7 @@ static STREAMFILE *wasf_open(WINAMP_STREAMFILE *streamFile, const char *const fi
 
 static void wasf_close(WINAMP_STREAMFILE *streamfile) {
     /* closes infile_ref + frees in the internal STDIOSTREAMFILE (fclose for wchar is not needed) */
-    streamfile->stdiosf->close(streamfile->stdiosf);
+    close_streamfile(streamfile->stdiosf);
     free(streamfile); /* and the current struct */
 }
 
@@ -268,6 +273,7 @@ static STREAMFILE *open_winamp_streamfile_by_file(FILE *infile, const char * pat
     this_sf->sf.get_size = (void*)wasf_get_size;
     this_sf->sf.get_offset = (void*)wasf_get_offset;
     this_sf->sf.get_name = (void*)wasf_get_name;
+    this_sf->sf.get_name_ref = (void*)wasf_get_name_ref;
     this_sf->sf.open = (void*)wasf_open;
     this_sf->sf.close = (void*)wasf_close;
 
@@ -976,6 +982,8 @@ void winamp_Init() {
 
 /* called at program quit */
 void winamp_Quit() {
+    vgmstream_tags_db_close(tags_db);
+    tags_db = NULL;
 }
 
 /* called before extension checks, to allow detection of mms://, etc */
@@ -1446,6 +1454,14 @@ typedef struct {
 
 winamp_tags last_tags;
 
+/* tagfile's last write time, so edits get reloaded */
+static int64_t get_tagfile_mtime(const in_char* tagfile_path) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!wa_GetFileAttributesEx(tagfile_path, GetFileExInfoStandard, &data))
+        return 0;
+    return ((int64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+}
+
 
 /* Loads all tags for a filename in a temp struct to improve performance, as
  * Winamp requests one tag at a time and may reask for the same tag several times */
@@ -1491,13 +1507,17 @@ static void load_tagfile_info(in_char* filename) {
     last_tags.tag_count = 0;
 
     /* load all tags from tagfile */
+    if (!tags_db)
+        tags_db = vgmstream_tags_db_init();
     tagFile = open_winamp_streamfile_by_ipath(tagfile_path_i);
-    if (tagFile != NULL) {
+    if (tagFile != NULL && tags_db) {
         VGMSTREAM_TAGS tag;
         int i;
 
+        vgmstream_tags_db_load(tags_db, tagFile, get_tagfile_mtime(tagfile_path_i));
+
         vgmstream_tags_reset(&tag, filename_utf8);
-        while (vgmstream_tags_next_tag(&tag, tagFile)) {
+        while (vgmstream_tags_db_next_tag(tags_db, &tag)) {
             int repeated_tag = 0;
             int current_tag = last_tags.tag_count;
             if (current_tag >= WINAMP_TAGS_ENTRY_MAX)
@@ -1520,9 +1540,9 @@ static void load_tagfile_info(in_char* filename) {
                 last_tags.tag_count++;
         }
 
-        close_streamfile(tagFile);
         last_tags.loaded = 1;
     }
+    close_streamfile(tagFile);
 }
 
 /* Winamp repeatedly calls this for every known tag currently used in the Advanced Title Formatting (ATF)
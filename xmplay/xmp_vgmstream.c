@@ -97,6 +97,10 @@ static void xmpsf_get_name(XMPLAY_STREAMFILE *this, char *buffer, size_t length)
     buffer[length-1] = '\0';
 }
 
+static const char * xmpsf_get_name_ref(XMPLAY_STREAMFILE *this) {
+    return this->name;
+}
+
 static STREAMFILE *xmpsf_open(XMPLAY_STREAMFILE *this, const char *const filename, size_t buffersize) {
     XMPFILE newfile;
 
@@ -127,6 +131,7 @@ static STREAMFILE *open_xmplay_streamfile_by_xmpfile(XMPFILE infile, const char
     streamfile->sf.get_size = (void*)xmpsf_get_size;
     streamfile->sf.get_offset = (void*)xmpsf_get_offset;
     streamfile->sf.get_name = (void*)xmpsf_get_name;
+    streamfile->sf.get_name_ref = (void*)xmpsf_get_name_ref;
     streamfile->sf.open = (void*)xmpsf_open;
     streamfile->sf.close = (void*)xmpsf_close;
     streamfile->infile = infile;